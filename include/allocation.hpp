@@ -0,0 +1,168 @@
+/**
+ * @file allocation.hpp
+ * @brief Accounting of the heap memory GMP allocates for BigInt limbs.
+ *
+ * Every GMP allocation goes through the memory functions installed by the BigInt module. When
+ * accounting is on, each heap block records its size and the allocation scope that was current
+ * when it was allocated, and per-scope counters track the number of allocations, frees and
+ * reallocations, live and peak bytes, and a histogram of block sizes. A block is always charged to
+ * the scope it was allocated in, even if it is freed somewhere else.
+ *
+ * Scopes are set per thread with AllocationScope. The innermost scope wins, and parallelFor() runs
+ * its workers in the caller's scope. The library tags its main subsystems ("msm", "ntt",
+ * "polynomial", "evaluations", "circuit", "prover"); everything else is charged to "(none)".
+ *
+ * Values held in the inline buffer of a BigInt never reach the allocator. They are part of the
+ * object itself (sizeof(BigInt)), wherever that object lives.
+ *
+ * Accounting is off by default. Setting the environment variable ZKSNARKS_ALLOC_STATS before the
+ * program starts turns it on and prints allocationSummary() to stderr at exit.
+ */
+
+#ifndef ALLOCATION_HPP
+#define ALLOCATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Number of block-size classes: up to 32 bytes, up to 64 bytes, …, up to 32 KiB, and larger.
+const size_t ALLOCATION_SIZE_CLASSES = 12;
+
+/// Maximum number of distinct scope names, "(none)" included.
+const size_t MAX_ALLOCATION_SCOPES = 64;
+
+/**
+ * @struct AllocationStats
+ * @brief Counters of one scope, or of all scopes together.
+ */
+struct AllocationStats {
+    std::string scope;       ///< The scope name, or "(total)".
+    uint64_t allocations;    ///< Blocks allocated.
+    uint64_t frees;          ///< Blocks freed.
+    uint64_t reallocations;  ///< Blocks resized in place or moved.
+    uint64_t liveBytes;      ///< Bytes currently allocated.
+    uint64_t peakBytes;      ///< Highest value of liveBytes since the last resetAllocationPeaks().
+    uint64_t totalBytes;     ///< Bytes allocated, counting the growth of reallocated blocks.
+    uint64_t sizeClasses[ALLOCATION_SIZE_CLASSES]; ///< Allocations per size class.
+};
+
+/**
+ * @brief Turns accounting on or off.
+ *
+ * Blocks allocated while accounting is off are never counted, not even when they are freed.
+ *
+ * @param enabled Whether new allocations are accounted.
+ */
+void setAllocationAccounting(bool enabled);
+
+/**
+ * @brief Checks whether accounting is on.
+ * @return True if new allocations are accounted.
+ */
+bool allocationAccountingEnabled();
+
+/**
+ * @brief Sets a limit on the accounted live bytes.
+ *
+ * GMP cannot recover from a failed allocation, so exceeding the limit prints the offending scope
+ * and aborts the process, like running out of memory.
+ *
+ * @param bytes The limit; 0 removes it.
+ */
+void setAllocationLimit(uint64_t bytes);
+
+/**
+ * @brief Gets the counters of all scopes together.
+ * @return The totals.
+ */
+AllocationStats allocationTotals();
+
+/**
+ * @brief Gets the counters of every scope that has been used.
+ * @return One entry per scope, in registration order, "(none)" first.
+ */
+std::vector<AllocationStats> allocationStatsByScope();
+
+/**
+ * @brief Resets every peak to the current live byte count.
+ */
+void resetAllocationPeaks();
+
+/**
+ * @brief Formats the counters as a table, one row per scope with activity.
+ * @return The summary text.
+ */
+std::string allocationSummary();
+
+/**
+ * @brief Gets the identifier of a scope, registering the name on first use.
+ * @param name The scope name.
+ * @return The scope identifier.
+ * @throw std::runtime_error If MAX_ALLOCATION_SCOPES names are already registered.
+ */
+unsigned allocationScopeId(const std::string& name);
+
+/**
+ * @brief Gets the scope of the calling thread.
+ * @return The scope identifier; 0 is "(none)".
+ */
+unsigned currentAllocationScope();
+
+/**
+ * @class AllocationScope
+ * @brief Charges the GMP allocations of the calling thread to a scope until destroyed.
+ */
+class AllocationScope {
+public:
+    /**
+     * @brief Enters a scope by name.
+     * @param name The scope name.
+     * @throw std::runtime_error If the name is new and the scope table is full.
+     */
+    explicit AllocationScope(const std::string& name);
+
+    /**
+     * @brief Enters a scope by identifier, as returned by allocationScopeId().
+     * @param id The scope identifier.
+     */
+    explicit AllocationScope(unsigned id);
+
+    /**
+     * @brief Restores the scope that was current before.
+     */
+    ~AllocationScope();
+
+private:
+    AllocationScope(const AllocationScope&);
+    AllocationScope& operator=(const AllocationScope&);
+
+    unsigned previous;
+};
+
+/**
+ * @brief Accounts a new heap block. Called by the BigInt memory functions.
+ * @param size The block size in bytes.
+ * @return The header word to store with the block; 0 if accounting is off.
+ */
+uint64_t accountAllocation(size_t size);
+
+/**
+ * @brief Accounts a resized heap block. Called by the BigInt memory functions.
+ *
+ * A block allocated while accounting was off is accounted as a new block if accounting is on now.
+ *
+ * @param header The header word stored with the block.
+ * @param newSize The new block size in bytes.
+ * @return The header word to store with the resized block.
+ */
+uint64_t accountReallocation(uint64_t header, size_t newSize);
+
+/**
+ * @brief Accounts a freed heap block. Called by the BigInt memory functions.
+ * @param header The header word stored with the block.
+ */
+void accountFree(uint64_t header);
+
+#endif // ALLOCATION_HPP
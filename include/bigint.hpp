@@ -5,9 +5,30 @@
 #include <string>
 #include <vector>
 
+/**
+ * Number of GMP limbs (64 bits each on the supported targets) a BigInt stores inline before moving its value to the heap. The default of
+ * 8 limbs (512 bits) holds any residue modulo a 256-bit prime together with unreduced products of
+ * two of them. Override it with -DBIGINT_INLINE_LIMBS=n (CMake: ZKSNARKS_BIGINT_INLINE_LIMBS).
+ */
+#ifndef BIGINT_INLINE_LIMBS
+#define BIGINT_INLINE_LIMBS 8
+#endif
+
 /**
  * @class BigInt
  * @brief A class for arbitrary-precision integers using the GMP library.
+ *
+ * Small values live in a limb buffer inside the object, so constructing, copying and destroying them
+ * does not touch the allocator. The mpz_t points at that buffer; when GMP grows the value beyond it,
+ * the allocator installed by this module moves it to the heap, and the next BigInt operation moves
+ * it back once it fits again. For this to work the library owns the GMP memory functions: callers
+ * must not replace them with mp_set_memory_functions(), and must release strings returned by
+ * mpz_get_str() with the function from mp_get_memory_functions() rather than free().
+ *
+ * The functions are installed by a high-priority static constructor. Blocks GMP allocated before
+ * that, such as mpz_t values set up by an earlier static initializer, carry no tag word; freeing
+ * or growing them is passed to the memory functions that were installed before, so they may
+ * still be used and cleared afterwards.
  */
 class BigInt {
 public:
@@ -220,11 +241,37 @@ public:
      */
     BigInt modInverse(const BigInt& modulus) const;
 
+    /**
+     * @brief Modular exponentiation with GMP's sliding-window Montgomery ladder.
+     * @param exponent The exponent; a negative exponent raises the modular inverse.
+     * @param modulus The modulus.
+     * @return this^exponent mod modulus, in [0, modulus).
+     * @throw std::invalid_argument If the modulus is zero.
+     * @throw std::runtime_error If the exponent is negative and the base is not invertible.
+     */
+    BigInt powm(const BigInt& exponent, const BigInt& modulus) const;
+
     /**
      * @brief Print the absolute value of the BigInt.
      */
     void printAbsolute() const;
 
+    /**
+     * @brief Exchange values with another BigInt without copying heap limbs.
+     *
+     * Use this instead of mpz_swap() on get_mpz_t(), which would leave each object pointing at the
+     * other's inline buffer.
+     *
+     * @param other The BigInt to swap with.
+     */
+    void swap(BigInt& other);
+
+    /**
+     * @brief Check whether the value currently lives in the inline buffer.
+     * @return True if no heap memory is held.
+     */
+    bool isInline() const { return value->_mp_d == inlineLimbs + 1; }
+
     /**
      * @brief Check if the BigInt is a prime number.
      * @param provable Flag to indicate provable primality testing.
@@ -281,8 +328,32 @@ public:
      */
     BigInt rightShift(unsigned long int shiftBy) const;
 
+    /**
+     * @brief Read-only access to the underlying GMP integer.
+     * @return Pointer to the GMP mpz_t holding the value.
+     */
+    mpz_srcptr get_mpz_t() const;
+
+    /**
+     * @brief Mutable access to the underlying GMP integer.
+     *
+     * Intended for low-level kernels (such as field reduction) that work on limbs directly.
+     *
+     * @return Pointer to the GMP mpz_t holding the value.
+     */
+    mpz_ptr get_mpz_t();
+
 private:
+    void initInline();
+    void settle() {
+        if (!isInline()) {
+            demote();
+        }
+    }
+    void demote();
+
     mpz_t value; // The GMP mpz_t representing the BigInt.
+    mp_limb_t inlineLimbs[BIGINT_INLINE_LIMBS + 1]; // Allocation tag followed by the inline limbs.
 };
 
 #endif // BIGINT_HPP
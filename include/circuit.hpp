@@ -0,0 +1,226 @@
+/**
+ * @file circuit.hpp
+ * @brief Arithmetic circuit description and compiled witness generation.
+ *
+ * A CircuitBuilder records add, mul, constant, input and hint gates over F_p. Compiling it
+ * produces a CompiledCircuit: a flat instruction stream over a register file of field elements.
+ * Witness values (inputs, products and hint outputs, plus any exported wire) live in fixed slots
+ * of the register file, while linear temporaries share a small pool of scratch registers assigned
+ * by linear-scan allocation. Independent sub-circuits are compiled into separate segments that
+ * can be evaluated in parallel.
+ */
+
+#ifndef CIRCUIT_HPP
+#define CIRCUIT_HPP
+
+#include "bigint.hpp"
+#include "field.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Identifier of a wire in a CircuitBuilder.
+ */
+typedef size_t Wire;
+
+/**
+ * @brief Out-of-circuit computation used to produce advice values, such as an inverse or a bit.
+ *
+ * Receives the values of the hint's argument wires and the field modulus, and returns the value of
+ * the hint's output wire. The result is reduced modulo p by the engine.
+ */
+typedef std::function<BigInt(const std::vector<BigInt>& args, const BigInt& modulus)> HintFunction;
+
+/**
+ * @enum OpCode
+ * @brief Operations of the compiled instruction stream.
+ */
+enum class OpCode : uint8_t {
+    Input, ///< dst = inputs[lhs] mod p
+    Const, ///< dst = constants[lhs]
+    Add,   ///< dst = lhs + rhs mod p
+    Mul,   ///< dst = lhs * rhs mod p
+    Hint   ///< dst = hint call lhs evaluated on its argument registers
+};
+
+/**
+ * @struct Instruction
+ * @brief One register-allocated instruction. Operands are register indices unless noted in OpCode.
+ */
+struct Instruction {
+    OpCode op;    ///< The operation.
+    uint32_t dst; ///< Destination register.
+    uint32_t lhs; ///< First operand register, or an index into the input, constant or hint-call table.
+    uint32_t rhs; ///< Second operand register for Add and Mul.
+};
+
+class CircuitBuilder;
+
+/**
+ * @class CompiledCircuit
+ * @brief A circuit lowered to register-allocated instruction segments.
+ */
+class CompiledCircuit {
+public:
+    /**
+     * @brief Computes the witness for the given inputs.
+     * @param inputs Values of the input wires, in the order they were created.
+     * @param threads Number of threads for evaluating independent segments; 0 selects the default.
+     * @return The witness vector, indexed by CircuitBuilder::witnessIndex().
+     * @throw std::invalid_argument If the number of inputs is wrong.
+     */
+    std::vector<BigInt> evaluate(const std::vector<BigInt>& inputs, unsigned threads = 0) const;
+
+    /**
+     * @brief Gets the field modulus.
+     * @return p.
+     */
+    const BigInt& getModulus() const { return modulus; }
+
+    /**
+     * @brief Gets the number of witness values produced by evaluate().
+     * @return The witness length.
+     */
+    size_t witnessSize() const { return witnessCount; }
+
+    /**
+     * @brief Gets the total number of registers, witness slots included.
+     * @return The register file size.
+     */
+    size_t registerCount() const { return registers; }
+
+    /**
+     * @brief Gets the compiled instruction stream.
+     * @return All instructions, segment after segment.
+     */
+    const std::vector<Instruction>& instructions() const { return code; }
+
+    /**
+     * @brief Gets the number of independent segments.
+     * @return The segment count.
+     */
+    size_t segmentCount() const { return segments.size(); }
+
+private:
+    friend class CircuitBuilder;
+
+    struct Segment {
+        size_t begin; ///< First instruction.
+        size_t end;   ///< One past the last instruction.
+    };
+
+    struct HintCall {
+        size_t function;   ///< Index into hints.
+        size_t argsOffset; ///< First argument register in hintArgs.
+        size_t argCount;   ///< Number of arguments.
+    };
+
+    void runSegment(const Segment& segment, const std::vector<BigInt>& inputs, std::vector<BigInt>& regs) const;
+
+    BigInt modulus;
+    std::shared_ptr<const FieldBackend> field;
+    std::vector<Instruction> code;
+    std::vector<Segment> segments;
+    std::vector<BigInt> constants;
+    std::vector<HintFunction> hints;
+    std::vector<HintCall> hintCalls;
+    std::vector<uint32_t> hintArgs;
+    size_t inputCount;
+    size_t witnessCount;
+    size_t registers;
+};
+
+/**
+ * @class CircuitBuilder
+ * @brief Records an arithmetic circuit gate by gate.
+ *
+ * Wires must be created before they are used, so creation order is a valid evaluation order.
+ */
+class CircuitBuilder {
+public:
+    /**
+     * @brief Creates an empty circuit over F_p.
+     * @param modulus The prime p.
+     */
+    explicit CircuitBuilder(const BigInt& modulus);
+
+    /**
+     * @brief Adds an input wire. Inputs are always part of the witness.
+     * @return The new wire.
+     */
+    Wire input();
+
+    /**
+     * @brief Adds a constant wire.
+     * @param value The constant value.
+     * @return The new wire.
+     */
+    Wire constant(const BigInt& value);
+
+    /**
+     * @brief Adds a wire carrying a + b.
+     * @param a First operand.
+     * @param b Second operand.
+     * @return The new wire.
+     */
+    Wire add(Wire a, Wire b);
+
+    /**
+     * @brief Adds a wire carrying a * b. Products are always part of the witness.
+     * @param a First operand.
+     * @param b Second operand.
+     * @return The new wire.
+     */
+    Wire mul(Wire a, Wire b);
+
+    /**
+     * @brief Adds a wire whose value is computed out of circuit. Hint outputs are part of the witness.
+     * @param args The argument wires passed to the hint.
+     * @param function The hint computation.
+     * @return The new wire.
+     */
+    Wire hint(const std::vector<Wire>& args, const HintFunction& function);
+
+    /**
+     * @brief Forces a wire (for example a circuit output) into the witness.
+     * @param wire The wire to export.
+     */
+    void exportWire(Wire wire);
+
+    /**
+     * @brief Gets the position of a wire in the witness vector.
+     * @param wire The wire.
+     * @return Its witness index.
+     * @throw std::invalid_argument If the wire is not part of the witness.
+     */
+    size_t witnessIndex(Wire wire) const;
+
+    /**
+     * @brief Compiles the circuit into register-allocated segments.
+     * @return The compiled circuit.
+     */
+    CompiledCircuit compile() const;
+
+private:
+    struct Node {
+        OpCode op;
+        Wire lhs;
+        Wire rhs;
+        size_t aux;     ///< Input, constant or hint index.
+        bool witness;
+    };
+
+    Wire push(const Node& node);
+    void checkWire(Wire wire) const;
+
+    BigInt modulus;
+    std::vector<Node> nodes;
+    std::vector<BigInt> constants;
+    std::vector<HintFunction> hints;
+    std::vector<std::vector<Wire>> hintInputs;
+    size_t inputCount;
+};
+
+#endif // CIRCUIT_HPP
@@ -0,0 +1,172 @@
+/**
+ * @file cluster.hpp
+ * @brief Multi-scalar multiplication sharded across worker processes.
+ *
+ * The terms of an MSM are written once to a shared input file. A coordinator splits the Pippenger
+ * computation into shards, either by point range (every worker handles all windows of a slice of the
+ * terms) or by window range (every worker handles a slice of the windows of all terms), and sends
+ * one shard description to each worker over a stream connection. A worker reads its slice of the
+ * file, fills and reduces its buckets, and answers with one partial sum per window. The coordinator
+ * adds the partial sums of each window and runs the final doubling chain.
+ *
+ * The wire protocol is a sequence of frames: a 32-bit type, a 64-bit payload length (both
+ * little-endian) and the payload. Points travel as a flag byte (1 for infinity) followed by the
+ * big-endian X and Y coordinates. Since it only needs a byte stream and a file path the worker can
+ * open, the same workers run over socketpairs, Unix sockets or TCP connections to other machines
+ * that mount the input file.
+ */
+
+#ifndef CLUSTER_HPP
+#define CLUSTER_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * @enum ShardStrategy
+ * @brief How the coordinator divides an MSM among its workers.
+ */
+enum class ShardStrategy {
+    PointRange,  ///< Each worker handles every window of a contiguous range of terms.
+    WindowRange  ///< Each worker handles a contiguous range of windows over all terms.
+};
+
+/**
+ * @struct MsmShard
+ * @brief One unit of work sent to a worker.
+ */
+struct MsmShard {
+    std::string path;      ///< Path of the shared input file.
+    uint64_t pointBegin;   ///< First term of the shard.
+    uint64_t pointEnd;     ///< One past the last term of the shard.
+    uint32_t windowBits;   ///< Pippenger window width.
+    uint32_t windowBegin;  ///< First window of the shard.
+    uint32_t windowEnd;    ///< One past the last window of the shard.
+};
+
+/**
+ * @brief Writes the terms of an MSM to a shared input file.
+ *
+ * The file stores the curve parameters followed by fixed-size records of (point, scalar), so
+ * workers can read any range of terms with a single positioned read. Point coordinates are stored
+ * reduced modulo the field prime p and scalars modulo the curve order n, so negative or wide
+ * representatives are accepted.
+ *
+ * @param path The file to create or overwrite.
+ * @param points The base points, all on the same curve.
+ * @param scalars The scalars, one per point.
+ * @throw std::invalid_argument If the inputs differ in length, are empty, or contain only points at infinity.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writeMsmInput(const std::string& path, const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars);
+
+/**
+ * @brief Computes the per-window partial sums of one shard.
+ *
+ * This is what a worker runs for each request; it is exposed so shards can also be computed
+ * in-process.
+ *
+ * @param shard The shard to compute.
+ * @param threads Number of threads for the windows of the shard; 0 selects the default.
+ * @return One affine point per window in [windowBegin, windowEnd).
+ * @throw std::invalid_argument If the shard ranges are invalid for the input file.
+ * @throw std::runtime_error If the input file cannot be read.
+ */
+std::vector<Ecc_Point> computeMsmShard(const MsmShard& shard, unsigned threads = 0);
+
+/**
+ * @brief Runs the worker side of the protocol until the connection is closed.
+ *
+ * Failures while computing a shard are reported to the coordinator as error frames and the worker
+ * keeps serving; malformed frames end the session.
+ *
+ * @param inFd Descriptor the requests are read from.
+ * @param outFd Descriptor the results are written to; may equal inFd for sockets.
+ */
+void serveMsmWorker(int inFd, int outFd);
+
+/**
+ * @brief Forks a worker process connected to the caller through a socketpair.
+ * @param fd Receives the coordinator's end of the connection.
+ * @return The process id of the worker.
+ * @throw std::runtime_error If the socketpair or the fork fails.
+ */
+pid_t spawnLocalMsmWorker(int& fd);
+
+/**
+ * @brief Closes the connection to a worker started by spawnLocalMsmWorker and reaps it.
+ * @param pid The worker's process id.
+ * @param fd The coordinator's end of the connection.
+ */
+void stopLocalMsmWorker(pid_t pid, int fd);
+
+/**
+ * @brief Listens on a Unix socket and serves coordinators one connection at a time.
+ * @param socketPath The socket path; an existing socket file is replaced.
+ * @param maxConnections Number of connections to serve before returning; 0 serves forever.
+ * @throw std::runtime_error If the socket cannot be bound.
+ */
+void listenMsmWorker(const std::string& socketPath, size_t maxConnections = 0);
+
+/**
+ * @brief Connects to a worker listening on a Unix socket.
+ * @param socketPath The socket path.
+ * @return The connected descriptor, owned by the caller.
+ * @throw std::runtime_error If the connection fails.
+ */
+int connectMsmWorker(const std::string& socketPath);
+
+/**
+ * @class MsmCoordinator
+ * @brief Splits an MSM stored in an input file across connected workers and combines the results.
+ */
+class MsmCoordinator {
+public:
+    /**
+     * @brief Opens an input file written by writeMsmInput().
+     * @param inputPath The path workers will open; use a path that is valid on every worker.
+     * @throw std::runtime_error If the file is missing or malformed.
+     */
+    explicit MsmCoordinator(const std::string& inputPath);
+
+    /**
+     * @brief Adds a worker connection. The descriptor stays owned by the caller.
+     * @param fd A connected stream descriptor.
+     */
+    void addWorker(int fd);
+
+    /**
+     * @brief Gets the number of terms in the input file.
+     * @return The term count.
+     */
+    size_t termCount() const { return count; }
+
+    /**
+     * @brief Gets the curve stored in the input file.
+     * @return The curve parameters.
+     */
+    const CurveParameters& getCurve() const { return curve; }
+
+    /**
+     * @brief Computes the MSM of the input file on the connected workers.
+     *
+     * All shards are sent before any result is read, so the workers run concurrently.
+     *
+     * @param strategy How to divide the work.
+     * @return Σ scalars[i]·points[i].
+     * @throw std::runtime_error If there are no workers, a worker disconnects or reports an error.
+     */
+    Ecc_Point run(ShardStrategy strategy = ShardStrategy::PointRange) const;
+
+private:
+    std::string path;
+    CurveParameters curve;
+    size_t count;
+    std::vector<int> workers;
+};
+
+#endif // CLUSTER_HPP
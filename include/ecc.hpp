@@ -2,7 +2,9 @@
 #define ECC_HPP
 
 #include "bigint.hpp"
+#include "field.hpp"
 #include <iostream>
+#include <memory>
 
 #define USE_CURVE_P256
 // #define USE_CURVE_SECP256K1
@@ -24,6 +26,24 @@ struct CurveParameters {
     BigInt Gx; ///< x-coordinate of the generator point.
     BigInt Gy; ///< y-coordinate of the generator point.
     BigInt n;  ///< Order of the group generated by the generator point.
+
+    /**
+     * @brief Parameters of the NIST P-256 curve.
+     * @return Reference to the lazily parsed parameter set.
+     */
+    static const CurveParameters& p256();
+
+    /**
+     * @brief Parameters of the secp256k1 curve.
+     * @return Reference to the lazily parsed parameter set.
+     */
+    static const CurveParameters& secp256k1();
+
+    /**
+     * @brief Parameters of the NIST P-521 curve.
+     * @return Reference to the lazily parsed parameter set.
+     */
+    static const CurveParameters& p521();
 };
 
 /**
@@ -53,12 +73,25 @@ public:
         setCurveParameters();
     }
 
+    /**
+     * @brief Constructor to initialize an Ecc_Point on a user-supplied curve.
+     *
+     * The field backend is chosen from the curve prime: P-256 and secp256k1 primes get their
+     * special-form reduction, any other prime uses generic GMP reduction.
+     *
+     * @param x The x-coordinate of the Ecc_Point.
+     * @param y The y-coordinate of the Ecc_Point.
+     * @param params The parameters of the curve the point lies on.
+     */
+    Ecc_Point(const BigInt& x, const BigInt& y, const CurveParameters& params)
+    : curveParams(params), field(FieldBackend::forModulus(params.p)), xCoord(x), yCoord(y), isInfinity(false) {}
+
     /**
      * @brief Copy constructor.
      * @param other The Ecc_Point to copy.
      */
     Ecc_Point(const Ecc_Point& other) 
-    : xCoord(other.xCoord), yCoord(other.yCoord), isInfinity(other.isInfinity), curveParams(other.curveParams) {}
+    : curveParams(other.curveParams), field(other.field), xCoord(other.xCoord), yCoord(other.yCoord), isInfinity(other.isInfinity) {}
 
     /**
      * @brief Assignment operator.
@@ -71,6 +104,7 @@ public:
             yCoord = other.yCoord;
             isInfinity = other.isInfinity;
             curveParams = other.curveParams;
+            field = other.field;
         }
         return *this;
     }
@@ -91,6 +125,18 @@ public:
         return curveParams.p;
     }
 
+    /**
+     * @brief Get the parameters of the curve this point lies on.
+     * @return The curve parameters.
+     */
+    const CurveParameters& getCurveParameters() const { return curveParams; }
+
+    /**
+     * @brief Get the field backend used for coordinate arithmetic.
+     * @return The backend, or nullptr for a default-constructed point at infinity.
+     */
+    const FieldBackend* getField() const { return field.get(); }
+
     /**
      * @brief Set the x-coordinate of the Ecc_Point.
      * @param x The new x-coordinate.
@@ -162,7 +208,9 @@ public:
      * equivalent to adding P to itself k times.
      *
      * The scalar multiplication is performed using the "double-and-add" method, which
-     * is efficient and reduces the number of elliptic curve operations needed.
+     * is efficient and reduces the number of elliptic curve operations needed. On secp256k1
+     * the scalar is split with the GLV endomorphism instead and both halves are processed
+     * simultaneously, roughly halving the number of doublings.
      *
      * @param scalar The BigInt scalar to multiply this point by.
      * @return Ecc_Point resulting from the scalar multiplication of this point by the scalar.
@@ -185,9 +233,18 @@ public:
      */
     bool operator==(const Ecc_Point& other) const;
 
+    /**
+     * @brief Builds a point on the same curve as this one.
+     * @param x The x-coordinate of the new point.
+     * @param y The y-coordinate of the new point.
+     * @return Ecc_Point sharing this point's curve parameters and field backend.
+     */
+    Ecc_Point withCoordinates(const BigInt& x, const BigInt& y) const;
+
 
 private:
     CurveParameters curveParams;
+    std::shared_ptr<const FieldBackend> field; ///< Reduction backend selected from curveParams.p.
     BigInt xCoord; ///< The x-coordinate of the Ecc_Point.
     BigInt yCoord; ///< The y-coordinate of the Ecc_Point.
 
@@ -201,36 +258,14 @@ private:
      * during the construction of an Ecc_Point object to ensure it is configured with the
      * correct parameters for the chosen elliptic curve.
      *
+     * The matching field backend is selected at the same time, so points on P-256 and secp256k1
+     * reduce coordinates with special-form arithmetic instead of division.
+     *
      * @note The curve parameters must be predefined and correctly set for the specified
      *       elliptic curve. If no curve is defined, a compile-time error is generated.
      */
 
-    void setCurveParameters() {
-        #ifdef USE_CURVE_P256
-            curveParams.a = BigInt("ffffffff00000001000000000000000000000000fffffffffffffffffffffffc",16);
-            curveParams.b = BigInt("5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b",16);
-            curveParams.p = BigInt("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff",16);
-            curveParams.Gx = BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16);
-            curveParams.Gy = BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16);
-            curveParams.n = BigInt("ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551",16);
-        #elif defined USE_CURVE_SECP256K1
-            curveParams.a = BigInt("0",16);
-            curveParams.b = BigInt("7",16);
-            curveParams.p = BigInt("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f",16);
-            curveParams.Gx = BigInt("79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",16);
-            curveParams.Gy = BigInt("483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",16);
-            curveParams.n = BigInt("fffffffffffffffffffffffe26f2fc170f69466a74defd8d",16);
-        #elif defined USE_CURVE_P521
-            curveParams.a = BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffc",16);
-            curveParams.b = BigInt("0051953eb9618e1c9a1f929a21a0b68540eea2da725b99b315f3b8b489918ef109e156193951ec7e937b1652c0bd3bb1bf073573df883d2c34f1ef451fd46b503f00",16);
-            curveParams.p = BigInt("01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",16);
-            curveParams.Gx = BigInt("00c6858e06b70404e9cd9e3ecb662395b4429c648139053fb521f828af606b4d3dbaa14b5e77efe75928fe1dc127a2ffa8de3348b3c1856a429bf97e7e31c2e5bd66",16);
-            curveParams.Gy = BigInt("011839296a789a3bc0045c8a5fb42c7d1bd998f54449579b446817afbd17273e662c97ee72995ef42640c550b9013fad0761353c7086a272c24088be94769fd16650",16);
-            curveParams.n = BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffa51868783bf2f966b7fcc0148f709a5d03bb5c9b8899c47aebb6fb71e91386409",16);
-        #else
-            #error "No elliptic curve defined"
-        #endif
-    }
+    void setCurveParameters();
 
 
     /**
@@ -0,0 +1,158 @@
+/**
+ * @file evaluations.hpp
+ * @brief Polynomials in evaluation form over an EvaluationDomain.
+ *
+ * Prover arithmetic is mostly pointwise: products and linear combinations of polynomials that are
+ * already known at every point of a domain. Evaluations stores the n values f(ω^i) and implements
+ * these operations in O(n) instead of going through coefficient-form multiplication.
+ *
+ * Operations are lazy. An expression such as a * b + c.scale(k) builds a small expression tree; the
+ * tree is compiled to a straight-line program and run once per domain point when the values are
+ * first needed, so the whole chain makes a single pass over memory without intermediate vectors.
+ * Materialized values and the coefficient form obtained with an inverse NTT are cached and shared
+ * between copies.
+ */
+
+#ifndef EVALUATIONS_HPP
+#define EVALUATIONS_HPP
+
+#include "bigint.hpp"
+#include "ntt.hpp"
+#include "polynomial.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @class Evaluations
+ * @brief The values of a polynomial of degree below n at the points of a size-n domain.
+ */
+class Evaluations {
+public:
+    /**
+     * @brief Wraps values at ω⁰, …, ω^(n−1).
+     * @param domain The evaluation domain.
+     * @param values One value per domain point; values outside [0, p) are reduced.
+     * @throw std::invalid_argument If the number of values differs from the domain size.
+     */
+    Evaluations(const std::shared_ptr<const EvaluationDomain>& domain, const std::vector<BigInt>& values);
+
+    /**
+     * @brief Evaluates a polynomial over the domain with a forward NTT.
+     *
+     * The polynomial is kept as the cached coefficient form.
+     *
+     * @param domain The evaluation domain.
+     * @param poly A polynomial of degree below the domain size.
+     * @return Its evaluations.
+     * @throw std::invalid_argument If the degree is too large or the moduli differ.
+     */
+    static Evaluations fromPolynomial(const std::shared_ptr<const EvaluationDomain>& domain, const Polynomial& poly);
+
+    /**
+     * @brief The constant function c over the domain, without storing n copies of it.
+     * @param domain The evaluation domain.
+     * @param c The constant.
+     * @return The evaluations of the constant polynomial c.
+     */
+    static Evaluations constant(const std::shared_ptr<const EvaluationDomain>& domain, const BigInt& c);
+
+    /**
+     * @brief Computes Σ weights[j]·terms[j] pointwise in one pass.
+     * @param terms The evaluations to combine; all over the same domain.
+     * @param weights One weight per term.
+     * @return The linear combination.
+     * @throw std::invalid_argument If the inputs are empty, differ in length or use different domains.
+     */
+    static Evaluations linearCombination(const std::vector<Evaluations>& terms, const std::vector<BigInt>& weights);
+
+    /**
+     * @brief Gets the evaluation domain.
+     * @return The domain.
+     */
+    const std::shared_ptr<const EvaluationDomain>& getDomain() const { return domain; }
+
+    /**
+     * @brief Gets the number of domain points.
+     * @return n.
+     */
+    size_t size() const { return domain->size(); }
+
+    /**
+     * @brief Gets the values, running any pending operations first.
+     * @return f(ω^i) for i < n.
+     */
+    const std::vector<BigInt>& values() const;
+
+    /**
+     * @brief Gets one value, running any pending operations first.
+     * @param i The index of the domain point.
+     * @return f(ω^i).
+     */
+    const BigInt& operator[](size_t i) const { return values()[i]; }
+
+    /**
+     * @brief Checks whether the values have been computed.
+     * @return False while operations are still pending.
+     */
+    bool isMaterialized() const;
+
+    /**
+     * @brief Converts to coefficient form with an inverse NTT; the result is cached.
+     * @return The unique polynomial of degree below n with these evaluations.
+     */
+    const Polynomial& toPolynomial() const;
+
+    /**
+     * @brief Pointwise sum.
+     * @param other Evaluations over the same domain.
+     * @return f + g.
+     * @throw std::invalid_argument If the domains differ.
+     */
+    Evaluations operator+(const Evaluations& other) const;
+
+    /**
+     * @brief Pointwise difference.
+     * @param other Evaluations over the same domain.
+     * @return f − g.
+     * @throw std::invalid_argument If the domains differ.
+     */
+    Evaluations operator-(const Evaluations& other) const;
+
+    /**
+     * @brief Pointwise product.
+     *
+     * The result holds the evaluations of f·g only; if deg f + deg g ≥ n it is the product reduced
+     * modulo x^n − 1.
+     *
+     * @param other Evaluations over the same domain.
+     * @return f · g.
+     * @throw std::invalid_argument If the domains differ.
+     */
+    Evaluations operator*(const Evaluations& other) const;
+
+    /**
+     * @brief Multiplies every value by a scalar.
+     * @param c The scalar.
+     * @return c · f.
+     */
+    Evaluations scale(const BigInt& c) const;
+
+    struct Node;
+
+private:
+    Evaluations(const std::shared_ptr<const EvaluationDomain>& domain, const std::shared_ptr<const Node>& expression);
+    std::shared_ptr<const Node> operand() const;
+    Evaluations combine(int kind, const Evaluations& other) const;
+
+    /// Fused chains larger than this are materialized before growing further.
+    static const size_t MAX_FUSED_NODES = 64;
+    /// Domain points per task when running a fused program.
+    static const size_t FUSED_CHUNK = 1024;
+
+    std::shared_ptr<const EvaluationDomain> domain;
+    std::shared_ptr<const Node> expression;
+    mutable std::shared_ptr<const std::vector<BigInt>> materialized;
+    mutable std::shared_ptr<const Polynomial> coefficients;
+};
+
+#endif // EVALUATIONS_HPP
@@ -0,0 +1,82 @@
+/**
+ * @file exponentiation.hpp
+ * @brief Exponentiation in the multiplicative group modulo m.
+ *
+ * BigInt::powm() covers a single exponentiation. This module adds the two shapes that dominate
+ * discrete-log based protocols:
+ *
+ * - FixedBaseExp precomputes g^(d·2^(w·j)) for every window j and digit d, after which g^e costs
+ *   one multiplication per nonzero window of e and no squarings;
+ * - multiExp() computes Π gᵢ^eᵢ with Straus/Shamir interleaving: the exponents are cut into
+ *   sliding windows with odd digits and all terms share a single chain of squarings.
+ */
+
+#ifndef EXPONENTIATION_HPP
+#define EXPONENTIATION_HPP
+
+#include "bigint.hpp"
+#include "field.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @class FixedBaseExp
+ * @brief Precomputed powers of one base for repeated exponentiation.
+ */
+class FixedBaseExp {
+public:
+    /**
+     * @brief Builds the window tables.
+     * @param base The fixed base g.
+     * @param modulus The modulus m.
+     * @param maxExponentBits Exponents up to this many bits use the tables; longer ones fall back to powm().
+     * @param windowBits Window width; the tables hold ceil(maxExponentBits / w) · (2^w − 1) entries.
+     * @throw std::invalid_argument If the modulus is zero or the window width is not in [1, 16].
+     */
+    FixedBaseExp(const BigInt& base, const BigInt& modulus, size_t maxExponentBits, unsigned windowBits = 6);
+
+    /**
+     * @brief Computes g^e mod m.
+     * @param exponent The exponent; a negative exponent returns the inverse of g^|e|.
+     * @return g^e mod m.
+     * @throw std::runtime_error If the exponent is negative and g is not invertible.
+     */
+    BigInt pow(const BigInt& exponent) const;
+
+    /**
+     * @brief Gets the base.
+     * @return g mod m.
+     */
+    const BigInt& getBase() const { return base; }
+
+    /**
+     * @brief Gets the modulus.
+     * @return m.
+     */
+    const BigInt& getModulus() const { return field->modulus(); }
+
+private:
+    BigInt base;
+    std::shared_ptr<const FieldBackend> field;
+    unsigned windowBits;
+    size_t windows;
+    std::vector<BigInt> table; ///< Row j holds g^(d·2^(w·j)) for d = 1 … 2^w − 1.
+};
+
+/**
+ * @brief Computes the product Π bases[i]^exponents[i] mod m with interleaved sliding windows.
+ *
+ * The window width follows the longest exponent. Negative exponents raise the inverse of their
+ * base. Fewer than four terms are computed as separate powm() calls, which measure faster at that
+ * size than a shared squaring chain on top of the field backend.
+ *
+ * @param bases The bases.
+ * @param exponents The exponents, one per base.
+ * @param modulus The modulus m.
+ * @return The product, or 1 mod m for an empty input.
+ * @throw std::invalid_argument If the inputs differ in length or the modulus is zero.
+ * @throw std::runtime_error If a negative exponent belongs to a non-invertible base.
+ */
+BigInt multiExp(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents, const BigInt& modulus);
+
+#endif // EXPONENTIATION_HPP
@@ -0,0 +1,154 @@
+/**
+ * @file field.hpp
+ * @brief Prime-field arithmetic backends used by the elliptic curve code.
+ *
+ * A FieldBackend performs reduction modulo a fixed prime p. The generic backend falls back to
+ * GMP division, while the curve-specific backends exploit the special form of the NIST P-256
+ * and secp256k1 primes to reduce with shifts, additions and subtractions only.
+ */
+
+#ifndef FIELD_HPP
+#define FIELD_HPP
+
+#include "bigint.hpp"
+#include <memory>
+
+/**
+ * @class FieldBackend
+ * @brief Arithmetic modulo a fixed prime, with a generic division-based reduction.
+ *
+ * Derived classes override reduce() with a faster algorithm for a specific modulus. All other
+ * operations are expressed in terms of reduce(), so a backend only has to provide that one kernel.
+ */
+class FieldBackend {
+public:
+    /**
+     * @brief Constructs a generic backend for the given modulus.
+     * @param modulus The prime defining the field.
+     */
+    explicit FieldBackend(const BigInt& modulus);
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~FieldBackend();
+
+    /**
+     * @brief Gets the modulus of the field.
+     * @return The prime p.
+     */
+    const BigInt& modulus() const;
+
+    /**
+     * @brief Human readable name of the backend, useful for diagnostics.
+     * @return Name of the reduction strategy.
+     */
+    virtual const char* name() const;
+
+    /**
+     * @brief Reduces x in place into the range [0, p).
+     *
+     * Negative inputs are accepted and mapped to their non-negative representative.
+     *
+     * @param x The value to reduce.
+     */
+    virtual void reduce(BigInt& x) const;
+
+    /**
+     * @brief Computes (a + b) mod p.
+     * @param a First operand.
+     * @param b Second operand.
+     * @return The reduced sum.
+     */
+    BigInt add(const BigInt& a, const BigInt& b) const;
+
+    /**
+     * @brief Computes (a - b) mod p.
+     * @param a First operand.
+     * @param b Second operand.
+     * @return The reduced difference.
+     */
+    BigInt sub(const BigInt& a, const BigInt& b) const;
+
+    /**
+     * @brief Computes (a * b) mod p.
+     * @param a First operand.
+     * @param b Second operand.
+     * @return The reduced product.
+     */
+    BigInt mul(const BigInt& a, const BigInt& b) const;
+
+    /**
+     * @brief Computes a² mod p.
+     * @param a The operand.
+     * @return The reduced square.
+     */
+    BigInt sqr(const BigInt& a) const;
+
+    /**
+     * @brief Computes a⁻¹ mod p.
+     * @param a The operand.
+     * @return The modular inverse.
+     * @throw std::runtime_error If a is not invertible.
+     */
+    BigInt inv(const BigInt& a) const;
+
+    /**
+     * @brief Computes a square root of a modulo p.
+     *
+     * Uses a single exponentiation a^((p+1)/4) when p ≡ 3 (mod 4) and Tonelli–Shanks otherwise.
+     *
+     * @param a The operand.
+     * @param root Receives a square root of a when one exists.
+     * @return True if a is a square modulo p (including zero), false otherwise.
+     */
+    bool sqrt(const BigInt& a, BigInt& root) const;
+
+    /**
+     * @brief Returns the backend best suited for the given modulus.
+     *
+     * The P-256 and secp256k1 primes get their special-form backends; any other modulus gets a
+     * generic backend. The curve primes and group orders are looked up without locking. Other
+     * moduli go through a locked hash map that keeps the 64 most recently added backends, so
+     * repeated calls with the same modulus normally share one object. Hot code should still resolve
+     * the backend once per owning object rather than per operation.
+     *
+     * @param modulus The prime defining the field.
+     * @return Shared pointer to the selected backend.
+     */
+    static std::shared_ptr<const FieldBackend> forModulus(const BigInt& modulus);
+
+protected:
+    BigInt p; ///< The prime modulus.
+};
+
+/**
+ * @class P256Field
+ * @brief Solinas reduction for p = 2²⁵⁶ − 2²²⁴ + 2¹⁹² + 2⁹⁶ − 1.
+ *
+ * Implements the fast reduction of FIPS 186-4, appendix D.2.3: a 512-bit product is split into
+ * sixteen 32-bit words which are recombined into nine 256-bit terms, summed, and corrected by a
+ * few additions or subtractions of p.
+ */
+class P256Field : public FieldBackend {
+public:
+    P256Field();
+    const char* name() const override;
+    void reduce(BigInt& x) const override;
+};
+
+/**
+ * @class Secp256k1Field
+ * @brief Pseudo-Mersenne reduction for p = 2²⁵⁶ − 2³² − 977.
+ *
+ * Uses 2²⁵⁶ ≡ 2³² + 977 (mod p) to fold the high half of a product into the low half with a
+ * single-limb multiplication, then finishes with at most two conditional subtractions.
+ */
+class Secp256k1Field : public FieldBackend {
+public:
+    Secp256k1Field();
+    const char* name() const override;
+    void reduce(BigInt& x) const override;
+};
+
+#endif // FIELD_HPP
@@ -0,0 +1,57 @@
+/**
+ * @file framing.hpp
+ * @brief Length-prefixed message frames over stream descriptors, shared by the MSM cluster and the
+ *        proving service.
+ *
+ * A frame is a 32-bit type and a 64-bit payload length, both little-endian, followed by the
+ * payload. The meaning of the type is up to each protocol.
+ */
+
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/un.h>
+#include <vector>
+
+/// Bytes before the payload: the type and the length.
+const size_t FRAME_HEADER_SIZE = 12;
+
+/// Largest payload readFrame() accepts.
+const uint64_t MAX_FRAME_PAYLOAD = static_cast<uint64_t>(1) << 32;
+
+/**
+ * @brief Writes one frame.
+ *
+ * Sockets are written with MSG_NOSIGNAL, so a closed peer raises an exception instead of SIGPIPE;
+ * other descriptors, such as pipes, fall back to write().
+ *
+ * @param fd The descriptor.
+ * @param type The frame type.
+ * @param payload The payload.
+ * @throw std::runtime_error If the write fails.
+ */
+void writeFrame(int fd, uint32_t type, const std::vector<unsigned char>& payload);
+
+/**
+ * @brief Reads one frame.
+ * @param fd The descriptor.
+ * @param type Receives the frame type.
+ * @param payload Receives the payload.
+ * @return false if the stream ended cleanly before the frame; true otherwise.
+ * @throw std::runtime_error If the read fails, the stream ends inside the frame or the payload
+ *        exceeds MAX_FRAME_PAYLOAD.
+ */
+bool readFrame(int fd, uint32_t& type, std::vector<unsigned char>& payload);
+
+/**
+ * @brief Builds the address of a Unix socket.
+ * @param socketPath The socket path.
+ * @return The address.
+ * @throw std::invalid_argument If the path does not fit sun_path.
+ */
+sockaddr_un socketAddress(const std::string& socketPath);
+
+#endif // FRAMING_HPP
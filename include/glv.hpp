@@ -0,0 +1,92 @@
+/**
+ * @file glv.hpp
+ * @brief Gallant–Lambert–Vanstone endomorphism acceleration for secp256k1.
+ *
+ * On secp256k1 the map φ(x, y) = (βx, y), with β a primitive cube root of unity in the base field,
+ * acts on the group as multiplication by a scalar λ. Splitting k = k1 + k2·λ (mod n) into two
+ * ~128-bit halves lets k·P be computed as k1·P + k2·φ(P), which halves the number of doublings.
+ */
+
+#ifndef GLV_HPP
+#define GLV_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+
+/**
+ * @struct GLVDecomposition
+ * @brief The result of splitting a scalar k into k1 + k2·λ (mod n).
+ *
+ * The halves are stored as magnitudes with separate sign flags so they can feed unsigned
+ * scalar-multiplication kernels directly.
+ */
+struct GLVDecomposition {
+    BigInt k1;        ///< Magnitude of the first half.
+    BigInt k2;        ///< Magnitude of the second half.
+    bool k1Negative;  ///< True if the first half is negative.
+    bool k2Negative;  ///< True if the second half is negative.
+};
+
+/**
+ * @class GLVEndomorphism
+ * @brief Precomputed endomorphism and lattice constants for a GLV-capable curve.
+ */
+class GLVEndomorphism {
+public:
+    /**
+     * @brief Looks up the endomorphism for a curve.
+     * @param params The curve parameters.
+     * @return Pointer to the shared endomorphism data, or nullptr if the curve has none.
+     */
+    static const GLVEndomorphism* forCurve(const CurveParameters& params);
+
+    /**
+     * @brief Splits a scalar into two half-length scalars.
+     *
+     * Uses the precomputed short lattice basis {(a1, b1), (a2, b2)} of the kernel of
+     * (i, j) ↦ i + j·λ mod n. The rounding divisions by n are replaced by multiplications with
+     * constants g1 = round(2³⁸⁴·b2/n) and g2 = round(−2³⁸⁴·b1/n) followed by a shift.
+     *
+     * @param k The scalar, any integer; it is reduced modulo n first.
+     * @return k1, k2 with k ≡ k1 + k2·λ (mod n) and |k1|, |k2| of roughly half the bit length of n.
+     */
+    GLVDecomposition split(const BigInt& k) const;
+
+    /**
+     * @brief Applies φ(x, y) = (βx, y) to a point.
+     * @param point The point to map.
+     * @return The image of the point, equal to λ·point.
+     */
+    Ecc_Point apply(const Ecc_Point& point) const;
+
+    /**
+     * @brief Computes k·P as k1·P + k2·φ(P) with a simultaneous double-scalar multiplication.
+     * @param point The base point.
+     * @param k The scalar.
+     * @return k·P.
+     */
+    Ecc_Point multiply(const Ecc_Point& point, const BigInt& k) const;
+
+    /**
+     * @brief Gets the base-field cube root of unity β.
+     * @return β.
+     */
+    const BigInt& getBeta() const { return beta; }
+
+    /**
+     * @brief Gets the scalar eigenvalue λ of the endomorphism.
+     * @return λ.
+     */
+    const BigInt& getLambda() const { return lambda; }
+
+private:
+    GLVEndomorphism();
+
+    BigInt beta;   ///< Cube root of unity modulo p.
+    BigInt lambda; ///< Cube root of unity modulo n, with φ(P) = λ·P.
+    BigInt n;      ///< Group order.
+    BigInt a1, b1, a2, b2; ///< Short lattice basis.
+    BigInt g1, g2; ///< Rounded 2³⁸⁴-scaled division constants.
+};
+
+#endif // GLV_HPP
@@ -0,0 +1,148 @@
+/**
+ * @file hashtocurve.hpp
+ * @brief Hashing byte strings to curve points with the simplified SWU map of RFC 9380.
+ *
+ * Implements the suites P256_XMD:SHA-256_SSWU_RO_ / _NU_ and secp256k1_XMD:SHA-256_SSWU_RO_ /
+ * _NU_. A message is expanded with expand_message_xmd into 48 bytes per field element, each element
+ * is mapped with the simplified Shallue–van de Woestijne–Ulas map, and for the random-oracle
+ * variant the two images are added. secp256k1 has a = 0, where the map is undefined, so its
+ * elements are mapped onto the 3-isogenous curve E′ of the RFC and carried over by the isogeny.
+ * Both curves have cofactor 1.
+ *
+ * Every message costs the same work: the map follows the straight-line procedure of RFC 9380
+ * appendix F.2, computing both candidate square roots with a single exponentiation
+ * (sqrt_ratio for p ≡ 3 mod 4, which folds the inversion of the denominator into the root) and
+ * selecting between them afterwards. The exponentiation uses mpz_powm_sec, whose timing does not
+ * depend on the base; the remaining GMP arithmetic is not hardened against timing side channels.
+ *
+ * The map results stay fractional: numerators and denominators become Jacobian coordinates, the
+ * two points are added in Jacobian form, and a single inversion converts the sum to affine
+ * coordinates. The batched functions share that inversion across a whole block of messages. Only
+ * the inversion is amortized: every message still costs its own two exponentiations, which
+ * dominate the cost, so batching mainly helps by spreading messages across threads.
+ */
+
+#ifndef HASHTOCURVE_HPP
+#define HASHTOCURVE_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "jacobian.hpp"
+#include "points.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief expand_message_xmd of RFC 9380 section 5.3.1 with SHA-256.
+ *
+ * Domain separation tags longer than 255 bytes are first hashed as the RFC prescribes.
+ *
+ * @param message The message.
+ * @param dst The domain separation tag; not empty.
+ * @param length Number of bytes to produce, at most 8160.
+ * @return The uniform bytes.
+ * @throw std::invalid_argument If the tag is empty or the length is 0 or too large.
+ */
+std::string expandMessageXmd(const std::string& message, const std::string& dst, size_t length);
+
+/**
+ * @class HashToCurve
+ * @brief Hash-to-curve and encode-to-curve for one curve and domain separation tag.
+ *
+ * Instances are immutable and safe to share between threads.
+ */
+class HashToCurve {
+public:
+    /// Bytes of expanded message per field element: ceil((256 + 128) / 8).
+    static const size_t ELEMENT_BYTES = 48;
+
+    /**
+     * @brief Prepares the suite for a curve.
+     * @param curve CurveParameters::p256() or CurveParameters::secp256k1().
+     * @param dst The domain separation tag of the application; not empty.
+     * @throw std::invalid_argument If the curve has no suite or the tag is empty.
+     */
+    HashToCurve(const CurveParameters& curve, const std::string& dst);
+
+    /**
+     * @brief Gets the curve.
+     * @return The curve parameters.
+     */
+    const CurveParameters& getCurve() const { return prototype.getCurveParameters(); }
+
+    /**
+     * @brief Hashes a message to a point, as hash_to_curve (the _RO_ suite).
+     *
+     * The result is indistinguishable from a random oracle into the group.
+     *
+     * @param message The message.
+     * @return The point.
+     */
+    Ecc_Point hash(const std::string& message) const;
+
+    /**
+     * @brief Encodes a message to a point, as encode_to_curve (the _NU_ suite).
+     *
+     * Costs one map instead of two, but the output distribution is not uniform.
+     *
+     * @param message The message.
+     * @return The point.
+     */
+    Ecc_Point encode(const std::string& message) const;
+
+    /**
+     * @brief Hashes many messages in parallel, as hash().
+     *
+     * Messages share the final inversion of their block; the square-root exponentiations are not
+     * batched.
+     *
+     * @param messages The messages.
+     * @param out Receives one point per message; resized as needed. Must be a vector on this curve.
+     * @param threads Number of threads; 0 selects the default.
+     * @throw std::invalid_argument If out holds points of another curve.
+     */
+    void hashBatch(const std::vector<std::string>& messages, PointVector& out, unsigned threads = 0) const;
+
+    /**
+     * @brief Hashes many messages in parallel, as hash().
+     * @param messages The messages.
+     * @param threads Number of threads; 0 selects the default.
+     * @return One point per message.
+     */
+    std::vector<Ecc_Point> hashBatch(const std::vector<std::string>& messages, unsigned threads = 0) const;
+
+    /**
+     * @brief Hashes a message to field elements, as hash_to_field.
+     * @param message The message.
+     * @param count Number of elements.
+     * @return count elements of [0, p).
+     */
+    std::vector<BigInt> hashToField(const std::string& message, size_t count) const;
+
+    /**
+     * @brief Maps one field element to a point, as map_to_curve followed by clear_cofactor.
+     * @param u The field element.
+     * @return The point.
+     */
+    Ecc_Point mapToCurve(const BigInt& u) const;
+
+private:
+    JacobianPoint map(const BigInt& u) const;
+    JacobianPoint hashJacobian(const std::string& message) const;
+    void sqrtRatio(const BigInt& u, const BigInt& v, bool& square, BigInt& root) const;
+    BigInt horner(const std::vector<BigInt>& coefficients, const BigInt& xn, const std::vector<BigInt>& xdPowers) const;
+
+    Ecc_Point prototype;                     ///< The generator, carrying the curve and its field.
+    JacobianArithmetic arithmetic;
+    std::string dst;
+    BigInt A;                                ///< a of the curve the SWU map targets (E′ for secp256k1).
+    BigInt B;                                ///< b of the curve the SWU map targets.
+    BigInt Z;                                ///< The suite's non-square Z.
+    BigInt c1;                               ///< (p − 3) / 4.
+    BigInt c2;                               ///< A square root of −Z.
+    bool isogeny;                            ///< Whether the map targets E′ and needs the 3-isogeny.
+    std::vector<BigInt> xNum, xDen, yNum, yDen; ///< Isogeny coefficients k(i, j), lowest degree first.
+};
+
+#endif // HASHTOCURVE_HPP
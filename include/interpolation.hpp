@@ -0,0 +1,50 @@
+/**
+ * @file interpolation.hpp
+ * @brief Point sets and Lagrange interpolation over F_p.
+ */
+
+#ifndef INTERPOLATION_HPP
+#define INTERPOLATION_HPP
+
+#include "bigint.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @struct Data
+ * @brief A point (x, y) of a function over F_p.
+ */
+struct Data {
+    BigInt x, y;
+
+    /**
+     * @brief Constructs the point (0, 0).
+     */
+    Data() {}
+
+    /**
+     * @brief Constructs a point from field elements without string parsing.
+     * @param x The abscissa.
+     * @param y The ordinate.
+     */
+    Data(const BigInt& x, const BigInt& y) : x(x), y(y) {}
+
+    /**
+     * @brief Constructs a point from decimal strings, reducing both coordinates modulo p.
+     * @param xStr The abscissa in decimal.
+     * @param yStr The ordinate in decimal.
+     * @param modStr The modulus p in decimal.
+     */
+    Data(const std::string& xStr, const std::string& yStr, const std::string& modStr);
+};
+
+/**
+ * @brief Evaluates the Lagrange interpolation polynomial of a point set.
+ * @param f The points; their x coordinates must be distinct modulo p.
+ * @param xi The evaluation point.
+ * @param modStr The modulus p in decimal.
+ * @return The value at xi of the polynomial of degree below f.size() through the points.
+ */
+BigInt interpolate(const std::vector<Data>& f, const BigInt& xi, const std::string& modStr);
+
+#endif // INTERPOLATION_HPP
@@ -0,0 +1,151 @@
+/**
+ * @file io.hpp
+ * @brief Little-endian integer encoding and POSIX file helpers shared by the binary file formats.
+ *
+ * The powers-of-tau, MSM input, field element and point files all store their header fields as
+ * little-endian integers and are read either with positioned reads or through a memory mapping.
+ */
+
+#ifndef IO_HPP
+#define IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * @brief Writes the low bytes of an integer, least significant first.
+ * @param out Destination of bytes bytes.
+ * @param v The value.
+ * @param bytes Number of bytes, at most 8.
+ */
+void storeLE(unsigned char* out, uint64_t v, size_t bytes);
+
+/**
+ * @brief Appends the low bytes of an integer, least significant first.
+ * @param out The buffer to append to.
+ * @param v The value.
+ * @param bytes Number of bytes, at most 8.
+ */
+void storeLE(std::vector<unsigned char>& out, uint64_t v, size_t bytes);
+
+/**
+ * @brief Reads a little-endian integer.
+ * @param in Source of bytes bytes.
+ * @param bytes Number of bytes, at most 8.
+ * @return The value.
+ */
+uint64_t loadLE(const unsigned char* in, size_t bytes);
+
+/**
+ * @brief Reads exactly size bytes at an offset, retrying short and interrupted reads.
+ * @param fd The descriptor.
+ * @param data Destination buffer.
+ * @param size Number of bytes.
+ * @param offset File offset of the first byte.
+ * @param what Description of the file for error messages, such as "MSM input file".
+ * @throw std::runtime_error If the read fails or the file ends early.
+ */
+void readAt(int fd, unsigned char* data, size_t size, off_t offset, const std::string& what);
+
+/**
+ * @brief Writes exactly size bytes at an offset, retrying short and interrupted writes.
+ * @param fd The descriptor.
+ * @param data Source buffer.
+ * @param size Number of bytes.
+ * @param offset File offset of the first byte.
+ * @param what Description of the file for error messages.
+ * @throw std::runtime_error If the write fails.
+ */
+void writeAt(int fd, const unsigned char* data, size_t size, off_t offset, const std::string& what);
+
+/**
+ * @class FileHandle
+ * @brief Owns a file descriptor and closes it on destruction.
+ */
+class FileHandle {
+public:
+    /**
+     * @brief Opens a file; created files get mode 0644.
+     * @param path The file path.
+     * @param flags Flags for open(2).
+     * @param what Description of the file for error messages.
+     * @throw std::runtime_error If the file cannot be opened.
+     */
+    FileHandle(const std::string& path, int flags, const std::string& what);
+    ~FileHandle();
+
+    /**
+     * @brief Gets the descriptor.
+     * @return The descriptor, valid until destruction.
+     */
+    int get() const { return fd; }
+
+private:
+    FileHandle(const FileHandle&);
+    FileHandle& operator=(const FileHandle&);
+
+    int fd;
+};
+
+/**
+ * @class MappedFile
+ * @brief A whole file mapped into memory, unmapped on destruction.
+ *
+ * Read-only mappings are private; writable ones are shared, so stores reach the file.
+ */
+class MappedFile {
+public:
+    /// How the file is opened.
+    enum Mode {
+        ReadOnly,  ///< An existing file, mapped for reading.
+        ReadWrite, ///< An existing file, mapped for reading and writing.
+        Create     ///< A new or truncated file of a given size, mapped for reading and writing.
+    };
+
+    /**
+     * @brief Opens and maps a file. An empty file is not mapped and has a null get().
+     * @param path The file path.
+     * @param mode How to open it.
+     * @param createBytes Size of the file in Create mode; ignored otherwise.
+     * @throw std::runtime_error If the file cannot be opened, sized or mapped.
+     */
+    MappedFile(const std::string& path, Mode mode, size_t createBytes = 0);
+    ~MappedFile();
+
+    /**
+     * @brief Gets the mapped bytes.
+     * @return The first byte of the file; writable unless the mode is ReadOnly.
+     */
+    unsigned char* get() const { return data; }
+
+    /**
+     * @brief Gets the file size.
+     * @return The number of mapped bytes.
+     */
+    size_t size() const { return bytes; }
+
+    /**
+     * @brief Tells the kernel the file will be read front to back.
+     */
+    void adviseSequential() const;
+
+    /**
+     * @brief Drops the resident pages of a finished range; their contents stay in the file.
+     * @param offset First byte of the range.
+     * @param length Length of the range in bytes.
+     */
+    void release(size_t offset, size_t length) const;
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    unsigned char* data;
+    size_t bytes;
+};
+
+#endif // IO_HPP
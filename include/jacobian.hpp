@@ -0,0 +1,163 @@
+/**
+ * @file jacobian.hpp
+ * @brief Inversion-free elliptic curve arithmetic in Jacobian coordinates.
+ *
+ * Ecc_Point works in affine coordinates and pays a modular inversion for every addition and
+ * doubling. The routines here keep intermediate points as (X : Y : Z) with x = X/Z², y = Y/Z³ and
+ * only convert back to affine form at the end, optionally for many points with a single inversion.
+ */
+
+#ifndef JACOBIAN_HPP
+#define JACOBIAN_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "field.hpp"
+#include "points.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @struct JacobianPoint
+ * @brief A point in Jacobian projective coordinates. The point at infinity has Z = 0.
+ */
+struct JacobianPoint {
+    BigInt X; ///< Projective X coordinate.
+    BigInt Y; ///< Projective Y coordinate.
+    BigInt Z; ///< Projective Z coordinate, zero for the point at infinity.
+
+    /**
+     * @brief Default constructor. Creates the point at infinity.
+     */
+    JacobianPoint() : X(static_cast<unsigned long int>(1)), Y(static_cast<unsigned long int>(1)), Z(static_cast<unsigned long int>(0)) {}
+
+    /**
+     * @brief Check if this is the point at infinity.
+     * @return True if Z is zero, false otherwise.
+     */
+    bool isInfinity() const { return Z.isZero(); }
+};
+
+/**
+ * @class JacobianArithmetic
+ * @brief Jacobian point operations bound to one curve and its field backend.
+ *
+ * Formulas follow the Explicit-Formulas Database (dbl-2007-bl, add-2007-bl, madd-2007-bl) and
+ * work for any short Weierstrass curve y² = x³ + ax + b.
+ */
+class JacobianArithmetic {
+public:
+    /**
+     * @brief Binds the arithmetic to the curve of the given point.
+     * @param curvePoint Any finite point on the target curve.
+     * @throw std::invalid_argument If the point is the default-constructed point at infinity.
+     */
+    explicit JacobianArithmetic(const Ecc_Point& curvePoint);
+
+    /**
+     * @brief Lifts an affine point to Jacobian coordinates.
+     * @param point The affine point.
+     * @return The same point with Z = 1, or infinity.
+     */
+    JacobianPoint fromAffine(const Ecc_Point& point) const;
+
+    /**
+     * @brief Converts a Jacobian point back to affine coordinates with one inversion.
+     * @param point The Jacobian point.
+     * @return The affine point on this curve.
+     */
+    Ecc_Point toAffine(const JacobianPoint& point) const;
+
+    /**
+     * @brief Converts many Jacobian points to affine form sharing a single inversion.
+     *
+     * Uses Montgomery's trick: prefix products of the Z coordinates are inverted once and the
+     * individual inverses are recovered with three multiplications per point.
+     *
+     * @param points The Jacobian points.
+     * @return The affine points, in the same order.
+     */
+    std::vector<Ecc_Point> toAffineBatch(const std::vector<JacobianPoint>& points) const;
+
+    /**
+     * @brief Converts many Jacobian points to affine form in a PointVector, sharing a single inversion.
+     * @param points The Jacobian points.
+     * @param out Receives the affine points, in the same order; resized to points.size(). It must
+     *        be a vector on this curve.
+     */
+    void toAffineBatch(const std::vector<JacobianPoint>& points, PointVector& out) const;
+
+    /**
+     * @brief Computes 2P.
+     * @param p The point to double.
+     * @return The doubled point.
+     */
+    JacobianPoint dbl(const JacobianPoint& p) const;
+
+    /**
+     * @brief Computes P + Q for two Jacobian points.
+     * @param p First summand.
+     * @param q Second summand.
+     * @return The sum.
+     */
+    JacobianPoint add(const JacobianPoint& p, const JacobianPoint& q) const;
+
+    /**
+     * @brief Computes P + Q where Q is affine (mixed addition).
+     * @param p Jacobian summand.
+     * @param q Affine summand.
+     * @return The sum.
+     */
+    JacobianPoint addMixed(const JacobianPoint& p, const Ecc_Point& q) const;
+
+    /**
+     * @brief Computes P + Q where Q is a finite affine point given by its coordinates.
+     * @param p Jacobian summand.
+     * @param x The x coordinate of Q.
+     * @param y The y coordinate of Q.
+     * @return The sum.
+     */
+    JacobianPoint addMixed(const JacobianPoint& p, const BigInt& x, const BigInt& y) const;
+
+    /**
+     * @brief Computes −P.
+     * @param p The point to negate.
+     * @return The negated point.
+     */
+    JacobianPoint negate(const JacobianPoint& p) const;
+
+    /**
+     * @brief Computes k1·P + k2·Q with interleaved width-w NAF (Straus–Shamir).
+     *
+     * Both scalars must be non-negative. The doublings are shared between the two scalars, so the
+     * cost is dominated by max(bits(k1), bits(k2)) doublings.
+     *
+     * @param p First base point.
+     * @param k1 Scalar for the first base point.
+     * @param q Second base point.
+     * @param k2 Scalar for the second base point.
+     * @return k1·P + k2·Q in Jacobian coordinates.
+     */
+    JacobianPoint mulDouble(const Ecc_Point& p, const BigInt& k1, const Ecc_Point& q, const BigInt& k2) const;
+
+    /**
+     * @brief Gets the field backend used for coordinate arithmetic.
+     * @return The field backend.
+     */
+    const FieldBackend& getField() const { return *field; }
+
+private:
+    Ecc_Point prototype; ///< A point on the curve, used to build affine results.
+    std::shared_ptr<const FieldBackend> field; ///< Coordinate field backend.
+    BigInt a; ///< Curve coefficient a.
+};
+
+/**
+ * @brief Computes the width-w non-adjacent form of a non-negative scalar.
+ * @param k The scalar.
+ * @param w The window width, between 2 and 16.
+ * @return Signed odd digits (or zero), least significant first.
+ */
+std::vector<int> computeWNAF(const BigInt& k, int w);
+
+#endif // JACOBIAN_HPP
@@ -0,0 +1,185 @@
+/**
+ * @file kzg.hpp
+ * @brief KZG polynomial commitments with batched multi-point openings.
+ *
+ * A commitment to f(x) = Σ fᵢxⁱ is the group element f(τ)·G = Σ fᵢ·(τⁱ·G), computed as one MSM
+ * over the structured reference string. An opening at z proves f(z) = y with the commitment to the
+ * quotient q(x) = (f(x) − y)/(x − z).
+ *
+ * The curves in this library are not pairing-friendly, so verification uses a designated-verifier
+ * key holding τ in place of the G2 element τ·H: every check is written as A = τ·B, which is
+ * exactly the pairing equation e(A, H) = e(B, τ·H) evaluated in the exponent. Swapping in a
+ * pairing backend only changes KZGVerifierKey and the final comparison.
+ */
+
+#ifndef KZG_HPP
+#define KZG_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "ntt.hpp"
+#include "polynomial.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @struct KZGSetup
+ * @brief Structured reference string: the powers τⁱ·G for i = 0..maxDegree.
+ */
+struct KZGSetup {
+    std::vector<Ecc_Point> powersOfTau; ///< τⁱ·G, lowest power first.
+    BigInt modulus;                     ///< Scalar field modulus (the curve order n).
+};
+
+/**
+ * @struct KZGVerifierKey
+ * @brief Verification key: the generator and the trapdoor standing in for τ·H.
+ */
+struct KZGVerifierKey {
+    Ecc_Point g; ///< The generator G.
+    BigInt tau;  ///< The SRS trapdoor τ, used in place of a pairing.
+};
+
+/**
+ * @struct KZGOpening
+ * @brief A single-point opening: f(point) = value, proven by witness.
+ */
+struct KZGOpening {
+    BigInt point;      ///< The evaluation point z.
+    BigInt value;      ///< The claimed value f(z).
+    Ecc_Point witness; ///< Commitment to (f(x) − f(z))/(x − z).
+};
+
+/**
+ * @struct KZGBatchOpening
+ * @brief A multi-polynomial, multi-point opening of two group elements, whatever the number of
+ *        polynomials and points.
+ *
+ * Polynomials opened at the same point zⱼ are folded into Fⱼ with powers of a Fiat–Shamir
+ * challenge γ. Following Boneh, Drake, Fisch and Gabizon, the per-point quotients are then
+ * combined with powers of a second challenge ρ into h = Σ ρʲ(Fⱼ − vⱼ)/(X − zⱼ), and the
+ * polynomial L = Σ ρʲ·Z_{T∖j}(x)·(Fⱼ − vⱼ) − Z_T(x)·h, which vanishes at a third challenge x, is
+ * opened there. Z_T is the polynomial vanishing on all the points and Z_{T∖j} the one vanishing on
+ * all but zⱼ.
+ */
+struct KZGBatchOpening {
+    std::vector<BigInt> points;               ///< The distinct evaluation points zⱼ.
+    std::vector<std::vector<size_t>> openSets; ///< For each point, the indices of the polynomials opened there.
+    std::vector<std::vector<BigInt>> values;  ///< values[j][k] = f_{openSets[j][k]}(zⱼ).
+    Ecc_Point quotient;                       ///< W, the commitment to h.
+    Ecc_Point witness;                        ///< W', the commitment to L/(X − x).
+};
+
+/**
+ * @brief Generates a structured reference string from a known trapdoor.
+ *
+ * Intended for tests and local setups; the trapdoor must be discarded (or kept only in the
+ * designated verifier key) in real deployments.
+ *
+ * @param curve The curve providing G and the scalar field.
+ * @param tau The trapdoor τ.
+ * @param maxDegree The largest polynomial degree that can be committed.
+ * @return The reference string.
+ */
+KZGSetup kzgSetup(const CurveParameters& curve, const BigInt& tau, size_t maxDegree);
+
+/**
+ * @brief Loads a structured reference string written by generatePowersOfTau().
+ *
+ * @param path The powers-of-tau file.
+ * @param curve The curve the file was generated for.
+ * @return The reference string holding every completed power.
+ * @throw std::runtime_error If the file cannot be read or belongs to another curve.
+ */
+KZGSetup kzgLoadSetup(const std::string& path, const CurveParameters& curve);
+
+/**
+ * @brief Commits to a polynomial with one MSM over the reference string.
+ * @param setup The reference string.
+ * @param poly The polynomial; its modulus must be the curve order.
+ * @return The commitment f(τ)·G.
+ * @throw std::invalid_argument If the degree is too large or the modulus does not match.
+ */
+Ecc_Point kzgCommit(const KZGSetup& setup, const Polynomial& poly);
+
+/**
+ * @brief Opens a polynomial at a single point.
+ * @param setup The reference string.
+ * @param poly The polynomial.
+ * @param point The evaluation point z.
+ * @return The value f(z) and the quotient commitment.
+ */
+KZGOpening kzgOpen(const KZGSetup& setup, const Polynomial& poly, const BigInt& point);
+
+/**
+ * @brief Converts the reference string to the Lagrange basis of a domain.
+ *
+ * Entry i is Lᵢ(τ)·G, where Lᵢ is the polynomial of degree below n that is 1 at ωⁱ and 0 on the
+ * rest of the domain. The points are the inverse NTT of τ⁰·G, …, τ^(n−1)·G, computed with one
+ * batchScalarMul() per butterfly level. Committing to evaluations vᵢ over the domain as Σ vᵢ·Lᵢ(τ)·G
+ * gives the same point as kzgCommit() on the interpolated polynomial, and changing one evaluation
+ * changes the commitment by a single term.
+ *
+ * @param setup The reference string.
+ * @param domain The domain; its modulus must be the scalar field of the setup.
+ * @param threads Number of threads; 0 selects the default.
+ * @return The n basis points.
+ * @throw std::invalid_argument If the moduli differ or the domain is larger than the reference string.
+ */
+std::vector<Ecc_Point> kzgLagrangeBasis(const KZGSetup& setup, const EvaluationDomain& domain, unsigned threads = 0);
+
+/**
+ * @brief Opens a polynomial given by its evaluations over a domain.
+ *
+ * The value comes from the barycentric formula, and the quotient (f(x) − f(z))/(x − z) is
+ * evaluated on the domain directly, so neither an inverse NTT nor a polynomial division is needed.
+ * The witness is one MSM over the Lagrange basis. The result equals kzgOpen() on the interpolated
+ * polynomial, including when z lies on the domain.
+ *
+ * @param lagrangeBasis The basis returned by kzgLagrangeBasis() for this domain.
+ * @param domain The domain.
+ * @param values The evaluations f(ω⁰), f(ω¹), …; shorter inputs are zero-padded to the domain size.
+ * @param point The evaluation point z.
+ * @return The value f(z) and the quotient commitment.
+ * @throw std::invalid_argument If the basis does not match the domain or there are too many values.
+ */
+KZGOpening kzgOpenEvaluations(const std::vector<Ecc_Point>& lagrangeBasis, const EvaluationDomain& domain,
+                              const std::vector<BigInt>& values, const BigInt& point);
+
+/**
+ * @brief Verifies a single-point opening: C − y·G = (τ − z)·W.
+ * @param vk The verifier key.
+ * @param commitment The commitment to f.
+ * @param opening The opening to check.
+ * @return True if the opening is valid, false otherwise.
+ */
+bool kzgVerify(const KZGVerifierKey& vk, const Ecc_Point& commitment, const KZGOpening& opening);
+
+/**
+ * @brief Opens many polynomials at many points.
+ * @param setup The reference string.
+ * @param polys The polynomials.
+ * @param commitments Their commitments, bound into the Fiat–Shamir challenge.
+ * @param points The distinct evaluation points.
+ * @param openSets For each point, the indices into polys of the polynomials opened there.
+ * @return The batch opening.
+ * @throw std::invalid_argument If the shapes of the inputs do not match.
+ */
+KZGBatchOpening kzgBatchOpen(const KZGSetup& setup, const std::vector<Polynomial>& polys,
+                             const std::vector<Ecc_Point>& commitments, const std::vector<BigInt>& points,
+                             const std::vector<std::vector<size_t>>& openSets);
+
+/**
+ * @brief Verifies a batch opening with a single pairing-equivalent check.
+ *
+ * Rebuilds the commitment [L] = Σ ρʲ·Z_{T∖j}(x)·(Fⱼ − vⱼ·G) − Z_T(x)·W from the commitments and
+ * claimed values, with Fⱼ = Σ γᵏ·Cₖ and vⱼ = Σ γᵏ·yₖ, and checks [L] = (τ − x)·W' as one MSM.
+ *
+ * @param vk The verifier key.
+ * @param commitments The commitments to all polynomials.
+ * @param opening The batch opening.
+ * @return True if every claimed value is correct, false otherwise.
+ */
+bool kzgBatchVerify(const KZGVerifierKey& vk, const std::vector<Ecc_Point>& commitments, const KZGBatchOpening& opening);
+
+#endif // KZG_HPP
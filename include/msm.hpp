@@ -0,0 +1,84 @@
+/**
+ * @file msm.hpp
+ * @brief Multi-scalar multiplication over Ecc_Point arrays.
+ *
+ * Computes Σ kᵢ·Pᵢ with Pippenger's bucket method in Jacobian coordinates. On curves with a GLV
+ * endomorphism every term is first split into two half-length terms, which halves the number of
+ * windows and therefore the number of doublings.
+ *
+ * batchScalarMul() covers the opposite case, many independent products kᵢ·Pᵢ kept separate.
+ */
+
+#ifndef MSM_HPP
+#define MSM_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "points.hpp"
+#include <vector>
+
+/**
+ * @brief Computes the multi-scalar multiplication Σ scalars[i]·points[i].
+ *
+ * All points must lie on the same curve. Points at infinity and zero scalars are skipped.
+ * Scalars are reduced modulo the curve order before use.
+ *
+ * @param points The base points.
+ * @param scalars The scalars, one per point.
+ * @return The sum, or the point at infinity for an empty input.
+ * @throw std::invalid_argument If the number of points and scalars differ.
+ */
+Ecc_Point multiScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars);
+
+/**
+ * @brief Computes the multi-scalar multiplication Σ scalars[i]·points[i] over a point array.
+ *
+ * The bases are read from the coordinate arrays of the view and the normalized terms are kept in
+ * a PointVector, so no Ecc_Point is built per term. The Ecc_Point overload normalizes its input
+ * the same way, straight from the points.
+ *
+ * @param points The base points; a PointVector converts implicitly.
+ * @param scalars The scalars, one per point.
+ * @return The sum, or the point at infinity for an empty input.
+ * @throw std::invalid_argument If the number of points and scalars differ.
+ */
+Ecc_Point multiScalarMul(const PointView& points, const std::vector<BigInt>& scalars);
+
+/**
+ * @brief Computes kᵢ·Pᵢ for many independent terms, returning every product separately.
+ *
+ * The terms are split into one contiguous chunk per thread. Within a chunk each product runs an
+ * interleaved width-5 NAF ladder (over the GLV halves on curves with an endomorphism) in Jacobian
+ * coordinates. The odd-multiple tables of the whole chunk are normalized with one shared inversion,
+ * and so are its results, so a chunk costs two field inversions regardless of its length.
+ *
+ * All finite points must lie on the same curve. Scalars are reduced modulo the curve order and may
+ * be negative.
+ *
+ * @param points The base points.
+ * @param scalars The scalars, one per point.
+ * @param count The number of terms.
+ * @param threads Number of threads; 0 selects the default.
+ * @return The products, in input order; infinity for points at infinity and zero scalars.
+ */
+std::vector<Ecc_Point> batchScalarMul(const Ecc_Point* points, const BigInt* scalars, size_t count, unsigned threads = 0);
+
+/**
+ * @brief Computes kᵢ·Pᵢ for every pair of the input vectors.
+ * @param points The base points.
+ * @param scalars The scalars, one per point.
+ * @param threads Number of threads; 0 selects the default.
+ * @return The products, in input order.
+ * @throw std::invalid_argument If the number of points and scalars differ.
+ */
+std::vector<Ecc_Point> batchScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars,
+                                      unsigned threads = 0);
+
+/**
+ * @brief Chooses the Pippenger window width for a given number of terms.
+ * @param termCount The number of (point, scalar) terms after any GLV splitting.
+ * @return The window width in bits.
+ */
+int msmWindowBits(size_t termCount);
+
+#endif // MSM_HPP
@@ -0,0 +1,174 @@
+/**
+ * @file ntt.hpp
+ * @brief Number-theoretic transforms over power-of-two evaluation domains, in memory and out of core.
+ *
+ * An EvaluationDomain is the multiplicative subgroup {1, ω, ω², …, ω^(n−1)} of F_p for a power of
+ * two n dividing p − 1. Its fft() maps coefficients to evaluations over the domain and ifft() maps
+ * them back, in O(n log n) with an iterative radix-2 transform.
+ *
+ * For domains too large for memory, outOfCoreNtt() runs Bailey's six-step algorithm on a
+ * memory-mapped file. The n = N1·N2 elements are viewed as an N1 x N2 row-major matrix; columns are
+ * made contiguous with a tiled transpose, transformed and multiplied by the twiddles ω^(row·col),
+ * transposed back, transformed along rows and transposed once more into natural order. Every pass
+ * walks the file sequentially in bands and releases the pages of finished bands, so the resident
+ * working set stays around a few rows and tiles rather than the whole domain.
+ */
+
+#ifndef NTT_HPP
+#define NTT_HPP
+
+#include "bigint.hpp"
+#include "field.hpp"
+#include "polynomial.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The BN254 scalar field prime, whose multiplicative group has a subgroup of order 2^28.
+ * @return r = 0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001.
+ */
+const BigInt& nttFriendlyModulus();
+
+/**
+ * @class EvaluationDomain
+ * @brief A multiplicative subgroup of order 2^k used for NTT-based polynomial arithmetic.
+ */
+class EvaluationDomain {
+public:
+    /**
+     * @brief Builds the subgroup of the given order.
+     *
+     * The generator ω is g^((p−1)/n) for the smallest quadratic non-residue g, so domains of
+     * different sizes over the same field are nested: the generator of a domain of size n/m is ω^m.
+     *
+     * @param size The domain size; must be a power of two.
+     * @param modulus The prime p.
+     * @throw std::invalid_argument If size is not a power of two or does not divide p − 1.
+     */
+    EvaluationDomain(size_t size, const BigInt& modulus);
+
+    /**
+     * @brief Gets the number of points in the domain.
+     * @return n.
+     */
+    size_t size() const { return n; }
+
+    /**
+     * @brief Gets log₂ of the domain size.
+     * @return k with n = 2^k.
+     */
+    unsigned logSize() const { return logN; }
+
+    /**
+     * @brief Gets the field modulus.
+     * @return p.
+     */
+    const BigInt& modulus() const { return field->modulus(); }
+
+    /**
+     * @brief Gets the primitive n-th root of unity generating the domain.
+     * @return ω.
+     */
+    const BigInt& generator() const { return omega; }
+
+    /**
+     * @brief Gets the inverse of the generator.
+     * @return ω⁻¹.
+     */
+    const BigInt& generatorInverse() const { return omegaInv; }
+
+    /**
+     * @brief Gets the inverse of the domain size in the field.
+     * @return n⁻¹ mod p.
+     */
+    const BigInt& sizeInverse() const { return sizeInv; }
+
+    /**
+     * @brief Gets the field backend used for the transforms.
+     * @return The field backend.
+     */
+    const FieldBackend& getField() const { return *field; }
+
+    /**
+     * @brief Gets a domain element.
+     * @param i The index.
+     * @return ω^i.
+     */
+    BigInt element(size_t i) const;
+
+    /**
+     * @brief Converts coefficients to evaluations at ω⁰, …, ω^(n−1) in place.
+     * @param values The coefficients; shorter inputs are zero-padded to the domain size.
+     * @throw std::invalid_argument If there are more values than domain points.
+     */
+    void fft(std::vector<BigInt>& values) const;
+
+    /**
+     * @brief Converts evaluations at ω⁰, …, ω^(n−1) back to coefficients in place.
+     * @param values The evaluations; shorter inputs are zero-padded to the domain size.
+     * @throw std::invalid_argument If there are more values than domain points.
+     */
+    void ifft(std::vector<BigInt>& values) const;
+
+    /**
+     * @brief Evaluates over the coset shift·⟨ω⟩, which avoids the zeros of the vanishing polynomial.
+     * @param values The coefficients, replaced by the evaluations at shift·ω^i.
+     * @param shift The coset representative.
+     * @throw std::invalid_argument If there are more values than domain points.
+     */
+    void cosetFft(std::vector<BigInt>& values, const BigInt& shift) const;
+
+    /**
+     * @brief Interpolates from evaluations over the coset shift·⟨ω⟩.
+     * @param values The evaluations at shift·ω^i, replaced by the coefficients.
+     * @param shift The coset representative.
+     * @throw std::invalid_argument If there are more values than domain points.
+     */
+    void cosetIfft(std::vector<BigInt>& values, const BigInt& shift) const;
+
+    /**
+     * @brief Gets the vanishing polynomial of the domain.
+     * @return x^n − 1, stored sparsely.
+     */
+    Polynomial vanishingPolynomial() const;
+
+    /**
+     * @brief Evaluates the vanishing polynomial.
+     * @param x The point.
+     * @return x^n − 1 mod p.
+     */
+    BigInt evaluateVanishing(const BigInt& x) const;
+
+    friend void outOfCoreNtt(const std::string& path, const EvaluationDomain& domain, bool inverse, unsigned threads);
+
+private:
+    void transform(std::vector<BigInt>& values, bool inverse) const;
+
+    size_t n;
+    unsigned logN;
+    std::shared_ptr<const FieldBackend> field;
+    BigInt omega;
+    BigInt omegaInv;
+    BigInt sizeInv;
+    std::vector<BigInt> twiddles;        ///< ω^i for i < n/2.
+    std::vector<BigInt> inverseTwiddles; ///< ω^(−i) for i < n/2.
+};
+
+/**
+ * @brief Transforms a domain stored in a file in place, without loading it into memory.
+ *
+ * The file holds domain.size() residues, each as four little-endian 64-bit limbs (the SimdField
+ * raw layout), so the modulus must fit in 256 bits. A scratch file of the same size is created next
+ * to it and renamed over it when the transform finishes.
+ *
+ * @param path The file to transform.
+ * @param domain The evaluation domain; its size fixes the element count.
+ * @param inverse False for coefficients to evaluations, true for evaluations to coefficients.
+ * @param threads Number of threads for the row passes; 0 selects the default.
+ * @throw std::invalid_argument If the modulus is wider than 256 bits or the file has the wrong size.
+ * @throw std::runtime_error If a file cannot be opened, mapped or renamed.
+ */
+void outOfCoreNtt(const std::string& path, const EvaluationDomain& domain, bool inverse = false, unsigned threads = 0);
+
+#endif // NTT_HPP
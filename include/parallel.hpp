@@ -0,0 +1,32 @@
+/**
+ * @file parallel.hpp
+ * @brief Minimal thread-level parallelism helpers built on std::thread.
+ */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Number of worker threads used when a caller asks for the default.
+ * @return std::thread::hardware_concurrency(), or 1 if it is unknown.
+ */
+unsigned defaultThreadCount();
+
+/**
+ * @brief Runs body(i) for every i in [0, count) on a pool of threads.
+ *
+ * Indices are handed out dynamically, so uneven work items balance across threads. The calling
+ * thread participates as one of the workers. If any invocation throws, the first exception is
+ * rethrown on the calling thread after all workers have stopped. Workers charge their GMP
+ * allocations to the caller's AllocationScope.
+ *
+ * @param count Number of work items.
+ * @param body The work to perform for each index.
+ * @param threads Number of threads to use; 0 selects defaultThreadCount().
+ */
+void parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned threads = 0);
+
+#endif // PARALLEL_HPP
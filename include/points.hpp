@@ -0,0 +1,302 @@
+/**
+ * @file points.hpp
+ * @brief Contiguous arrays of affine curve points in structure-of-arrays layout.
+ *
+ * Every Ecc_Point carries its own copy of the curve parameters, so a std::vector<Ecc_Point> spends
+ * most of its memory on the same six constants repeated once per point. A PointVector stores only
+ * the coordinates, each as a fixed number of little-endian 64-bit limbs (the size of p rounded up to
+ * whole limbs), with all x coordinates in one array, all y coordinates in another and the points at
+ * infinity in a bitmap. The curve is held once for the whole vector. A 256-bit curve needs 64 bytes
+ * and one bit per point.
+ *
+ * PointView is a read-only window onto a range of a PointVector. multiScalarMul(),
+ * JacobianArithmetic::toAffineBatch() and the point file functions in serialization.hpp accept
+ * views and vectors directly. Element access returns Ecc_Point values built on demand.
+ */
+
+#ifndef POINTS_HPP
+#define POINTS_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+class PointView;
+
+/**
+ * @class PointVector
+ * @brief A growable array of affine points on one curve.
+ *
+ * Coordinates are stored reduced into [0, p). New entries created by resize() are the point at
+ * infinity, whose stored coordinates are zero.
+ */
+class PointVector {
+public:
+    /**
+     * @class const_iterator
+     * @brief Forward iterator yielding points as Ecc_Point values.
+     */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Ecc_Point value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Ecc_Point* pointer;
+        typedef Ecc_Point reference;
+
+        const_iterator(const PointVector* points, size_t index) : points(points), index(index) {}
+        Ecc_Point operator*() const { return (*points)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++index; return old; }
+        bool operator==(const const_iterator& other) const { return index == other.index && points == other.points; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const PointVector* points;
+        size_t index;
+    };
+
+    /**
+     * @brief Creates an empty vector.
+     * @param curve The curve of the points.
+     */
+    explicit PointVector(const CurveParameters& curve);
+
+    /**
+     * @brief Copies points into a new vector.
+     * @param curve The curve of the points.
+     * @param points The points; their coordinates are reduced modulo p.
+     */
+    PointVector(const CurveParameters& curve, const std::vector<Ecc_Point>& points);
+
+    /**
+     * @brief Gets the number of points.
+     * @return The size.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Checks whether the vector is empty.
+     * @return True if it holds no points.
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Gets the number of 64-bit limbs per coordinate.
+     * @return The limb count of p.
+     */
+    size_t limbs() const { return width; }
+
+    /**
+     * @brief Gets the curve of the points.
+     * @return The curve parameters.
+     */
+    const CurveParameters& getCurve() const { return prototype->getCurveParameters(); }
+
+    /**
+     * @brief Gets the coordinate field backend.
+     * @return The backend selected from p.
+     */
+    const FieldBackend& getField() const { return *prototype->getField(); }
+
+    /**
+     * @brief Reserves room for points without changing the size.
+     * @param capacity The number of points.
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Changes the size; new entries are the point at infinity.
+     * @param size The new size.
+     */
+    void resize(size_t size);
+
+    /**
+     * @brief Removes every point.
+     */
+    void clear() { resize(0); }
+
+    /**
+     * @brief Appends a point.
+     * @param point The point.
+     */
+    void push_back(const Ecc_Point& point);
+
+    /**
+     * @brief Appends a finite point by its coordinates.
+     * @param x The x coordinate; reduced modulo p.
+     * @param y The y coordinate; reduced modulo p.
+     */
+    void pushAffine(const BigInt& x, const BigInt& y);
+
+    /**
+     * @brief Replaces a point.
+     * @param i The index.
+     * @param point The point.
+     */
+    void set(size_t i, const Ecc_Point& point);
+
+    /**
+     * @brief Replaces a point by a finite one given by its coordinates.
+     * @param i The index.
+     * @param x The x coordinate; reduced modulo p.
+     * @param y The y coordinate; reduced modulo p.
+     */
+    void setAffine(size_t i, const BigInt& x, const BigInt& y);
+
+    /**
+     * @brief Replaces a point by a finite one given by its limbs, without reducing them.
+     *
+     * Points sharing a 64-bit word of the infinity bitmap (indices with the same i / 64) must not
+     * be set from different threads at the same time.
+     *
+     * @param i The index.
+     * @param x limbs() limbs of an x coordinate below p.
+     * @param y limbs() limbs of a y coordinate below p.
+     */
+    void setAffineLimbs(size_t i, const uint64_t* x, const uint64_t* y);
+
+    /**
+     * @brief Replaces a point by the point at infinity.
+     * @param i The index.
+     */
+    void setInfinity(size_t i);
+
+    /**
+     * @brief Checks whether a point is the point at infinity.
+     * @param i The index.
+     * @return True for the point at infinity.
+     */
+    bool isInfinity(size_t i) const { return (infinity[i / 64] >> (i % 64)) & 1; }
+
+    /**
+     * @brief Gets the limbs of an x coordinate.
+     * @param i The index.
+     * @return limbs() little-endian limbs.
+     */
+    const uint64_t* xLimbs(size_t i) const { return &xs[i * width]; }
+
+    /**
+     * @brief Gets the limbs of a y coordinate.
+     * @param i The index.
+     * @return limbs() little-endian limbs.
+     */
+    const uint64_t* yLimbs(size_t i) const { return &ys[i * width]; }
+
+    /**
+     * @brief Copies an x coordinate into a BigInt, reusing its storage.
+     * @param i The index.
+     * @param out Receives the coordinate.
+     */
+    void loadX(size_t i, BigInt& out) const;
+
+    /**
+     * @brief Copies a y coordinate into a BigInt, reusing its storage.
+     * @param i The index.
+     * @param out Receives the coordinate.
+     */
+    void loadY(size_t i, BigInt& out) const;
+
+    /**
+     * @brief Builds the Ecc_Point at an index.
+     * @param i The index.
+     * @return The point, sharing the vector's curve parameters and field backend.
+     */
+    Ecc_Point operator[](size_t i) const;
+
+    /**
+     * @brief Converts the whole vector to Ecc_Point form.
+     * @return The points.
+     */
+    std::vector<Ecc_Point> toPoints() const;
+
+    /**
+     * @brief Gets the heap memory held by the coordinate arrays and the bitmap.
+     * @return Bytes of capacity.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Gets a view of a range.
+     * @param offset The first index.
+     * @param length The number of points.
+     * @return The view.
+     * @throw std::out_of_range If the range is not inside the vector.
+     */
+    PointView view(size_t offset, size_t length) const;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    void storeCoordinate(uint64_t* out, const BigInt& v) const;
+    void loadCoordinate(const uint64_t* in, BigInt& out) const;
+
+    std::shared_ptr<const Ecc_Point> prototype; ///< Carries the curve and field shared by all points.
+    size_t width;
+    size_t count;
+    std::vector<uint64_t> xs;
+    std::vector<uint64_t> ys;
+    std::vector<uint64_t> infinity;            ///< Bit i is set when point i is the point at infinity.
+};
+
+/**
+ * @class PointView
+ * @brief A read-only range of a PointVector. The vector must outlive the view and not be resized.
+ */
+class PointView {
+public:
+    typedef PointVector::const_iterator const_iterator;
+
+    /**
+     * @brief Views a whole vector.
+     * @param points The vector.
+     */
+    PointView(const PointVector& points) : points(&points), offset(0), count(points.size()) {}
+
+    /**
+     * @brief Views a range of a vector.
+     * @param points The vector.
+     * @param offset The first index.
+     * @param length The number of points.
+     * @throw std::out_of_range If the range is not inside the vector.
+     */
+    PointView(const PointVector& points, size_t offset, size_t length);
+
+    // Accessors with the meaning of the PointVector members of the same name, indexed from the
+    // start of the view.
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t limbs() const { return points->limbs(); }
+    const CurveParameters& getCurve() const { return points->getCurve(); }
+    const FieldBackend& getField() const { return points->getField(); }
+    bool isInfinity(size_t i) const { return points->isInfinity(offset + i); }
+    const uint64_t* xLimbs(size_t i) const { return points->xLimbs(offset + i); }
+    const uint64_t* yLimbs(size_t i) const { return points->yLimbs(offset + i); }
+    void loadX(size_t i, BigInt& out) const { points->loadX(offset + i, out); }
+    void loadY(size_t i, BigInt& out) const { points->loadY(offset + i, out); }
+    Ecc_Point operator[](size_t i) const { return (*points)[offset + i]; }
+
+    /**
+     * @brief Gets a narrower view.
+     * @param first The first index, relative to this view.
+     * @param length The number of points.
+     * @return The view.
+     * @throw std::out_of_range If the range is not inside this view.
+     */
+    PointView subview(size_t first, size_t length) const;
+
+    const_iterator begin() const { return const_iterator(points, offset); }
+    const_iterator end() const { return const_iterator(points, offset + count); }
+
+private:
+    const PointVector* points;
+    size_t offset;
+    size_t count;
+};
+
+#endif // POINTS_HPP
@@ -9,14 +9,31 @@
 #define POLYNOMIAL_HPP
 
 #include "bigint.hpp"
+#include "field.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 
+/**
+ * @struct SparseTerm
+ * @brief One nonzero term coeff * x^exponent of a sparsely stored polynomial.
+ */
+struct SparseTerm {
+    size_t exponent; ///< Power of x.
+    BigInt coeff;    ///< Coefficient of the term.
+};
+
 /**
  * @class Polynomial
  * @brief A class representing a polynomial with BigInt coefficients.
  * 
  * This class allows operations on polynomials over finite fields using BigInt.
+ *
+ * Polynomials are stored either densely, one coefficient per degree, or sparsely as a sorted list of
+ * nonzero terms. The representation is chosen automatically from the density of nonzero coefficients
+ * whenever a polynomial is constructed or produced by an operation, so vanishing and selector
+ * polynomials such as x^n - 1 take O(terms) memory and the arithmetic routines below dispatch to
+ * sparse kernels whose cost depends on the number of terms rather than on the degree.
  */
 class Polynomial {
 public:
@@ -28,6 +45,35 @@ public:
      */
     Polynomial(const std::vector<std::string>& coeff_array, const std::string& modulusStr);
 
+    /**
+     * @brief Constructs a Polynomial object from BigInt coefficients without string parsing.
+     * 
+     * @param coeff_array The coefficients, lowest degree first.
+     * @param modulus The modulus of the finite field.
+     */
+    Polynomial(const std::vector<BigInt>& coeff_array, const BigInt& modulus);
+
+    /**
+     * @brief Creates a polynomial from (exponent, coefficient) terms.
+     * 
+     * Terms may appear in any order; repeated exponents are summed and coefficients are reduced modulo
+     * the modulus.
+     * 
+     * @param terms The terms of the polynomial.
+     * @param modulus The modulus of the finite field.
+     * @return The polynomial, stored sparsely unless its terms are dense.
+     */
+    static Polynomial fromTerms(const std::vector<SparseTerm>& terms, const BigInt& modulus);
+
+    /**
+     * @brief Creates the vanishing polynomial x^n - 1 of a multiplicative subgroup of order n.
+     * 
+     * @param n The order of the subgroup.
+     * @param modulus The modulus of the finite field.
+     * @return x^n - 1 as a two-term polynomial.
+     */
+    static Polynomial vanishing(size_t n, const BigInt& modulus);
+
     /**
      * @brief Prints the polynomial in a readable format.
      */
@@ -43,9 +89,76 @@ public:
     /**
      * @brief Gets the coefficients of the polynomial.
      * 
+     * A sparsely stored polynomial materializes its dense coefficients on the first call and keeps
+     * them cached, so prefer getTerms() when the polynomial may be sparse.
+     * 
      * @return Vector of BigInt representing the coefficients.
      */
-    std::vector<BigInt> getCoefficients() const;
+    const std::vector<BigInt>& getCoefficients() const;
+
+    /**
+     * @brief Gets the nonzero terms of the polynomial in increasing exponent order.
+     * 
+     * @return The (exponent, coefficient) terms.
+     */
+    std::vector<SparseTerm> getTerms() const;
+
+    /**
+     * @brief Checks whether the polynomial is currently stored sparsely.
+     * 
+     * @return True for the sparse representation.
+     */
+    bool isSparse() const;
+
+    /**
+     * @brief Counts the nonzero coefficients.
+     * 
+     * @return The number of nonzero terms.
+     */
+    size_t termCount() const;
+
+    /**
+     * @brief Evaluates the polynomial at a point.
+     * 
+     * Dense polynomials use Horner's rule in steps of x^s with s ≈ √n: each block of s coefficients
+     * is accumulated unreduced against the powers x^0 … x^(s−1), so the value is reduced about 2√n
+     * times rather than once per coefficient; short polynomials use plain Horner. Above
+     * PARALLEL_EVALUATION_LENGTH coefficients the polynomial is split Estrin-style into
+     * f(x) = sum_j f_j(x) * x^(jB), the blocks f_j are evaluated on separate threads and recombined
+     * with a final Horner pass in x^B. Sparse polynomials are evaluated term by term, raising x only
+     * across the gaps between exponents, so x^n - 1 costs a single exponentiation.
+     * 
+     * @param x The evaluation point.
+     * @param threads Number of threads for large polynomials; 0 selects the default.
+     * @return The value reduced into [0, modulus).
+     */
+    BigInt evaluate(const BigInt& x, unsigned threads = 0) const;
+
+    /**
+     * @brief Evaluates the polynomial at many points, spreading the points across threads.
+     * 
+     * Each point is evaluated as in evaluate() on a single thread.
+     * 
+     * @param points The evaluation points.
+     * @param threads Number of threads; 0 selects the default.
+     * @return The values, in the order of the points.
+     */
+    std::vector<BigInt> evaluateMany(const std::vector<BigInt>& points, unsigned threads = 0) const;
+
+    /**
+     * @brief Evaluates many polynomials at one point.
+     * 
+     * The powers of x are computed once and shared. Each polynomial then becomes a dot product with
+     * the power table whose products are accumulated unreduced, so each polynomial costs one
+     * reduction instead of one per coefficient. Polynomials are spread across threads.
+     * 
+     * @param polys The polynomials, all over the same modulus.
+     * @param x The evaluation point.
+     * @param threads Number of threads; 0 selects the default.
+     * @return The values, in the order of the polynomials.
+     * @throw std::invalid_argument If the moduli of the polynomials are not the same.
+     */
+    friend std::vector<BigInt> evaluatePolynomials(const std::vector<Polynomial>& polys, const BigInt& x, unsigned threads);
 
     /**
      * @brief Gets the modulus of the finite field.
@@ -76,7 +189,12 @@ public:
 
     /**
      * @brief Multiplies two polynomials and stores the result in a third polynomial.
-     * 
+     *
+     * Dense operands of at least KRONECKER_MIN_LENGTH coefficients are multiplied by Kronecker
+     * substitution: both are packed into single integers with padded coefficient slots, multiplied
+     * once with GMP's subquadratic mpz_mul and unpacked, which works for any modulus. Shorter and
+     * sparse operands use the direct product.
+     *
      * @param result Reference to Polynomial where the result will be stored.
      * @param a The first polynomial to multiply.
      * @param b The second polynomial to multiply.
@@ -103,10 +221,81 @@ public:
      */
     friend void dividePolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar);
 
+    /**
+     * @brief Divides a polynomial by a sparse divisor such as a vanishing polynomial.
+     * 
+     * Long division that only touches the divisor's nonzero terms, costing O(terms * (deg a - deg b)).
+     * 
+     * @param quotient Reference to Polynomial where the quotient will be stored.
+     * @param remainder Reference to Polynomial where the remainder will be stored.
+     * @param a The dividend.
+     * @param divisor The divisor.
+     * @throw std::invalid_argument If the moduli differ or the divisor is zero.
+     */
+    friend void divideBySparse(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &divisor);
+
+    /**
+     * @brief Divides one polynomial by another, giving a = quotient * b + remainder.
+     *
+     * Sparse divisors go to divideBySparse() and linear ones to divideByLinear(). When both the
+     * quotient and the divisor have at least NEWTON_DIVISION_MIN_LENGTH coefficients, the quotient is
+     * computed from the reversed polynomials as rev(a) * rev(b)^-1 mod x^(deg a - deg b + 1), with the
+     * power series inverse obtained by Newton iteration; every step is a pair of products on the
+     * multiplication path, so the division costs O(M(n)). Smaller cases use long division.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored.
+     * @param remainder Reference to Polynomial where the remainder, of degree below deg b, will be stored.
+     * @param a The dividend.
+     * @param b The divisor; leading coefficients that vanish modulo p are ignored.
+     * @throw std::invalid_argument If the moduli differ or the divisor is zero.
+     */
+    friend void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b);
+
+    /**
+     * @brief Divides a polynomial by (x - root) with Horner's scheme.
+     *
+     * This is the quotient (f(x) - f(root)) / (x - root) of a KZG opening.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored.
+     * @param remainder Receives a(root).
+     * @param a The dividend.
+     * @param root The root of the divisor.
+     */
+    friend void divideByLinear(Polynomial &quotient, BigInt &remainder, const Polynomial &a, const BigInt &root);
+
+    /// Shortest polynomial considered for sparse storage.
+    static const size_t SPARSE_MIN_LENGTH = 32;
+
+    /// A polynomial is stored sparsely when at most one in SPARSE_DENSITY_RATIO coefficients is nonzero.
+    static const size_t SPARSE_DENSITY_RATIO = 8;
+
+    /// Shortest dense polynomial whose single-point evaluation is split across threads.
+    static const size_t PARALLEL_EVALUATION_LENGTH = 4096;
+
+    /// Shortest operand length for which dense products use Kronecker substitution.
+    static const size_t KRONECKER_MIN_LENGTH = 32;
+
+    /// Shortest quotient and divisor lengths for which dividePolynomials() uses Newton inversion.
+    static const size_t NEWTON_DIVISION_MIN_LENGTH = 256;
+
 
 private:
-    std::vector<BigInt> coefficients; ///< Coefficients of the polynomial.
+    Polynomial() : length(0), sparse(false) {}
+
+    void assignDense(const std::vector<BigInt>& coeffs, const BigInt& modulus, const std::shared_ptr<const FieldBackend>& backend);
+    void assignSparse(const std::vector<SparseTerm>& nonzero, size_t slots, const BigInt& modulus,
+                      const std::shared_ptr<const FieldBackend>& backend);
+    void adaptRepresentation();
+
+    std::vector<BigInt> coefficients; ///< Coefficients of the polynomial; empty while stored sparsely.
+    std::vector<SparseTerm> terms; ///< Nonzero terms in increasing exponent order while stored sparsely.
+    size_t length; ///< Number of coefficient slots in either representation, so deg() == length - 1.
+    bool sparse; ///< Whether terms rather than coefficients hold the polynomial.
+    mutable std::shared_ptr<const std::vector<BigInt>> denseCache; ///< Dense view of a sparse polynomial.
     BigInt mod; ///< Modulus of the finite field.
+    std::shared_ptr<const FieldBackend> field; ///< Backend for mod, resolved once and shared with derived polynomials.
 };
 
+std::vector<BigInt> evaluatePolynomials(const std::vector<Polynomial>& polys, const BigInt& x, unsigned threads = 0);
+
 #endif // POLYNOMIAL_HPP
@@ -0,0 +1,237 @@
+/**
+ * @file poseidon.hpp
+ * @brief The Poseidon permutation and sponge hash over a prime field, with a transcript for
+ *        Fiat–Shamir challenges.
+ *
+ * Poseidon works natively on field elements, so hashing scalars, polynomial evaluations and Merkle
+ * nodes needs no conversion to bytes. A permutation of width t runs R_F full rounds, half before
+ * and half after R_P partial rounds. Every round adds constants, raises state elements to the power
+ * α (all of them in a full round, only the first one in a partial round) and multiplies the state
+ * by a t×t MDS matrix.
+ *
+ * Parameters are derived from the modulus and the width alone. α is the smallest odd exponent
+ * ≥ 3 with gcd(α, p − 1) = 1, which makes x ↦ x^α a permutation. The round numbers are the
+ * cheapest pair meeting the statistical, interpolation and Gröbner-basis bounds of the Poseidon
+ * paper and its 2023 revision for the requested security level, plus the reference margin of two
+ * full rounds and 7.5% more partial rounds. Round constants and the Cauchy MDS matrix are drawn
+ * from a ChaCha20 stream keyed by the SHA-256 digest of the parameter description, so anyone can
+ * regenerate them; they are not the constants of other Poseidon implementations.
+ *
+ * The Poseidon class precomputes the optimized form of the partial rounds: their round constants
+ * are folded forward so that each one adds a single constant, and the MDS matrix is factored so
+ * that each one multiplies by a sparse matrix with 2t − 1 nonzero entries. A partial round then
+ * costs one S-box and about 2t multiplications instead of t².
+ */
+
+#ifndef POSEIDON_HPP
+#define POSEIDON_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "field.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PoseidonParameters
+ * @brief A Poseidon instance in its textbook form.
+ */
+struct PoseidonParameters {
+    BigInt modulus;                                 ///< The prime p.
+    size_t width;                                   ///< State size t; the rate is t − 1.
+    unsigned long alpha;                            ///< S-box exponent.
+    size_t fullRounds;                              ///< R_F, even.
+    size_t partialRounds;                           ///< R_P.
+    std::vector<std::vector<BigInt>> roundConstants; ///< R_F + R_P rows of t constants, in round order.
+    std::vector<std::vector<BigInt>> mds;           ///< The t×t MDS matrix, row-major.
+
+    /**
+     * @brief Derives the parameters for a field.
+     * @param modulus The prime p.
+     * @param width The state size t; at least 2.
+     * @param securityBits The targeted security level in bits.
+     * @return The parameters.
+     * @throw std::invalid_argument If the width is below 2 or the modulus is below 2⁶⁴.
+     */
+    static PoseidonParameters generate(const BigInt& modulus, size_t width = 3, size_t securityBits = 128);
+};
+
+/**
+ * @class Poseidon
+ * @brief The optimized Poseidon permutation and the sponge hash built on it.
+ *
+ * The hash absorbs the inputs rate elements at a time into state positions 1..t − 1, with the
+ * capacity element at position 0 set to n·2⁶⁴ for n inputs as a domain tag, and outputs state
+ * element 1. Instances are immutable and safe to share between threads.
+ */
+class Poseidon {
+public:
+    /**
+     * @brief Precomputes the optimized round structure.
+     * @param params The parameters.
+     * @throw std::invalid_argument If the parameter dimensions are inconsistent.
+     */
+    explicit Poseidon(const PoseidonParameters& params);
+
+    /**
+     * @brief Returns the instance for a modulus and width with default parameters.
+     *
+     * Instances are cached, so repeated calls with the same arguments share one object.
+     *
+     * @param modulus The prime p.
+     * @param width The state size t.
+     * @return Shared pointer to the instance.
+     */
+    static std::shared_ptr<const Poseidon> forModulus(const BigInt& modulus, size_t width = 3);
+
+    /**
+     * @brief Gets the parameters.
+     * @return The textbook parameters the instance was built from.
+     */
+    const PoseidonParameters& parameters() const { return params; }
+
+    /**
+     * @brief Gets the field backend.
+     * @return The backend selected from p.
+     */
+    const FieldBackend& getField() const { return *field; }
+
+    /**
+     * @brief Gets the number of elements absorbed per permutation.
+     * @return t − 1.
+     */
+    size_t rate() const { return params.width - 1; }
+
+    /**
+     * @brief Applies the permutation in place.
+     * @param state t field elements in [0, p).
+     * @throw std::invalid_argument If the state does not have t elements.
+     */
+    void permute(std::vector<BigInt>& state) const;
+
+    /**
+     * @brief Hashes a sequence of field elements.
+     * @param inputs The elements; reduced modulo p.
+     * @return The digest in [0, p).
+     */
+    BigInt hash(const std::vector<BigInt>& inputs) const;
+
+    /**
+     * @brief Hashes many independent sequences in parallel.
+     * @param inputs The sequences.
+     * @param threads Number of threads; 0 selects the default.
+     * @return hash(inputs[i]) for every i.
+     */
+    std::vector<BigInt> hashBatch(const std::vector<std::vector<BigInt>>& inputs, unsigned threads = 0) const;
+
+    /**
+     * @brief Hashes one level of a Merkle tree into its parents.
+     *
+     * Parent i is the hash of nodes rate()·i .. rate()·(i + 1) − 1, the last group padded with zeros.
+     *
+     * @param nodes The level; not empty.
+     * @param threads Number of threads; 0 selects the default.
+     * @return The parent level.
+     * @throw std::invalid_argument If the level is empty.
+     */
+    std::vector<BigInt> merkleLevel(const std::vector<BigInt>& nodes, unsigned threads = 0) const;
+
+    /**
+     * @brief Computes the root of a Merkle tree of arity rate() by repeated merkleLevel() calls.
+     * @param leaves The leaves; not empty. A single leaf is hashed once.
+     * @param threads Number of threads; 0 selects the default.
+     * @return The root.
+     * @throw std::invalid_argument If there are no leaves.
+     */
+    BigInt merkleRoot(const std::vector<BigInt>& leaves, unsigned threads = 0) const;
+
+private:
+    struct SparseMatrix {
+        BigInt m00;             ///< Top-left entry.
+        std::vector<BigInt> u;  ///< Rest of the first row.
+        std::vector<BigInt> w;  ///< Rest of the first column; the lower-right block is the identity.
+    };
+
+    void sbox(BigInt& x) const;
+    void multiply(const std::vector<std::vector<BigInt>>& matrix, std::vector<BigInt>& state, std::vector<BigInt>& scratch) const;
+
+    PoseidonParameters params;
+    std::shared_ptr<const FieldBackend> field;
+    std::vector<std::vector<BigInt>> fullConstants;  ///< R_F rows; the first row after the partial rounds carries their folded constants.
+    std::vector<BigInt> partialConstants;            ///< One constant per partial round, added to state element 0.
+    std::vector<std::vector<BigInt>> preSparse;      ///< Matrix of the last full round before the partial rounds.
+    std::vector<SparseMatrix> sparse;                ///< One matrix per partial round.
+};
+
+/**
+ * @class PoseidonTranscript
+ * @brief A Fiat–Shamir transcript: a Poseidon duplex sponge that absorbs protocol messages and
+ *        squeezes challenges.
+ *
+ * Every challenge depends on the label and on everything absorbed before it, in order. Before each
+ * squeeze the sponge absorbs the padding element 1, so message sequences that differ only by
+ * trailing zeros give different challenges.
+ */
+class PoseidonTranscript {
+public:
+    /**
+     * @brief Starts a transcript over the field of a modulus, using width 3.
+     * @param modulus The prime p that challenges are drawn from.
+     * @param label Protocol name, absorbed first for domain separation.
+     */
+    PoseidonTranscript(const BigInt& modulus, const std::string& label);
+
+    /**
+     * @brief Starts a transcript on a given Poseidon instance.
+     * @param hash The instance.
+     * @param label Protocol name, absorbed first for domain separation.
+     */
+    PoseidonTranscript(std::shared_ptr<const Poseidon> hash, const std::string& label);
+
+    /**
+     * @brief Absorbs a field element.
+     * @param value The element; reduced modulo p.
+     */
+    void absorb(const BigInt& value);
+
+    /**
+     * @brief Absorbs field elements in order.
+     * @param values The elements; reduced modulo p.
+     */
+    void absorb(const std::vector<BigInt>& values);
+
+    /**
+     * @brief Absorbs a curve point.
+     *
+     * The point is absorbed as an infinity flag followed by its x and y coordinates, each split into
+     * little-endian chunks of bitSize(p) − 1 bits so that coordinates of a larger base field are
+     * absorbed without loss. The point at infinity absorbs the flag 1 and zero coordinates.
+     *
+     * @param point The point.
+     */
+    void absorb(const Ecc_Point& point);
+
+    /**
+     * @brief Squeezes a challenge.
+     * @return A field element in [0, p).
+     */
+    BigInt challenge();
+
+    /**
+     * @brief Squeezes several challenges.
+     * @param count Number of challenges.
+     * @return The challenges, in squeeze order.
+     */
+    std::vector<BigInt> challenges(size_t count);
+
+private:
+    void absorbChunks(const BigInt& value, size_t chunks);
+
+    std::shared_ptr<const Poseidon> hash;
+    std::vector<BigInt> state;
+    size_t position;                ///< Next rate position to absorb into; rate() when full.
+};
+
+#endif // POSEIDON_HPP
@@ -0,0 +1,272 @@
+/**
+ * @file prover.hpp
+ * @brief Long-running proving service with warm circuits and reference strings.
+ *
+ * A ProverService loads the KZG reference string once and keeps every registered circuit compiled.
+ * Proof jobs are queued and handled by worker threads:
+ *
+ * - jobs for the same circuit that are waiting together are taken as one batch, so one worker
+ *   handles them back to back on a warm circuit; their proofs run in parallel but share no work,
+ *   since each has its own commitment, challenge and quotient MSM;
+ * - the queue is bounded, and a job submitted while it is full is answered with ProofStatus::Busy
+ *   instead of being queued, so callers can back off;
+ * - each job may carry a deadline; a job still queued when its deadline passes is answered with
+ *   ProofStatus::DeadlineExceeded without being proved.
+ *
+ * A proof is a KZG commitment to the witness polynomial w(X) = Σ vᵢ·Xⁱ, whose coefficients are the
+ * witness values, together with an opening of w at a Fiat-Shamir point derived from the circuit
+ * name and the commitment (see proofChallenge()). A witness may therefore hold as many values as
+ * the reference string has powers of τ.
+ *
+ * Requests that name a session are proved incrementally. The session keeps the witness values and
+ * the commitment of its previous proof, and the next proof for the same circuit only adds
+ * Σ (vᵢ' − vᵢ)·τⁱ·G over the witness entries that changed. The opening still costs a division and
+ * one MSM over the whole witness, because the challenge point moves with every commitment.
+ * Proofs are identical to those of standalone requests. A session lasts until endSession() or
+ * until it is the least recently used one when a new session would exceed the session limit.
+ *
+ * serve() exposes the service on a Unix socket using the framing of the MSM cluster protocol: a
+ * 32-bit type and a 64-bit payload length, both little-endian, followed by the payload. A client
+ * sends request frames, each answered by a response frame, and end-session frames, which carry a
+ * session name and are not answered.
+ */
+
+#ifndef PROVER_HPP
+#define PROVER_HPP
+
+#include "bigint.hpp"
+#include "circuit.hpp"
+#include "ecc.hpp"
+#include "kzg.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum ProofStatus
+ * @brief Outcome of a proof job.
+ */
+enum class ProofStatus : uint8_t {
+    Ok = 0,               ///< The proof was produced.
+    Busy = 1,             ///< The queue was full; the job was not accepted.
+    DeadlineExceeded = 2, ///< The deadline passed before a worker picked the job up.
+    UnknownCircuit = 3,   ///< No circuit is registered under the requested name.
+    Failed = 4            ///< Witness generation or proving failed; see ProofResponse::error.
+};
+
+/**
+ * @struct ProofRequest
+ * @brief One proof job.
+ */
+struct ProofRequest {
+    std::string circuit;         ///< Name the circuit was registered under.
+    std::vector<BigInt> inputs;  ///< Values of the circuit's input wires.
+    uint32_t deadlineMs;         ///< Milliseconds the job may wait in the queue; 0 for no deadline.
+    std::string session;         ///< Incremental proving session; empty for a standalone proof.
+
+    ProofRequest() : deadlineMs(0) {}
+};
+
+/**
+ * @struct ProofResponse
+ * @brief The answer to a proof job. The commitment and opening are only set when status is Ok.
+ */
+struct ProofResponse {
+    ProofStatus status;     ///< The outcome.
+    std::string error;      ///< Reason for a Failed status.
+    Ecc_Point commitment;   ///< Commitment to the witness polynomial.
+    KZGOpening opening;     ///< Opening of the witness polynomial at proofChallenge().
+
+    ProofResponse() : status(ProofStatus::Failed) {}
+};
+
+/**
+ * @struct ProverStats
+ * @brief Counters of a ProverService.
+ */
+struct ProverStats {
+    uint64_t accepted; ///< Jobs that entered the queue.
+    uint64_t rejected; ///< Jobs answered with Busy.
+    uint64_t expired;  ///< Jobs answered with DeadlineExceeded.
+    uint64_t proved;   ///< Jobs that reached the prover, successfully or not.
+    uint64_t batches;  ///< Batches taken by the workers.
+    uint64_t incremental; ///< Session proofs that updated the previous commitment instead of recomputing it.
+};
+
+/**
+ * @brief Derives the evaluation point of a proof.
+ * @param circuit The circuit name.
+ * @param commitment The commitment to the witness polynomial.
+ * @param order The curve order n.
+ * @return SHA-256 of the name and the commitment, reduced modulo n.
+ */
+BigInt proofChallenge(const std::string& circuit, const Ecc_Point& commitment, const BigInt& order);
+
+/**
+ * @class ProverService
+ * @brief Queues proof jobs and proves them against cached circuits and a cached reference string.
+ */
+class ProverService {
+public:
+    /**
+     * @brief Loads the reference string. Workers are not started until start() is called.
+     * @param curve The curve of the reference string; circuits must work modulo its order n.
+     * @param srsPath A powers-of-tau file written by generatePowersOfTau().
+     * @param maxPending Maximum number of queued jobs before new ones are answered with Busy.
+     * @param maxBatch Maximum number of jobs taken as one batch.
+     * @param threads Threads used to prove a batch; 0 selects the default.
+     * @param maxSessions Maximum number of incremental sessions kept; the least recently used one
+     *        is dropped to make room for a new one.
+     * @throw std::invalid_argument If maxPending, maxBatch or maxSessions is zero.
+     * @throw std::runtime_error If the reference string cannot be read.
+     */
+    ProverService(const CurveParameters& curve, const std::string& srsPath, size_t maxPending = 64,
+                  size_t maxBatch = 16, unsigned threads = 0, size_t maxSessions = 1024);
+
+    /**
+     * @brief Stops the workers. Jobs still queued are answered with Failed.
+     */
+    ~ProverService();
+
+    /**
+     * @brief Registers a circuit, or replaces the circuit registered under the same name.
+     *
+     * Jobs already queued keep the circuit they were submitted for.
+     *
+     * @param name The circuit name used in requests.
+     * @param circuit The compiled circuit.
+     * @throw std::invalid_argument If the circuit modulus is not the curve order, or the witness
+     *        has more than maxWitnessSize() values.
+     */
+    void registerCircuit(const std::string& name, const CompiledCircuit& circuit);
+
+    /**
+     * @brief Gets the largest witness registerCircuit() accepts.
+     * @return The number of powers of τ in the reference string.
+     */
+    size_t maxWitnessSize() const;
+
+    /**
+     * @brief Starts the worker threads. Does nothing if they are already running.
+     * @param workers Number of workers, each taking one batch at a time.
+     */
+    void start(unsigned workers = 1);
+
+    /**
+     * @brief Queues a job.
+     *
+     * Busy, UnknownCircuit and stopped-service answers are returned as already-ready futures.
+     *
+     * @param request The job.
+     * @return The eventual response.
+     */
+    std::future<ProofResponse> submit(const ProofRequest& request);
+
+    /**
+     * @brief Queues a job and waits for its response.
+     * @param request The job.
+     * @return The response.
+     */
+    ProofResponse prove(const ProofRequest& request) { return submit(request).get(); }
+
+    /**
+     * @brief Serves requests on a Unix socket, one thread per connection.
+     *
+     * Each connection sends request frames and receives one response frame per request, in order.
+     * Handler threads of closed connections are joined as new connections arrive.
+     * Returns after maxConnections connections have been accepted and served, or after stop().
+     *
+     * @param socketPath The socket path; an existing file at that path is replaced.
+     * @param maxConnections Connections to serve before returning; 0 serves until stop().
+     * @throw std::runtime_error If the socket cannot be bound.
+     */
+    void serve(const std::string& socketPath, size_t maxConnections = 0);
+
+    /**
+     * @brief Drops the state of an incremental session. The next request naming it starts afresh.
+     * @param session The session name.
+     */
+    void endSession(const std::string& session);
+
+    /**
+     * @brief Stops serve() and the workers. Jobs still queued are answered with Failed.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the counters.
+     * @return A snapshot of the counters.
+     */
+    ProverStats stats() const;
+
+    /**
+     * @brief Gets the curve of the reference string.
+     * @return The curve parameters.
+     */
+    const CurveParameters& getCurve() const { return curve; }
+
+private:
+    struct Circuit;
+    struct Job;
+    struct Session;
+
+    void work();
+    ProofResponse proveJob(const Job& job);
+    ProofResponse proveSession(const Job& job);
+
+    CurveParameters curve;
+    KZGSetup setup;
+    size_t maxPending;
+    size_t maxBatch;
+    unsigned threads;
+    size_t maxSessions;
+
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    std::map<std::string, std::shared_ptr<const Circuit>> circuits;
+    std::map<std::string, std::shared_ptr<Session>> sessions;
+    std::list<std::string> recentSessions; ///< Session names, most recently used first.
+    std::deque<std::shared_ptr<Job>> queue;
+    std::vector<std::thread> workers;
+    bool stopping;
+    ProverStats counters;
+    std::atomic<int> listener;
+};
+
+/**
+ * @brief Connects to a ProverService listening on a Unix socket.
+ * @param socketPath The socket path.
+ * @return The connected descriptor; the caller closes it.
+ * @throw std::runtime_error If the connection fails.
+ */
+int connectProver(const std::string& socketPath);
+
+/**
+ * @brief Sends a job over a connection and waits for the response.
+ * @param fd A descriptor returned by connectProver().
+ * @param request The job; inputs are sent reduced modulo the curve order.
+ * @param curve The curve of the service, used to decode points.
+ * @return The response.
+ * @throw std::runtime_error If the connection fails or the service sends a malformed frame.
+ */
+ProofResponse requestProof(int fd, const ProofRequest& request, const CurveParameters& curve);
+
+/**
+ * @brief Asks the service to drop a session, as ProverService::endSession(). No response is sent.
+ * @param fd A descriptor returned by connectProver().
+ * @param session The session name.
+ * @throw std::runtime_error If the connection fails.
+ */
+void endProverSession(int fd, const std::string& session);
+
+#endif // PROVER_HPP
@@ -0,0 +1,116 @@
+/**
+ * @file serialization.hpp
+ * @brief Binary files of field elements, polynomials and point sets.
+ *
+ * Decimal strings are convenient for small examples but dominate load and save time for witness
+ * and polynomial files with millions of entries. The files written here store every element in a
+ * fixed number of bytes, little-endian, so they convert straight to and from GMP limbs with
+ * mpz_import()/mpz_export() and any element can be located without parsing the ones before it.
+ *
+ * Layout: a 24-byte header (8-byte magic, 32-bit element width in bytes, 32-bit flags, 64-bit
+ * record count, all little-endian), the modulus p at the element width, then the records. The width
+ * is the size of p rounded up to whole 64-bit limbs. Element vectors store one element per record,
+ * dense polynomials one coefficient per record (lowest degree first), sparse polynomials a 64-bit
+ * exponent followed by the coefficient, and point sets x followed by y. Point files written from a
+ * PointVector that holds points at infinity store them as (0, 0), set flag bit 2 and append a bitmap
+ * of ⌈count/64⌉ little-endian 64-bit words marking them.
+ *
+ * Writers encode in parallel chunks and stream them through a buffer. Readers map the file and
+ * decode chunks in parallel, rejecting elements that are not below p.
+ */
+
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include "bigint.hpp"
+#include "interpolation.hpp"
+#include "points.hpp"
+#include "polynomial.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes field elements to a binary file.
+ * @param path The file path; an existing file is replaced.
+ * @param values The elements; values outside [0, p) are reduced.
+ * @param modulus The modulus p.
+ * @param threads Number of encoding threads; 0 selects the default.
+ * @throw std::invalid_argument If the modulus is not positive.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writeFieldElements(const std::string& path, const std::vector<BigInt>& values, const BigInt& modulus,
+                        unsigned threads = 0);
+
+/**
+ * @brief Reads field elements written by writeFieldElements().
+ * @param path The file path.
+ * @param modulus Receives the modulus stored in the file.
+ * @param threads Number of decoding threads; 0 selects the default.
+ * @return The elements.
+ * @throw std::runtime_error If the file cannot be read, is malformed or holds an element not below p.
+ */
+std::vector<BigInt> readFieldElements(const std::string& path, BigInt& modulus, unsigned threads = 0);
+
+/**
+ * @brief Writes a polynomial to a binary file, keeping its dense or sparse representation.
+ * @param path The file path; an existing file is replaced.
+ * @param poly The polynomial.
+ * @param threads Number of encoding threads; 0 selects the default.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writePolynomial(const std::string& path, const Polynomial& poly, unsigned threads = 0);
+
+/**
+ * @brief Reads a polynomial written by writePolynomial().
+ * @param path The file path.
+ * @param threads Number of decoding threads; 0 selects the default.
+ * @return The polynomial over the stored modulus.
+ * @throw std::runtime_error If the file cannot be read or is malformed.
+ */
+Polynomial readPolynomial(const std::string& path, unsigned threads = 0);
+
+/**
+ * @brief Writes a point set to a binary file.
+ * @param path The file path; an existing file is replaced.
+ * @param points The points; coordinates outside [0, p) are reduced.
+ * @param modulus The modulus p.
+ * @param threads Number of encoding threads; 0 selects the default.
+ * @throw std::invalid_argument If the modulus is not positive.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writePoints(const std::string& path, const std::vector<Data>& points, const BigInt& modulus, unsigned threads = 0);
+
+/**
+ * @brief Reads a point set written by writePoints().
+ * @param path The file path.
+ * @param modulus Receives the modulus stored in the file.
+ * @param threads Number of decoding threads; 0 selects the default.
+ * @return The points.
+ * @throw std::runtime_error If the file cannot be read, is malformed or holds points at infinity.
+ */
+std::vector<Data> readPoints(const std::string& path, BigInt& modulus, unsigned threads = 0);
+
+/**
+ * @brief Writes a point array to a binary point file, copying the coordinate limbs directly.
+ *
+ * A file without points at infinity is identical to the one writePoints() would produce.
+ *
+ * @param path The file path; an existing file is replaced.
+ * @param points The points; a PointVector converts implicitly.
+ * @param threads Number of encoding threads; 0 selects the default.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void writePointVector(const std::string& path, const PointView& points, unsigned threads = 0);
+
+/**
+ * @brief Reads a point file into a point array without going through BigInt values.
+ * @param path The file path.
+ * @param curve The curve of the points; its prime must be the modulus stored in the file.
+ * @param threads Number of decoding threads; 0 selects the default.
+ * @return The points.
+ * @throw std::runtime_error If the file cannot be read, is malformed, belongs to another prime or
+ *        holds a coordinate not below p.
+ */
+PointVector readPointVector(const std::string& path, const CurveParameters& curve, unsigned threads = 0);
+
+#endif // SERIALIZATION_HPP
@@ -0,0 +1,74 @@
+/**
+ * @file sha256.hpp
+ * @brief SHA-256 and HMAC-SHA-256 (FIPS 180-4, RFC 2104).
+ */
+
+#ifndef SHA256_HPP
+#define SHA256_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Sha256
+ * @brief Incremental SHA-256 hasher.
+ */
+class Sha256 {
+public:
+    /**
+     * @brief Size of a digest in bytes.
+     */
+    static const size_t DIGEST_SIZE = 32;
+
+    /**
+     * @brief Creates a hasher in its initial state.
+     */
+    Sha256();
+
+    /**
+     * @brief Absorbs more input.
+     * @param data Pointer to the input bytes.
+     * @param length Number of bytes.
+     * @return Reference to this hasher.
+     */
+    Sha256& update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Absorbs more input.
+     * @param data The input bytes.
+     * @return Reference to this hasher.
+     */
+    Sha256& update(const std::string& data);
+
+    /**
+     * @brief Finishes hashing and writes the digest. The hasher must not be updated afterwards.
+     * @param digest Output buffer of DIGEST_SIZE bytes.
+     */
+    void finish(uint8_t digest[DIGEST_SIZE]);
+
+    /**
+     * @brief Hashes a byte string in one call.
+     * @param data The input bytes.
+     * @return The 32-byte digest as a string of raw bytes.
+     */
+    static std::string digest(const std::string& data);
+
+private:
+    void compress(const uint8_t block[64]);
+
+    uint32_t state[8];
+    uint8_t buffer[64];
+    size_t bufferLength;
+    uint64_t totalLength;
+};
+
+/**
+ * @brief Computes HMAC-SHA-256.
+ * @param key The MAC key.
+ * @param data The message.
+ * @return The 32-byte tag as a string of raw bytes.
+ */
+std::string hmacSha256(const std::string& key, const std::string& data);
+
+#endif // SHA256_HPP
@@ -0,0 +1,149 @@
+/**
+ * @file signature.hpp
+ * @brief ECDSA and Schnorr signatures over Ecc_Point curves, with batch verification.
+ *
+ * Messages are hashed with SHA-256 and nonces are derived deterministically (RFC 6979), so signing
+ * needs no randomness source. Batch verification folds N signatures into one multi-scalar
+ * multiplication using random 128-bit weights: if any signature is invalid, the weighted sum is
+ * non-zero except with probability about 2⁻¹²⁸.
+ */
+
+#ifndef SIGNATURE_HPP
+#define SIGNATURE_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @struct EcdsaSignature
+ * @brief An ECDSA signature (r, s) with the recovery id needed to rebuild R = k·G.
+ */
+struct EcdsaSignature {
+    BigInt r;                 ///< x(R) mod n.
+    BigInt s;                 ///< k⁻¹(z + r·d) mod n.
+    unsigned int recoveryId;  ///< Bit 0: parity of y(R). Bit 1: set if x(R) ≥ n.
+};
+
+/**
+ * @struct SchnorrSignature
+ * @brief A Schnorr signature (R, s) with s = k + e·d and e = H(R ‖ Q ‖ m).
+ */
+struct SchnorrSignature {
+    Ecc_Point R; ///< The nonce commitment k·G.
+    BigInt s;    ///< The response.
+};
+
+/**
+ * @brief Derives the public key d·G for a private key.
+ * @param curve The curve to use.
+ * @param privateKey The private scalar d in [1, n).
+ * @return The public key point.
+ * @throw std::invalid_argument If the private key is out of range.
+ */
+Ecc_Point derivePublicKey(const CurveParameters& curve, const BigInt& privateKey);
+
+/**
+ * @brief Signs a message with ECDSA (SHA-256, RFC 6979 nonce).
+ * @param curve The curve to use.
+ * @param privateKey The private scalar d in [1, n).
+ * @param message The message bytes.
+ * @return The signature, including its recovery id.
+ */
+EcdsaSignature ecdsaSign(const CurveParameters& curve, const BigInt& privateKey, const std::string& message);
+
+/**
+ * @brief Verifies an ECDSA signature.
+ * @param publicKey The signer's public key.
+ * @param message The message bytes.
+ * @param signature The signature to check.
+ * @return True if the signature is valid, false otherwise, including when a point is not on the
+ *         curve of the key.
+ */
+bool ecdsaVerify(const Ecc_Point& publicKey, const std::string& message, const EcdsaSignature& signature);
+
+/**
+ * @brief Recovers the nonce point R of an ECDSA signature from r and the recovery id.
+ * @param curve The curve the signature was made on.
+ * @param signature The signature.
+ * @param R Receives the recovered point.
+ * @return True if a matching curve point exists, false otherwise.
+ */
+bool ecdsaRecoverR(const CurveParameters& curve, const EcdsaSignature& signature, Ecc_Point& R);
+
+/**
+ * @brief Verifies many ECDSA signatures with one multi-scalar multiplication.
+ *
+ * Each R is recovered from its signature and the check Σ wᵢ(u1ᵢ·G + u2ᵢ·Qᵢ − Rᵢ) = O is
+ * performed with random weights wᵢ.
+ *
+ * @param publicKeys The public keys, all on the same curve.
+ * @param messages The messages, one per key.
+ * @param signatures The signatures, one per key.
+ * @return True if every signature is valid, false otherwise. A key or point that is not on the
+ *         curve of the first key makes the batch invalid.
+ * @throw std::invalid_argument If the input sizes differ.
+ */
+bool ecdsaBatchVerify(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                      const std::vector<EcdsaSignature>& signatures);
+
+/**
+ * @brief Verifies many ECDSA signatures and reports which ones are invalid.
+ *
+ * Starts with one batch check; when it fails, the batch is split in halves recursively until the
+ * failing signatures are isolated and checked individually.
+ *
+ * @param publicKeys The public keys, all on the same curve.
+ * @param messages The messages, one per key.
+ * @param signatures The signatures, one per key.
+ * @return One flag per signature, true if it is valid.
+ */
+std::vector<bool> ecdsaBatchVerifyEach(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                                       const std::vector<EcdsaSignature>& signatures);
+
+/**
+ * @brief Signs a message with Schnorr (SHA-256 challenge, RFC 6979 style nonce).
+ * @param curve The curve to use.
+ * @param privateKey The private scalar d in [1, n).
+ * @param message The message bytes.
+ * @return The signature.
+ */
+SchnorrSignature schnorrSign(const CurveParameters& curve, const BigInt& privateKey, const std::string& message);
+
+/**
+ * @brief Verifies a Schnorr signature by checking s·G = R + e·Q.
+ * @param publicKey The signer's public key.
+ * @param message The message bytes.
+ * @param signature The signature to check.
+ * @return True if the signature is valid, false otherwise, including when a point is not on the
+ *         curve of the key.
+ */
+bool schnorrVerify(const Ecc_Point& publicKey, const std::string& message, const SchnorrSignature& signature);
+
+/**
+ * @brief Verifies many Schnorr signatures with one multi-scalar multiplication.
+ *
+ * Checks (Σ wᵢsᵢ)·G − Σ wᵢ·Rᵢ − Σ wᵢeᵢ·Qᵢ = O with random weights wᵢ.
+ *
+ * @param publicKeys The public keys, all on the same curve.
+ * @param messages The messages, one per key.
+ * @param signatures The signatures, one per key.
+ * @return True if every signature is valid, false otherwise. A key or point that is not on the
+ *         curve of the first key makes the batch invalid.
+ * @throw std::invalid_argument If the input sizes differ.
+ */
+bool schnorrBatchVerify(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                        const std::vector<SchnorrSignature>& signatures);
+
+/**
+ * @brief Verifies many Schnorr signatures and reports which ones are invalid.
+ * @param publicKeys The public keys, all on the same curve.
+ * @param messages The messages, one per key.
+ * @param signatures The signatures, one per key.
+ * @return One flag per signature, true if it is valid.
+ */
+std::vector<bool> schnorrBatchVerifyEach(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                                         const std::vector<SchnorrSignature>& signatures);
+
+#endif // SIGNATURE_HPP
@@ -0,0 +1,167 @@
+/**
+ * @file simd.hpp
+ * @brief Batched multiplication of independent field elements with SIMD Montgomery kernels.
+ *
+ * Pointwise products over long vectors (NTT evaluations, bucket sums, constraint columns) do not
+ * depend on one another, so several of them can share one instruction stream. Each kernel runs
+ * Montgomery multiplication on a block of elements at once, one element per SIMD lane, with the
+ * limbs of the block stored limb-major so that every instruction touches the same limb of all lanes:
+ *
+ * - AVX-512 IFMA: 8 lanes, radix 2^52 (5 limbs), using the 52-bit multiply-accumulate instructions;
+ * - AVX2: 4 lanes, radix 2^28 (10 limbs), using 32x32->64-bit lane multiplies;
+ * - scalar: one element at a time, radix 2^64 (4 limbs) with 128-bit products.
+ *
+ * Accumulators are only carry-normalized once per multiplication. Inputs and outputs are plain
+ * (non-Montgomery) residues: a product is two Montgomery multiplications, first by the other operand
+ * and then by R² mod p. The kernel is picked at runtime from the instruction sets the CPU reports,
+ * and the SIMD kernels are compiled with per-function target attributes, so the library needs no
+ * global -mavx flags.
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include "bigint.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum SimdKernel
+ * @brief Montgomery multiplication kernels.
+ */
+enum class SimdKernel {
+    Auto,       ///< Best kernel supported by the running CPU.
+    Scalar,     ///< Portable 64-bit limbs.
+    Avx2,       ///< 4 lanes of 28-bit limbs.
+    Avx512Ifma  ///< 8 lanes of 52-bit limbs.
+};
+
+/**
+ * @class SimdField
+ * @brief Array-level arithmetic modulo an odd prime of at most 256 bits.
+ *
+ * Raw arrays hold each element as four little-endian 64-bit limbs, element after element, and must
+ * contain residues in [0, p). Output arrays may alias inputs.
+ */
+class SimdField {
+public:
+    /// Number of 64-bit limbs per element in the raw array interface.
+    static const size_t LIMBS = 4;
+
+    /**
+     * @brief Prepares the Montgomery constants of every kernel for a modulus.
+     * @param modulus An odd prime below 2^256.
+     * @param kernel The kernel to use; Auto picks the fastest one the CPU supports.
+     * @throw std::invalid_argument If the modulus is even or wider than 256 bits.
+     * @throw std::runtime_error If the requested kernel is not supported by this CPU.
+     */
+    explicit SimdField(const BigInt& modulus, SimdKernel kernel = SimdKernel::Auto);
+
+    /**
+     * @brief Checks whether the running CPU (and this build) can execute a kernel.
+     * @param kernel The kernel to check; Auto and Scalar are always supported.
+     * @return True if the kernel can be used.
+     */
+    static bool kernelSupported(SimdKernel kernel);
+
+    /**
+     * @brief Gets the kernel chosen for this field.
+     * @return The active kernel, never Auto.
+     */
+    SimdKernel kernel() const { return active; }
+
+    /**
+     * @brief Human readable name of the active kernel.
+     * @return "avx512-ifma", "avx2" or "scalar".
+     */
+    const char* kernelName() const;
+
+    /**
+     * @brief Computes out[i] = a[i] * b[i] mod p on raw limb arrays.
+     * @param out Output array of count elements.
+     * @param a First operand array.
+     * @param b Second operand array.
+     * @param count Number of elements.
+     */
+    void mulVec(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const;
+
+    /**
+     * @brief Computes out[i] = a[i]² mod p on raw limb arrays.
+     * @param out Output array of count elements.
+     * @param a Operand array.
+     * @param count Number of elements.
+     */
+    void sqrVec(uint64_t* out, const uint64_t* a, size_t count) const;
+
+    /**
+     * @brief Computes out[i] = a[i] + b[i] mod p on raw limb arrays.
+     * @param out Output array of count elements.
+     * @param a First operand array.
+     * @param b Second operand array.
+     * @param count Number of elements.
+     */
+    void addVec(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const;
+
+    /**
+     * @brief Computes out[i] = a[i] * b[i] mod p.
+     * @param out Receives the products; resized to the input length.
+     * @param a First operands; values outside [0, p) are reduced first.
+     * @param b Second operands.
+     * @throw std::invalid_argument If the operand vectors differ in length.
+     */
+    void mulVec(std::vector<BigInt>& out, const std::vector<BigInt>& a, const std::vector<BigInt>& b) const;
+
+    /**
+     * @brief Computes out[i] = a[i]² mod p.
+     * @param out Receives the squares; resized to the input length.
+     * @param a Operands; values outside [0, p) are reduced first.
+     */
+    void sqrVec(std::vector<BigInt>& out, const std::vector<BigInt>& a) const;
+
+    /**
+     * @brief Computes out[i] = a[i] + b[i] mod p.
+     * @param out Receives the sums; resized to the input length.
+     * @param a First operands; values outside [0, p) are reduced first.
+     * @param b Second operands.
+     * @throw std::invalid_argument If the operand vectors differ in length.
+     */
+    void addVec(std::vector<BigInt>& out, const std::vector<BigInt>& a, const std::vector<BigInt>& b) const;
+
+    /**
+     * @brief Copies reduced residues into a raw limb array.
+     * @param out Array of values.size() elements.
+     * @param values The values; those outside [0, p) are reduced first.
+     */
+    void load(uint64_t* out, const std::vector<BigInt>& values) const;
+
+    /**
+     * @brief Copies a raw limb array into BigInt values.
+     * @param out Receives count values; resized as needed.
+     * @param in The raw array.
+     * @param count Number of elements.
+     */
+    static void store(std::vector<BigInt>& out, const uint64_t* in, size_t count);
+
+    /**
+     * @brief Montgomery constants of one radix: modulus limbs, -p⁻¹ mod 2^radix and R² mod p.
+     */
+    struct Montgomery {
+        unsigned radixBits;          ///< Bits per limb.
+        size_t limbs;                ///< Limbs per element.
+        uint64_t p[10];              ///< Modulus limbs.
+        uint64_t r2[10];             ///< R² mod p, with R = 2^(radixBits * limbs).
+        uint64_t pInv;               ///< -p⁻¹ mod 2^radixBits.
+    };
+
+private:
+    void mulBlocks(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const;
+
+    BigInt modulus;
+    SimdKernel active;
+    Montgomery mont64;
+    Montgomery mont52;
+    Montgomery mont28;
+};
+
+#endif // SIMD_HPP
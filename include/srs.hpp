@@ -0,0 +1,108 @@
+/**
+ * @file srs.hpp
+ * @brief Fixed-base scalar multiplication and streaming powers-of-tau generation.
+ *
+ * A structured reference string holds τⁱ·G for i up to 2²⁰ or more. Every entry shares the base G,
+ * so the multiples of G are precomputed once into a windowed table and each τⁱ·G becomes a few
+ * dozen mixed additions with no doublings. Powers of τ are advanced incrementally in the scalar
+ * field, points are produced in chunks that share one inversion for the conversion back to affine
+ * form, and each finished chunk is appended to a binary file whose header records how many powers
+ * are complete, so an interrupted run resumes where it stopped.
+ *
+ * File layout: a 32-byte header ("SNKSRS01", uint32 coordinate width, uint32 reserved, uint64
+ * completed powers, uint64 reserved), followed by the points τ⁰·G, τ¹·G, … each stored as X ‖ Y at
+ * the coordinate width of the curve's field. Every integer in the file, header fields and
+ * coordinates alike, is little-endian, like the other formats built on io.hpp.
+ */
+
+#ifndef SRS_HPP
+#define SRS_HPP
+
+#include "bigint.hpp"
+#include "ecc.hpp"
+#include "jacobian.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @class FixedBaseTable
+ * @brief Precomputed multiples d·2^(w·j)·G of a fixed base point for window-by-window lookup.
+ */
+class FixedBaseTable {
+public:
+    /**
+     * @brief Precomputes the table for a base point.
+     * @param base The fixed base point; must be finite and carry its curve parameters.
+     * @param windowBits Window width w; the table holds ⌈log₂ n / w⌉ · (2^w − 1) affine points.
+     * @throw std::invalid_argument If the base is infinity or the window width is outside 1..16.
+     */
+    explicit FixedBaseTable(const Ecc_Point& base, unsigned windowBits = 8);
+
+    /**
+     * @brief Computes k·G without doublings, leaving the result in Jacobian coordinates.
+     * @param k The scalar; it is reduced modulo the curve order.
+     * @return k·G.
+     */
+    JacobianPoint multiplyJacobian(const BigInt& k) const;
+
+    /**
+     * @brief Computes k·G.
+     * @param k The scalar; it is reduced modulo the curve order.
+     * @return k·G in affine coordinates.
+     */
+    Ecc_Point multiply(const BigInt& k) const;
+
+    /**
+     * @brief Computes kᵢ·G for many scalars, converting each thread's results with one shared inversion.
+     * @param scalars The scalars.
+     * @param threads Number of threads; 0 selects the default.
+     * @return The affine points, in the order of the scalars.
+     */
+    std::vector<Ecc_Point> multiplyBatch(const std::vector<BigInt>& scalars, unsigned threads = 0) const;
+
+    /**
+     * @brief Gets the Jacobian arithmetic bound to the base point's curve.
+     * @return The curve arithmetic.
+     */
+    const JacobianArithmetic& getArithmetic() const { return arithmetic; }
+
+private:
+    JacobianArithmetic arithmetic;
+    BigInt order;
+    unsigned windowBits;
+    size_t windows;
+    std::vector<Ecc_Point> table; ///< Row j holds d·2^(w·j)·G for d = 1..2^w − 1.
+};
+
+/**
+ * @brief Writes τⁱ·G for i = 0..count−1 to a powers-of-tau file, resuming a previous run if present.
+ *
+ * An existing file is checked against the curve and τ (through its stored τ⁰·G and τ¹·G) and any
+ * partially written trailing point is discarded before generation continues from the last
+ * completed power. After every chunk the points are flushed to disk before the header's completed
+ * count is advanced, so the header never claims data that was not written. Calling again with a
+ * larger count extends the file.
+ *
+ * @param path The output file.
+ * @param curve The curve whose generator is used.
+ * @param tau The secret τ; must be nonzero modulo the curve order.
+ * @param count Number of powers to produce.
+ * @param chunkSize Number of points computed and written per checkpoint.
+ * @param threads Number of threads; 0 selects the default.
+ * @return Number of powers that were already complete and were skipped.
+ * @throw std::invalid_argument If τ is zero or the file belongs to a different curve or τ.
+ * @throw std::runtime_error If the file cannot be read or written.
+ */
+size_t generatePowersOfTau(const std::string& path, const CurveParameters& curve, const BigInt& tau, size_t count,
+                           size_t chunkSize = 16384, unsigned threads = 0);
+
+/**
+ * @brief Reads the completed powers from a powers-of-tau file.
+ * @param path The file written by generatePowersOfTau().
+ * @param curve The curve the points belong to.
+ * @return τⁱ·G for every completed power, lowest first.
+ * @throw std::runtime_error If the file cannot be read or is not a powers-of-tau file for this curve.
+ */
+std::vector<Ecc_Point> readPowersOfTau(const std::string& path, const CurveParameters& curve);
+
+#endif // SRS_HPP
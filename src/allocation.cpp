@@ -0,0 +1,232 @@
+#include "../include/allocation.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+// The first header word of an accounted heap block holds (scope + 1) << 56 | size, so a block is
+// charged back to its own scope and size when it is resized or freed; 0 marks a block allocated
+// while accounting was off.
+const unsigned SCOPE_SHIFT = 56;
+const uint64_t SIZE_MASK = (static_cast<uint64_t>(1) << SCOPE_SHIFT) - 1;
+
+struct ScopeCounters {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> reallocations;
+    std::atomic<uint64_t> liveBytes;
+    std::atomic<uint64_t> peakBytes;
+    std::atomic<uint64_t> totalBytes;
+    std::atomic<uint64_t> sizeClasses[ALLOCATION_SIZE_CLASSES];
+};
+
+// Zero-initialized before any constructor runs, so allocations made during static initialization
+// are safe to account.
+std::atomic<bool> accountingEnabled;
+std::atomic<uint64_t> allocationLimit;
+ScopeCounters totals;
+ScopeCounters scopes[MAX_ALLOCATION_SCOPES];
+thread_local unsigned currentScope = 0;
+
+// Never destroyed, since the exit summary runs after static destructors.
+std::mutex& scopeNamesMutex() {
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+std::vector<std::string>& scopeNames() {
+    static std::vector<std::string>* names = new std::vector<std::string>(1, "(none)");
+    return *names;
+}
+
+size_t sizeClass(size_t size) {
+    size_t c = 0;
+    while (c + 1 < ALLOCATION_SIZE_CLASSES && size > (static_cast<size_t>(32) << c)) {
+        ++c;
+    }
+    return c;
+}
+
+void raisePeak(ScopeCounters& counters, uint64_t live) {
+    uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+// Adds delta bytes to the live count of a scope and of the totals.
+void chargeBytes(unsigned scope, int64_t delta) {
+    ScopeCounters* targets[2] = { &scopes[scope], &totals };
+    for (ScopeCounters* counters : targets) {
+        uint64_t live = counters->liveBytes.fetch_add(static_cast<uint64_t>(delta), std::memory_order_relaxed) + delta;
+        if (delta > 0) {
+            counters->totalBytes.fetch_add(static_cast<uint64_t>(delta), std::memory_order_relaxed);
+            raisePeak(*counters, live);
+        }
+    }
+    uint64_t limit = allocationLimit.load(std::memory_order_relaxed);
+    if (delta > 0 && limit != 0 && totals.liveBytes.load(std::memory_order_relaxed) > limit) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(scopeNamesMutex());
+            name = scopeNames()[scope];
+        }
+        std::fprintf(stderr, "GMP: allocation limit of %llu bytes exceeded in scope %s\n",
+                     static_cast<unsigned long long>(limit), name.c_str());
+        std::abort();
+    }
+}
+
+void countEvent(unsigned scope, std::atomic<uint64_t> ScopeCounters::*counter) {
+    (scopes[scope].*counter).fetch_add(1, std::memory_order_relaxed);
+    (totals.*counter).fetch_add(1, std::memory_order_relaxed);
+}
+
+// Counts a new block in the current scope and returns its header word.
+uint64_t recordAllocation(size_t size) {
+    unsigned scope = currentScope;
+    countEvent(scope, &ScopeCounters::allocations);
+    size_t c = sizeClass(size);
+    scopes[scope].sizeClasses[c].fetch_add(1, std::memory_order_relaxed);
+    totals.sizeClasses[c].fetch_add(1, std::memory_order_relaxed);
+    chargeBytes(scope, static_cast<int64_t>(size));
+    return (static_cast<uint64_t>(scope + 1) << SCOPE_SHIFT) | size;
+}
+
+AllocationStats snapshot(const ScopeCounters& counters, const std::string& name) {
+    AllocationStats stats;
+    stats.scope = name;
+    stats.allocations = counters.allocations.load();
+    stats.frees = counters.frees.load();
+    stats.reallocations = counters.reallocations.load();
+    stats.liveBytes = counters.liveBytes.load();
+    stats.peakBytes = counters.peakBytes.load();
+    stats.totalBytes = counters.totalBytes.load();
+    for (size_t c = 0; c < ALLOCATION_SIZE_CLASSES; ++c) {
+        stats.sizeClasses[c] = counters.sizeClasses[c].load();
+    }
+    return stats;
+}
+
+void printSummaryAtExit() {
+    std::fputs(allocationSummary().c_str(), stderr);
+}
+
+// Runs with the BigInt memory functions, ahead of ordinary static initializers that allocate.
+__attribute__((constructor(101))) void enableAccountingFromEnvironment() {
+    if (std::getenv("ZKSNARKS_ALLOC_STATS") != nullptr) {
+        accountingEnabled = true;
+        std::atexit(printSummaryAtExit);
+    }
+}
+
+} // namespace
+
+uint64_t accountAllocation(size_t size) {
+    return accountingEnabled.load(std::memory_order_relaxed) ? recordAllocation(size) : 0;
+}
+
+uint64_t accountReallocation(uint64_t header, size_t newSize) {
+    if (header == 0) {
+        return accountAllocation(newSize);
+    }
+    unsigned scope = static_cast<unsigned>(header >> SCOPE_SHIFT) - 1;
+    size_t recorded = static_cast<size_t>(header & SIZE_MASK);
+    countEvent(scope, &ScopeCounters::reallocations);
+    chargeBytes(scope, static_cast<int64_t>(newSize) - static_cast<int64_t>(recorded));
+    return (static_cast<uint64_t>(scope + 1) << SCOPE_SHIFT) | newSize;
+}
+
+void accountFree(uint64_t header) {
+    if (header != 0) {
+        unsigned scope = static_cast<unsigned>(header >> SCOPE_SHIFT) - 1;
+        countEvent(scope, &ScopeCounters::frees);
+        chargeBytes(scope, -static_cast<int64_t>(header & SIZE_MASK));
+    }
+}
+
+void setAllocationAccounting(bool enabled) {
+    accountingEnabled = enabled;
+}
+
+bool allocationAccountingEnabled() {
+    return accountingEnabled;
+}
+
+void setAllocationLimit(uint64_t bytes) {
+    allocationLimit = bytes;
+}
+
+AllocationStats allocationTotals() {
+    return snapshot(totals, "(total)");
+}
+
+std::vector<AllocationStats> allocationStatsByScope() {
+    std::lock_guard<std::mutex> lock(scopeNamesMutex());
+    std::vector<AllocationStats> result;
+    for (size_t i = 0; i < scopeNames().size(); ++i) {
+        result.push_back(snapshot(scopes[i], scopeNames()[i]));
+    }
+    return result;
+}
+
+void resetAllocationPeaks() {
+    totals.peakBytes = totals.liveBytes.load();
+    for (size_t i = 0; i < MAX_ALLOCATION_SCOPES; ++i) {
+        scopes[i].peakBytes = scopes[i].liveBytes.load();
+    }
+}
+
+std::string allocationSummary() {
+    std::vector<AllocationStats> rows = allocationStatsByScope();
+    rows.insert(rows.begin(), allocationTotals());
+    std::string text = "GMP heap allocations by scope:\n";
+    char line[192];
+    std::snprintf(line, sizeof(line), "%-16s %12s %12s %12s %14s %14s %16s\n", "scope", "allocs", "frees", "reallocs",
+                  "live bytes", "peak bytes", "total bytes");
+    text += line;
+    for (const AllocationStats& row : rows) {
+        if (row.allocations == 0 && row.scope != "(total)") {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-16s %12llu %12llu %12llu %14llu %14llu %16llu\n", row.scope.c_str(),
+                      static_cast<unsigned long long>(row.allocations), static_cast<unsigned long long>(row.frees),
+                      static_cast<unsigned long long>(row.reallocations), static_cast<unsigned long long>(row.liveBytes),
+                      static_cast<unsigned long long>(row.peakBytes), static_cast<unsigned long long>(row.totalBytes));
+        text += line;
+    }
+    return text;
+}
+
+unsigned allocationScopeId(const std::string& name) {
+    std::lock_guard<std::mutex> lock(scopeNamesMutex());
+    std::vector<std::string>& names = scopeNames();
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) {
+            return static_cast<unsigned>(i);
+        }
+    }
+    if (names.size() == MAX_ALLOCATION_SCOPES) {
+        throw std::runtime_error("Too many allocation scopes.");
+    }
+    names.push_back(name);
+    return static_cast<unsigned>(names.size() - 1);
+}
+
+unsigned currentAllocationScope() {
+    return currentScope;
+}
+
+AllocationScope::AllocationScope(const std::string& name) : previous(currentScope) {
+    currentScope = allocationScopeId(name);
+}
+
+AllocationScope::AllocationScope(unsigned id) : previous(currentScope) {
+    currentScope = id < MAX_ALLOCATION_SCOPES ? id : 0;
+}
+
+AllocationScope::~AllocationScope() {
+    currentScope = previous;
+}
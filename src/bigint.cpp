@@ -1,42 +1,169 @@
+#include "../include/allocation.hpp"
 #include "../include/bigint.hpp"
-#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+
+namespace {
+
+// Every limb buffer this module hands to GMP is preceded by a tag word, so the memory functions can
+// tell an object's inline buffer (never freed, copied out on growth) from a heap block of ours.
+// Blocks without either tag were allocated by the functions installed before ours, for example by
+// a static initializer that ran first, and go back to those functions.
+const mp_limb_t INLINE_TAG = static_cast<mp_limb_t>(0x494e4c494e45ULL);     // "INLINE"
+const mp_limb_t HEAP_TAG = static_cast<mp_limb_t>(0x48454150424c4f4bULL);   // "HEAPBLOK"
+const size_t HEADER_WORDS = 2; // Keeps heap blocks 16-byte aligned.
+
+void* (*previousRealloc)(void*, size_t, size_t) = nullptr;
+void (*previousFree)(void*, size_t) = nullptr;
+
+// GMP cannot unwind a C++ exception, so allocation failures abort like its default allocator.
+void outOfMemory() {
+    std::fputs("GMP: cannot allocate memory\n", stderr);
+    std::abort();
+}
+
+void* allocateBlock(size_t size) {
+    mp_limb_t* block = static_cast<mp_limb_t*>(std::malloc(size + HEADER_WORDS * sizeof(mp_limb_t)));
+    if (block == nullptr) {
+        outOfMemory();
+    }
+    block[0] = static_cast<mp_limb_t>(accountAllocation(size));
+    block[HEADER_WORDS - 1] = HEAP_TAG;
+    return block + HEADER_WORDS;
+}
+
+void* reallocateBlock(void* ptr, size_t oldSize, size_t newSize) {
+    mp_limb_t* data = static_cast<mp_limb_t*>(ptr);
+    if (data[-1] == INLINE_TAG) {
+        void* moved = allocateBlock(newSize);
+        std::memcpy(moved, ptr, std::min(oldSize, newSize));
+        return moved;
+    }
+    if (data[-1] != HEAP_TAG) {
+        return previousRealloc(ptr, oldSize, newSize);
+    }
+    mp_limb_t* block = static_cast<mp_limb_t*>(std::realloc(data - HEADER_WORDS, newSize + HEADER_WORDS * sizeof(mp_limb_t)));
+    if (block == nullptr) {
+        outOfMemory();
+    }
+    block[0] = static_cast<mp_limb_t>(accountReallocation(block[0], newSize));
+    return block + HEADER_WORDS;
+}
+
+void freeBlock(void* ptr, size_t size) {
+    mp_limb_t* data = static_cast<mp_limb_t*>(ptr);
+    if (data[-1] == HEAP_TAG) {
+        mp_limb_t* block = data - HEADER_WORDS;
+        accountFree(block[0]);
+        std::free(block);
+    } else if (data[-1] != INLINE_TAG) {
+        previousFree(ptr, size);
+    }
+}
+
+// Installed ahead of ordinary static initializers, so few GMP blocks predate the tagged allocator;
+// the ones that do are released through the functions captured here.
+__attribute__((constructor(101))) void installMemoryFunctions() {
+    mp_get_memory_functions(nullptr, &previousRealloc, &previousFree);
+    mp_set_memory_functions(allocateBlock, reallocateBlock, freeBlock);
+}
+
+} // namespace
+
+void BigInt::initInline() {
+    inlineLimbs[0] = INLINE_TAG;
+    value->_mp_alloc = BIGINT_INLINE_LIMBS;
+    value->_mp_size = 0;
+    value->_mp_d = inlineLimbs + 1;
+}
+
+// Moves a heap value that fits again back into the inline buffer.
+void BigInt::demote() {
+    int size = value->_mp_size < 0 ? -value->_mp_size : value->_mp_size;
+    if (size > BIGINT_INLINE_LIMBS) {
+        return;
+    }
+    std::memcpy(inlineLimbs + 1, value->_mp_d, size * sizeof(mp_limb_t));
+    freeBlock(value->_mp_d, value->_mp_alloc * sizeof(mp_limb_t));
+    value->_mp_alloc = BIGINT_INLINE_LIMBS;
+    value->_mp_d = inlineLimbs + 1;
+}
 
 // Default Constructor
 BigInt::BigInt() {
-    mpz_init(value);
+    initInline();
 }
 
 // Construct from unsigned long int
 BigInt::BigInt(unsigned long int val) {
-    mpz_init_set_ui(value, val);
+    initInline();
+    mpz_set_ui(value, val);
 }
 
 // Construct from signed long int
 BigInt::BigInt(signed long int val) {
-    mpz_init_set_si(value, val);
+    initInline();
+    mpz_set_si(value, val);
 }
 
 // Construct from string
 BigInt::BigInt(const std::string &val, int base) {
-    if (mpz_init_set_str(value, val.c_str(), base) == -1) {
+    initInline();
+    if (mpz_set_str(value, val.c_str(), base) == -1) {
+        freeBlock(value->_mp_d, value->_mp_alloc * sizeof(mp_limb_t));
         throw std::invalid_argument("Invalid number string.");
     }
+    settle();
 }
 
 // Copy Constructor
 BigInt::BigInt(const BigInt &other) {
-    mpz_init_set(value, other.value);
+    initInline();
+    mpz_set(value, other.value);
 }
 
 // Construct from mpz_t
 BigInt::BigInt(mpz_t bi) {
-    mpz_init_set(value, bi);
+    initInline();
+    mpz_set(value, bi);
 }
 
 // Destructor
 BigInt::~BigInt() {
-    mpz_clear(value);
+    if (!isInline()) {
+        freeBlock(value->_mp_d, value->_mp_alloc * sizeof(mp_limb_t));
+    }
+}
+
+void BigInt::swap(BigInt& other) {
+    if (this == &other) {
+        return;
+    }
+    if (!isInline() && !other.isInline()) {
+        mpz_swap(value, other.value);
+        return;
+    }
+    std::swap(value->_mp_size, other.value->_mp_size);
+    std::swap(value->_mp_alloc, other.value->_mp_alloc);
+    std::swap(value->_mp_d, other.value->_mp_d);
+    // Inline buffers stay with their owners: swap their contents and point back at them.
+    bool mineWasInline = other.value->_mp_d == inlineLimbs + 1;
+    bool theirsWasInline = value->_mp_d == other.inlineLimbs + 1;
+    if (mineWasInline && theirsWasInline) {
+        std::swap_ranges(inlineLimbs + 1, inlineLimbs + 1 + BIGINT_INLINE_LIMBS, other.inlineLimbs + 1);
+        value->_mp_d = inlineLimbs + 1;
+        other.value->_mp_d = other.inlineLimbs + 1;
+    } else if (mineWasInline) {
+        std::memcpy(other.inlineLimbs + 1, inlineLimbs + 1, BIGINT_INLINE_LIMBS * sizeof(mp_limb_t));
+        other.value->_mp_d = other.inlineLimbs + 1;
+    } else {
+        std::memcpy(inlineLimbs + 1, other.inlineLimbs + 1, BIGINT_INLINE_LIMBS * sizeof(mp_limb_t));
+        value->_mp_d = inlineLimbs + 1;
+    }
 }
 
 // Arithmetic Operations
@@ -73,31 +200,37 @@ BigInt BigInt::operator%(const BigInt &other) const {
 // Assignment Operations
 BigInt& BigInt::operator=(const BigInt &other) {
     mpz_set(value, other.value);
+    settle();
     return *this;
 }
 
 BigInt& BigInt::operator+=(const BigInt &other) {
     mpz_add(value, value, other.value);
+    settle();
     return *this;
 }
 
 BigInt& BigInt::operator-=(const BigInt &other) {
     mpz_sub(value, value, other.value);
+    settle();
     return *this;
 }
 
 BigInt& BigInt::operator*=(const BigInt &other) {
     mpz_mul(value, value, other.value);
+    settle();
     return *this;
 }
 
 BigInt& BigInt::operator/=(const BigInt &other) {
     mpz_fdiv_q(value, value, other.value);
+    settle();
     return *this;
 }
 
 BigInt& BigInt::operator%=(const BigInt &other) {
     mpz_mod(value, value, other.value);
+    settle();
     return *this;
 }
 
@@ -130,7 +263,9 @@ bool BigInt::operator>=(const BigInt &other) const {
 std::string BigInt::toString(int base) const {
     char* str = mpz_get_str(nullptr, base, value);
     std::string result(str);
-    free(str);
+    void (*freeFunction)(void*, size_t);
+    mp_get_memory_functions(nullptr, nullptr, &freeFunction);
+    freeFunction(str, result.size() + 1);
     return result;
 }
 
@@ -164,6 +299,20 @@ BigInt BigInt::modInverse(const BigInt& modulus) const {
     }
 }
 
+BigInt BigInt::powm(const BigInt& exponent, const BigInt& modulus) const {
+    if (modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be nonzero.");
+    }
+    BigInt result;
+    if (exponent.isNegative()) {
+        BigInt positive = exponent;
+        positive.negate();
+        mpz_powm(result.value, modInverse(modulus).value, positive.value, modulus.value);
+    } else {
+        mpz_powm(result.value, value, exponent.value, modulus.value);
+    }
+    return result;
+}
 
 // Primality Testing
 int BigInt::isPrime(int provable) const {
@@ -224,4 +373,13 @@ void BigInt::printAbsolute() const {
     mpz_abs(absValue, value);
     mpz_out_str(stdout, 10, absValue);
     mpz_clear(absValue);
-}
\ No newline at end of file
+}
+
+// Raw GMP Access
+mpz_srcptr BigInt::get_mpz_t() const {
+    return value;
+}
+
+mpz_ptr BigInt::get_mpz_t() {
+    return value;
+}
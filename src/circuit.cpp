@@ -0,0 +1,308 @@
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/circuit.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+const size_t NONE = std::numeric_limits<size_t>::max();
+
+// Components are packed into one segment until it holds at least this many instructions.
+const size_t MIN_SEGMENT_INSTRUCTIONS = 1024;
+
+size_t findRoot(std::vector<size_t>& parent, size_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+// Builder
+CircuitBuilder::CircuitBuilder(const BigInt& modulus) : modulus(modulus), inputCount(0) {}
+
+Wire CircuitBuilder::push(const Node& node) {
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+void CircuitBuilder::checkWire(Wire wire) const {
+    if (wire >= nodes.size()) {
+        throw std::invalid_argument("Wire does not exist in this circuit.");
+    }
+}
+
+Wire CircuitBuilder::input() {
+    Node node = { OpCode::Input, 0, 0, inputCount++, true };
+    return push(node);
+}
+
+Wire CircuitBuilder::constant(const BigInt& value) {
+    constants.push_back(value % modulus);
+    Node node = { OpCode::Const, 0, 0, constants.size() - 1, false };
+    return push(node);
+}
+
+Wire CircuitBuilder::add(Wire a, Wire b) {
+    checkWire(a);
+    checkWire(b);
+    Node node = { OpCode::Add, a, b, 0, false };
+    return push(node);
+}
+
+Wire CircuitBuilder::mul(Wire a, Wire b) {
+    checkWire(a);
+    checkWire(b);
+    Node node = { OpCode::Mul, a, b, 0, true };
+    return push(node);
+}
+
+Wire CircuitBuilder::hint(const std::vector<Wire>& args, const HintFunction& function) {
+    for (Wire arg : args) {
+        checkWire(arg);
+    }
+    hints.push_back(function);
+    hintInputs.push_back(args);
+    Node node = { OpCode::Hint, 0, 0, hints.size() - 1, true };
+    return push(node);
+}
+
+void CircuitBuilder::exportWire(Wire wire) {
+    checkWire(wire);
+    nodes[wire].witness = true;
+}
+
+size_t CircuitBuilder::witnessIndex(Wire wire) const {
+    checkWire(wire);
+    if (!nodes[wire].witness) {
+        throw std::invalid_argument("Wire is not part of the witness.");
+    }
+    size_t index = 0;
+    for (Wire i = 0; i < wire; ++i) {
+        if (nodes[i].witness) {
+            ++index;
+        }
+    }
+    return index;
+}
+
+CompiledCircuit CircuitBuilder::compile() const {
+    CompiledCircuit out;
+    out.modulus = modulus;
+    out.field = FieldBackend::forModulus(modulus);
+    out.constants = constants;
+    out.hints = hints;
+    out.inputCount = inputCount;
+
+    const size_t n = nodes.size();
+    std::vector<size_t> slot(n, NONE);
+    size_t witnessCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (nodes[i].witness) {
+            slot[i] = witnessCount++;
+        }
+    }
+    out.witnessCount = witnessCount;
+
+    // Operands of every node. Constants never join components: every component that reads one
+    // loads it into its own register, even an exported constant, whose witness slot is written by
+    // another segment that may run concurrently.
+    auto operandsOf = [this](size_t i) {
+        const Node& node = nodes[i];
+        std::vector<Wire> ops;
+        if (node.op == OpCode::Add || node.op == OpCode::Mul) {
+            ops.push_back(node.lhs);
+            if (node.rhs != node.lhs) {
+                ops.push_back(node.rhs);
+            }
+        } else if (node.op == OpCode::Hint) {
+            for (Wire arg : hintInputs[node.aux]) {
+                if (std::find(ops.begin(), ops.end(), arg) == ops.end()) {
+                    ops.push_back(arg);
+                }
+            }
+        }
+        return ops;
+    };
+
+    std::vector<size_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (Wire op : operandsOf(i)) {
+            if (nodes[op].op != OpCode::Const) {
+                parent[findRoot(parent, i)] = findRoot(parent, op);
+            }
+        }
+    }
+
+    std::vector<size_t> componentOfRoot(n, NONE);
+    std::vector<std::vector<Wire>> components;
+    for (size_t i = 0; i < n; ++i) {
+        if (nodes[i].op == OpCode::Const && !nodes[i].witness) {
+            continue;
+        }
+        size_t root = nodes[i].op == OpCode::Const ? i : findRoot(parent, i);
+        if (componentOfRoot[root] == NONE) {
+            componentOfRoot[root] = components.size();
+            components.push_back(std::vector<Wire>());
+        }
+        components[componentOfRoot[root]].push_back(i);
+    }
+
+    std::vector<size_t> lastUse(n, NONE);
+    std::vector<uint32_t> location(n, 0);
+    std::vector<size_t> loadedIn(n, NONE);
+    size_t totalScratch = 0;
+
+    size_t segmentBegin = 0;
+    size_t scratchBase = witnessCount;
+    size_t scratchCount = 0;
+    std::vector<uint32_t> freeList;
+
+    for (size_t c = 0; c < components.size(); ++c) {
+        const std::vector<Wire>& members = components[c];
+        for (size_t k = 0; k < members.size(); ++k) {
+            for (Wire op : operandsOf(members[k])) {
+                lastUse[op] = k;
+            }
+        }
+
+        auto allocate = [&]() -> uint32_t {
+            if (!freeList.empty()) {
+                uint32_t reg = freeList.back();
+                freeList.pop_back();
+                return reg;
+            }
+            return static_cast<uint32_t>(scratchBase + scratchCount++);
+        };
+
+        for (size_t k = 0; k < members.size(); ++k) {
+            Wire i = members[k];
+            const Node& node = nodes[i];
+            std::vector<Wire> ops = operandsOf(i);
+            bool dead = slot[i] == NONE && lastUse[i] == NONE;
+
+            if (!dead) {
+                for (Wire op : ops) {
+                    if (nodes[op].op == OpCode::Const && loadedIn[op] != c) {
+                        uint32_t reg = allocate();
+                        Instruction load = { OpCode::Const, reg, static_cast<uint32_t>(nodes[op].aux), 0 };
+                        out.code.push_back(load);
+                        location[op] = reg;
+                        loadedIn[op] = c;
+                    }
+                }
+            }
+
+            Instruction ins = { node.op, 0, 0, 0 };
+            switch (node.op) {
+                case OpCode::Input:
+                case OpCode::Const:
+                    ins.lhs = static_cast<uint32_t>(node.aux);
+                    break;
+                case OpCode::Add:
+                case OpCode::Mul:
+                    ins.lhs = location[node.lhs];
+                    ins.rhs = location[node.rhs];
+                    break;
+                case OpCode::Hint: {
+                    CompiledCircuit::HintCall call = { node.aux, out.hintArgs.size(), hintInputs[node.aux].size() };
+                    for (Wire arg : hintInputs[node.aux]) {
+                        out.hintArgs.push_back(location[arg]);
+                    }
+                    ins.lhs = static_cast<uint32_t>(out.hintCalls.size());
+                    out.hintCalls.push_back(call);
+                    break;
+                }
+            }
+
+            // Operands whose last use is this instruction hand their scratch registers back.
+            for (Wire op : ops) {
+                bool scratch = nodes[op].op == OpCode::Const ? loadedIn[op] == c : slot[op] == NONE;
+                if (lastUse[op] == k && scratch) {
+                    freeList.push_back(location[op]);
+                }
+            }
+            if (dead) {
+                continue;
+            }
+
+            location[i] = slot[i] != NONE ? static_cast<uint32_t>(slot[i]) : allocate();
+            ins.dst = location[i];
+            out.code.push_back(ins);
+        }
+
+        bool lastComponent = c + 1 == components.size();
+        if (out.code.size() - segmentBegin >= MIN_SEGMENT_INSTRUCTIONS || lastComponent) {
+            if (out.code.size() > segmentBegin) {
+                CompiledCircuit::Segment segment = { segmentBegin, out.code.size() };
+                out.segments.push_back(segment);
+            }
+            segmentBegin = out.code.size();
+            totalScratch += scratchCount;
+            scratchBase = witnessCount + totalScratch;
+            scratchCount = 0;
+            freeList.clear();
+        }
+    }
+    out.registers = witnessCount + totalScratch;
+    return out;
+}
+
+// Interpreter
+void CompiledCircuit::runSegment(const Segment& segment, const std::vector<BigInt>& inputs, std::vector<BigInt>& regs) const {
+    mpz_srcptr p = modulus.get_mpz_t();
+    std::vector<BigInt> args;
+    for (size_t pc = segment.begin; pc < segment.end; ++pc) {
+        const Instruction& ins = code[pc];
+        BigInt& dst = regs[ins.dst];
+        switch (ins.op) {
+            case OpCode::Input:
+                mpz_mod(dst.get_mpz_t(), inputs[ins.lhs].get_mpz_t(), p);
+                break;
+            case OpCode::Const:
+                mpz_set(dst.get_mpz_t(), constants[ins.lhs].get_mpz_t());
+                break;
+            case OpCode::Add:
+                mpz_add(dst.get_mpz_t(), regs[ins.lhs].get_mpz_t(), regs[ins.rhs].get_mpz_t());
+                if (mpz_cmp(dst.get_mpz_t(), p) >= 0) {
+                    mpz_sub(dst.get_mpz_t(), dst.get_mpz_t(), p);
+                }
+                break;
+            case OpCode::Mul:
+                mpz_mul(dst.get_mpz_t(), regs[ins.lhs].get_mpz_t(), regs[ins.rhs].get_mpz_t());
+                field->reduce(dst);
+                break;
+            case OpCode::Hint: {
+                const HintCall& call = hintCalls[ins.lhs];
+                args.resize(call.argCount);
+                for (size_t a = 0; a < call.argCount; ++a) {
+                    args[a] = regs[hintArgs[call.argsOffset + a]];
+                }
+                dst = hints[call.function](args, modulus);
+                field->reduce(dst);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<BigInt> CompiledCircuit::evaluate(const std::vector<BigInt>& inputs, unsigned threads) const {
+    static const unsigned scope = allocationScopeId("circuit");
+    AllocationScope allocations(scope);
+    if (inputs.size() != inputCount) {
+        throw std::invalid_argument("Number of inputs does not match the circuit.");
+    }
+    std::vector<BigInt> regs(registers);
+    parallelFor(segments.size(), [&](size_t s) {
+        runSegment(segments[s], inputs, regs);
+    }, threads);
+    regs.resize(witnessCount);
+    return regs;
+}
@@ -0,0 +1,463 @@
+#include "../include/bigint.hpp"
+#include "../include/cluster.hpp"
+#include "../include/framing.hpp"
+#include "../include/io.hpp"
+#include "../include/jacobian.hpp"
+#include "../include/msm.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const char MSM_MAGIC[8] = { 'S', 'N', 'K', 'M', 'S', 'M', '0', '1' };
+const size_t MSM_HEADER_SIZE = 32;
+const size_t CURVE_FIELDS = 5; // a, b, p, Gx, Gy at coordinate width, then n at scalar width.
+
+const uint32_t FRAME_SHARD = 1;
+const uint32_t FRAME_WINDOWS = 2;
+const uint32_t FRAME_ERROR = 3;
+const char* const MSM_FILE = "MSM input file";
+
+// Pippenger windows needed to cover every scalar below the curve order.
+uint32_t windowCount(const BigInt& order, uint32_t windowBits) {
+    return static_cast<uint32_t>((order.bitSize() + windowBits - 1) / windowBits);
+}
+
+// Extracts bits [offset, offset + width) of a non-negative scalar.
+unsigned long windowDigit(const BigInt& k, size_t offset, int width) {
+    unsigned long digit = 0;
+    for (int b = width - 1; b >= 0; --b) {
+        digit = (digit << 1) | mpz_tstbit(k.get_mpz_t(), offset + b);
+    }
+    return digit;
+}
+
+// Fixed-width big-endian encoding of a non-negative value below 2^(8·width).
+void storeBig(unsigned char* out, const BigInt& v, size_t width) {
+    if (v.isNegative() || v.bitSize() > 8 * width) {
+        throw std::invalid_argument("Value does not fit in a " + std::to_string(width) + "-byte field.");
+    }
+    size_t count = 0;
+    std::memset(out, 0, width);
+    std::vector<unsigned char> raw(width + 1);
+    mpz_export(raw.data(), &count, 1, 1, 1, 0, v.get_mpz_t());
+    std::memcpy(out + width - count, raw.data(), count);
+}
+
+// The representative of v in [0, modulus).
+BigInt reduced(const BigInt& v, const BigInt& modulus) {
+    if (!v.isNegative() && v < modulus) {
+        return v;
+    }
+    BigInt r = v % modulus;
+    if (r.isNegative()) {
+        r += modulus;
+    }
+    return r;
+}
+
+BigInt loadBig(const unsigned char* in, size_t width) {
+    BigInt result;
+    mpz_import(result.get_mpz_t(), width, 1, 1, 1, 0, in);
+    return result;
+}
+
+// Coordinates are stored reduced modulo the field prime p of the file.
+void storePoint(unsigned char* out, const Ecc_Point& point, const BigInt& p, size_t width) {
+    out[0] = point.isInfinity ? 1 : 0;
+    storeBig(out + 1, point.isInfinity ? BigInt() : reduced(point.getX(), p), width);
+    storeBig(out + 1 + width, point.isInfinity ? BigInt() : reduced(point.getY(), p), width);
+}
+
+Ecc_Point loadPoint(const unsigned char* in, size_t width, const CurveParameters& curve) {
+    if (in[0] != 0) {
+        return Ecc_Point();
+    }
+    return Ecc_Point(loadBig(in + 1, width), loadBig(in + 1 + width, width), curve);
+}
+
+// Layout of an input file, as read from its header.
+struct InputLayout {
+    size_t width;
+    size_t scalarWidth;
+    uint64_t count;
+    CurveParameters curve;
+
+    size_t recordSize() const { return 1 + 2 * width + scalarWidth; }
+    size_t recordsOffset() const { return MSM_HEADER_SIZE + CURVE_FIELDS * width + scalarWidth; }
+};
+
+InputLayout readLayout(int fd) {
+    struct stat info;
+    unsigned char header[MSM_HEADER_SIZE];
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < MSM_HEADER_SIZE) {
+        throw std::runtime_error("File is not an MSM input file.");
+    }
+    readAt(fd, header, MSM_HEADER_SIZE, 0, MSM_FILE);
+    InputLayout layout;
+    layout.width = loadLE(header + 8, 4);
+    layout.scalarWidth = loadLE(header + 12, 4);
+    layout.count = loadLE(header + 16, 8);
+    if (std::memcmp(header, MSM_MAGIC, sizeof(MSM_MAGIC)) != 0 || layout.width == 0 || layout.scalarWidth == 0 ||
+        static_cast<uint64_t>(info.st_size) != layout.recordsOffset() + layout.count * layout.recordSize()) {
+        throw std::runtime_error("File is not an MSM input file.");
+    }
+
+    std::vector<unsigned char> fields(CURVE_FIELDS * layout.width + layout.scalarWidth);
+    readAt(fd, fields.data(), fields.size(), MSM_HEADER_SIZE, MSM_FILE);
+    BigInt* targets[CURVE_FIELDS] = { &layout.curve.a, &layout.curve.b, &layout.curve.p, &layout.curve.Gx, &layout.curve.Gy };
+    for (size_t i = 0; i < CURVE_FIELDS; ++i) {
+        *targets[i] = loadBig(&fields[i * layout.width], layout.width);
+    }
+    layout.curve.n = loadBig(&fields[CURVE_FIELDS * layout.width], layout.scalarWidth);
+    return layout;
+}
+
+std::vector<unsigned char> encodeShard(const MsmShard& shard) {
+    std::vector<unsigned char> payload(32 + shard.path.size());
+    storeLE(&payload[0], shard.pointBegin, 8);
+    storeLE(&payload[8], shard.pointEnd, 8);
+    storeLE(&payload[16], shard.windowBits, 4);
+    storeLE(&payload[20], shard.windowBegin, 4);
+    storeLE(&payload[24], shard.windowEnd, 4);
+    storeLE(&payload[28], shard.path.size(), 4);
+    std::memcpy(&payload[32], shard.path.data(), shard.path.size());
+    return payload;
+}
+
+MsmShard decodeShard(const std::vector<unsigned char>& payload) {
+    if (payload.size() < 32 || payload.size() != 32 + loadLE(&payload[28], 4)) {
+        throw std::invalid_argument("Malformed MSM shard request.");
+    }
+    MsmShard shard;
+    shard.pointBegin = loadLE(&payload[0], 8);
+    shard.pointEnd = loadLE(&payload[8], 8);
+    shard.windowBits = static_cast<uint32_t>(loadLE(&payload[16], 4));
+    shard.windowBegin = static_cast<uint32_t>(loadLE(&payload[20], 4));
+    shard.windowEnd = static_cast<uint32_t>(loadLE(&payload[24], 4));
+    shard.path.assign(payload.begin() + 32, payload.end());
+    return shard;
+}
+
+std::mutex spawnedMutex;
+std::vector<int> spawnedFds; // Coordinator ends of local workers; closed in every new child.
+
+} // namespace
+
+void writeMsmInput(const std::string& path, const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars) {
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars must be the same.");
+    }
+    const Ecc_Point* reference = nullptr;
+    for (const Ecc_Point& point : points) {
+        if (!point.isInfinity) {
+            reference = &point;
+            break;
+        }
+    }
+    if (reference == nullptr) {
+        throw std::invalid_argument("MSM input needs at least one finite point to identify the curve.");
+    }
+    const CurveParameters& curve = reference->getCurveParameters();
+
+    InputLayout layout;
+    layout.width = (curve.p.bitSize() + 7) / 8;
+    layout.scalarWidth = (curve.n.bitSize() + 7) / 8;
+    layout.count = points.size();
+
+    std::vector<unsigned char> buffer(layout.recordsOffset() + layout.count * layout.recordSize(), 0);
+    std::memcpy(&buffer[0], MSM_MAGIC, sizeof(MSM_MAGIC));
+    storeLE(&buffer[8], layout.width, 4);
+    storeLE(&buffer[12], layout.scalarWidth, 4);
+    storeLE(&buffer[16], layout.count, 8);
+    const BigInt* fields[CURVE_FIELDS] = { &curve.a, &curve.b, &curve.p, &curve.Gx, &curve.Gy };
+    for (size_t i = 0; i < CURVE_FIELDS; ++i) {
+        BigInt value = i == 2 ? curve.p : reduced(*fields[i], curve.p);
+        storeBig(&buffer[MSM_HEADER_SIZE + i * layout.width], value, layout.width);
+    }
+    storeBig(&buffer[MSM_HEADER_SIZE + CURVE_FIELDS * layout.width], curve.n, layout.scalarWidth);
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        unsigned char* record = &buffer[layout.recordsOffset() + i * layout.recordSize()];
+        storePoint(record, points[i], curve.p, layout.width);
+        storeBig(record + 1 + 2 * layout.width, reduced(scalars[i], curve.n), layout.scalarWidth);
+    }
+
+    FileHandle file(path, O_WRONLY | O_CREAT | O_TRUNC, MSM_FILE);
+    writeAt(file.get(), buffer.data(), buffer.size(), 0, MSM_FILE);
+}
+
+std::vector<Ecc_Point> computeMsmShard(const MsmShard& shard, unsigned threads) {
+    FileHandle file(shard.path, O_RDONLY, MSM_FILE);
+    InputLayout layout = readLayout(file.get());
+    if (shard.windowBits == 0 || shard.windowBits > 16) {
+        throw std::invalid_argument("Window width must be between 1 and 16 bits.");
+    }
+    if (shard.pointBegin > shard.pointEnd || shard.pointEnd > layout.count || shard.windowBegin > shard.windowEnd ||
+        shard.windowEnd > windowCount(layout.curve.n, shard.windowBits)) {
+        throw std::invalid_argument("Shard range lies outside the MSM input.");
+    }
+
+    size_t terms = shard.pointEnd - shard.pointBegin;
+    std::vector<unsigned char> records(terms * layout.recordSize());
+    readAt(file.get(), records.data(), records.size(), layout.recordsOffset() + shard.pointBegin * layout.recordSize(),
+           MSM_FILE);
+    std::vector<Ecc_Point> bases;
+    std::vector<BigInt> ks;
+    for (size_t i = 0; i < terms; ++i) {
+        const unsigned char* record = &records[i * layout.recordSize()];
+        BigInt k = loadBig(record + 1 + 2 * layout.width, layout.scalarWidth);
+        if (record[0] == 0 && !k.isZero()) {
+            bases.push_back(loadPoint(record, layout.width, layout.curve));
+            ks.push_back(k);
+        }
+    }
+
+    JacobianArithmetic arithmetic(Ecc_Point(layout.curve.Gx, layout.curve.Gy, layout.curve));
+    const int c = static_cast<int>(shard.windowBits);
+    const size_t bucketCount = (static_cast<size_t>(1) << c) - 1;
+    std::vector<JacobianPoint> sums(shard.windowEnd - shard.windowBegin);
+    parallelFor(sums.size(), [&](size_t index) {
+        size_t w = shard.windowBegin + index;
+        std::vector<JacobianPoint> buckets(bucketCount);
+        for (size_t i = 0; i < bases.size(); ++i) {
+            unsigned long digit = windowDigit(ks[i], w * c, c);
+            if (digit != 0) {
+                buckets[digit - 1] = arithmetic.addMixed(buckets[digit - 1], bases[i]);
+            }
+        }
+        JacobianPoint running;
+        JacobianPoint windowSum;
+        for (size_t j = bucketCount; j-- > 0;) {
+            running = arithmetic.add(running, buckets[j]);
+            windowSum = arithmetic.add(windowSum, running);
+        }
+        sums[index] = windowSum;
+    }, threads);
+    return arithmetic.toAffineBatch(sums);
+}
+
+void serveMsmWorker(int inFd, int outFd) {
+    uint32_t type = 0;
+    std::vector<unsigned char> payload;
+    while (readFrame(inFd, type, payload)) {
+        if (type != FRAME_SHARD) {
+            return;
+        }
+        std::vector<unsigned char> reply;
+        try {
+            MsmShard shard = decodeShard(payload);
+            std::vector<Ecc_Point> sums = computeMsmShard(shard);
+            // Replies whose windows are all infinity carry no coordinates.
+            size_t width = 0;
+            BigInt p;
+            for (const Ecc_Point& sum : sums) {
+                if (!sum.isInfinity) {
+                    p = sum.getP();
+                    width = (p.bitSize() + 7) / 8;
+                    break;
+                }
+            }
+            reply.assign(8 + sums.size() * (1 + 2 * width), 0);
+            storeLE(&reply[0], width, 4);
+            storeLE(&reply[4], sums.size(), 4);
+            for (size_t i = 0; i < sums.size(); ++i) {
+                storePoint(&reply[8 + i * (1 + 2 * width)], sums[i], p, width);
+            }
+            writeFrame(outFd, FRAME_WINDOWS, reply);
+        } catch (const std::exception& e) {
+            std::string message = e.what();
+            writeFrame(outFd, FRAME_ERROR, std::vector<unsigned char>(message.begin(), message.end()));
+        }
+    }
+}
+
+pid_t spawnLocalMsmWorker(int& fd) {
+    std::lock_guard<std::mutex> lock(spawnedMutex);
+    int ends[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+        throw std::runtime_error(std::string("Cannot create worker socketpair: ") + std::strerror(errno));
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(ends[0]);
+        close(ends[1]);
+        throw std::runtime_error(std::string("Cannot fork MSM worker: ") + std::strerror(errno));
+    }
+    if (pid == 0) {
+        // Earlier workers must see EOF when the coordinator closes them, so the child drops its copies.
+        close(ends[0]);
+        for (int other : spawnedFds) {
+            close(other);
+        }
+        try {
+            serveMsmWorker(ends[1], ends[1]);
+        } catch (...) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(ends[1]);
+    spawnedFds.push_back(ends[0]);
+    fd = ends[0];
+    return pid;
+}
+
+void stopLocalMsmWorker(pid_t pid, int fd) {
+    {
+        std::lock_guard<std::mutex> lock(spawnedMutex);
+        spawnedFds.erase(std::remove(spawnedFds.begin(), spawnedFds.end(), fd), spawnedFds.end());
+    }
+    close(fd);
+    while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+}
+
+void listenMsmWorker(const std::string& socketPath, size_t maxConnections) {
+    sockaddr_un address = socketAddress(socketPath);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error(std::string("Cannot create worker socket: ") + std::strerror(errno));
+    }
+    unlink(socketPath.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 8) != 0) {
+        close(listener);
+        throw std::runtime_error("Cannot listen on " + socketPath + ": " + std::strerror(errno));
+    }
+    for (size_t served = 0; maxConnections == 0 || served < maxConnections; ++served) {
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                --served;
+                continue;
+            }
+            break;
+        }
+        try {
+            serveMsmWorker(connection, connection);
+        } catch (const std::exception&) {
+            // A broken connection only ends that session.
+        }
+        close(connection);
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+}
+
+int connectMsmWorker(const std::string& socketPath) {
+    sockaddr_un address = socketAddress(socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Cannot create worker socket: ") + std::strerror(errno));
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot connect to MSM worker at " + socketPath + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+MsmCoordinator::MsmCoordinator(const std::string& inputPath) : path(inputPath) {
+    FileHandle file(inputPath, O_RDONLY, MSM_FILE);
+    InputLayout layout = readLayout(file.get());
+    curve = layout.curve;
+    count = layout.count;
+}
+
+void MsmCoordinator::addWorker(int fd) {
+    workers.push_back(fd);
+}
+
+Ecc_Point MsmCoordinator::run(ShardStrategy strategy) const {
+    if (workers.empty()) {
+        throw std::runtime_error("MSM coordinator has no workers.");
+    }
+    const uint32_t c = static_cast<uint32_t>(msmWindowBits(count));
+    const uint32_t windows = windowCount(curve.n, c);
+
+    std::vector<MsmShard> shards;
+    std::vector<int> assigned;
+    size_t units = strategy == ShardStrategy::PointRange ? count : windows;
+    size_t per = (units + workers.size() - 1) / workers.size();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        size_t begin = std::min(units, i * per);
+        size_t end = std::min(units, begin + per);
+        if (begin == end) {
+            continue;
+        }
+        MsmShard shard;
+        shard.path = path;
+        shard.windowBits = c;
+        if (strategy == ShardStrategy::PointRange) {
+            shard.pointBegin = begin;
+            shard.pointEnd = end;
+            shard.windowBegin = 0;
+            shard.windowEnd = windows;
+        } else {
+            shard.pointBegin = 0;
+            shard.pointEnd = count;
+            shard.windowBegin = static_cast<uint32_t>(begin);
+            shard.windowEnd = static_cast<uint32_t>(end);
+        }
+        shards.push_back(shard);
+        assigned.push_back(workers[i]);
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        writeFrame(assigned[i], FRAME_SHARD, encodeShard(shards[i]));
+    }
+
+    // Every reply is drained before reporting a failure, so the connections stay usable.
+    JacobianArithmetic arithmetic(Ecc_Point(curve.Gx, curve.Gy, curve));
+    std::vector<JacobianPoint> sums(windows);
+    std::string failure;
+    uint32_t type = 0;
+    std::vector<unsigned char> payload;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (!readFrame(assigned[i], type, payload)) {
+            throw std::runtime_error("MSM worker disconnected.");
+        }
+        if (type == FRAME_ERROR) {
+            if (failure.empty()) {
+                failure.assign(payload.begin(), payload.end());
+            }
+            continue;
+        }
+        size_t width = payload.size() >= 8 ? loadLE(&payload[0], 4) : 0;
+        size_t received = payload.size() >= 8 ? loadLE(&payload[4], 4) : 0;
+        if (type != FRAME_WINDOWS || received != shards[i].windowEnd - shards[i].windowBegin ||
+            payload.size() != 8 + received * (1 + 2 * width)) {
+            throw std::runtime_error("Malformed reply from MSM worker.");
+        }
+        for (size_t j = 0; j < received; ++j) {
+            Ecc_Point sum = loadPoint(&payload[8 + j * (1 + 2 * width)], width, curve);
+            if (!sum.isInfinity) {
+                size_t w = shards[i].windowBegin + j;
+                sums[w] = arithmetic.addMixed(sums[w], sum);
+            }
+        }
+    }
+    if (!failure.empty()) {
+        throw std::runtime_error("MSM worker failed: " + failure);
+    }
+
+    JacobianPoint result;
+    for (size_t w = windows; w-- > 0;) {
+        for (uint32_t i = 0; i < c; ++i) {
+            result = arithmetic.dbl(result);
+        }
+        result = arithmetic.add(result, sums[w]);
+    }
+    return arithmetic.toAffine(result);
+}
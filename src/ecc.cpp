@@ -1,7 +1,69 @@
 #include "../include/bigint.hpp"
 #include "../include/ecc.hpp"
+#include "../include/glv.hpp"
 #include <iostream>
 
+// Named Curves
+const CurveParameters& CurveParameters::p256() {
+    static const CurveParameters params = {
+        BigInt("ffffffff00000001000000000000000000000000fffffffffffffffffffffffc",16),
+        BigInt("5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b",16),
+        BigInt("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff",16),
+        BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16),
+        BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16),
+        BigInt("ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551",16)
+    };
+    return params;
+}
+
+const CurveParameters& CurveParameters::secp256k1() {
+    static const CurveParameters params = {
+        BigInt("0",16),
+        BigInt("7",16),
+        BigInt("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f",16),
+        BigInt("79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",16),
+        BigInt("483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",16),
+        BigInt("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141",16)
+    };
+    return params;
+}
+
+const CurveParameters& CurveParameters::p521() {
+    static const CurveParameters params = {
+        BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffc",16),
+        BigInt("0051953eb9618e1c9a1f929a21a0b68540eea2da725b99b315f3b8b489918ef109e156193951ec7e937b1652c0bd3bb1bf073573df883d2c34f1ef451fd46b503f00",16),
+        BigInt("01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",16),
+        BigInt("00c6858e06b70404e9cd9e3ecb662395b4429c648139053fb521f828af606b4d3dbaa14b5e77efe75928fe1dc127a2ffa8de3348b3c1856a429bf97e7e31c2e5bd66",16),
+        BigInt("011839296a789a3bc0045c8a5fb42c7d1bd998f54449579b446817afbd17273e662c97ee72995ef42640c550b9013fad0761353c7086a272c24088be94769fd16650",16),
+        BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffa51868783bf2f966b7fcc0148f709a5d03bb5c9b8899c47aebb6fb71e91386409",16)
+    };
+    return params;
+}
+
+void Ecc_Point::setCurveParameters() {
+    #ifdef USE_CURVE_P256
+        static const std::shared_ptr<const FieldBackend> backend = FieldBackend::forModulus(CurveParameters::p256().p);
+        curveParams = CurveParameters::p256();
+    #elif defined USE_CURVE_SECP256K1
+        static const std::shared_ptr<const FieldBackend> backend = FieldBackend::forModulus(CurveParameters::secp256k1().p);
+        curveParams = CurveParameters::secp256k1();
+    #elif defined USE_CURVE_P521
+        static const std::shared_ptr<const FieldBackend> backend = FieldBackend::forModulus(CurveParameters::p521().p);
+        curveParams = CurveParameters::p521();
+    #else
+        #error "No elliptic curve defined"
+    #endif
+    field = backend;
+}
+
+Ecc_Point Ecc_Point::withCoordinates(const BigInt& x, const BigInt& y) const {
+    Ecc_Point result(*this);
+    result.xCoord = x;
+    result.yCoord = y;
+    result.isInfinity = false;
+    return result;
+}
+
 Ecc_Point Ecc_Point::operator+(const Ecc_Point& other) const {
     if (this->isInfinity) return other;
     if (other.isInfinity) return *this;
@@ -10,17 +72,17 @@ Ecc_Point Ecc_Point::operator+(const Ecc_Point& other) const {
     if (*this == other) {
         return this->doublePoint();
     }
-    BigInt lambda = (other.yCoord - yCoord) * ((other.xCoord - xCoord).modInverse(curveParams.p));
-    BigInt x3 = (lambda * lambda - xCoord - other.xCoord) % curveParams.p;
-    BigInt y3 = (lambda * (xCoord - x3) - yCoord) % curveParams.p;
+    BigInt lambda = field->mul(other.yCoord - yCoord, field->inv(other.xCoord - xCoord));
+    BigInt x3 = field->sub(field->sqr(lambda), xCoord + other.xCoord);
+    BigInt y3 = field->sub(field->mul(lambda, xCoord - x3), yCoord);
 
-    return Ecc_Point(x3, y3);
+    return withCoordinates(x3, y3);
 }
 
 
 Ecc_Point Ecc_Point::operator-() const {
     if (this->isInfinity) return *this;
-    return Ecc_Point(xCoord, curveParams.p - yCoord);
+    return withCoordinates(xCoord, curveParams.p - yCoord);
 }
 
 
@@ -28,6 +90,11 @@ Ecc_Point Ecc_Point::operator*(const BigInt& scalar) const {
 if (scalar.isZero() || this->isInfinity) {
     return Ecc_Point();
 }
+    const GLVEndomorphism* glv = GLVEndomorphism::forCurve(curveParams);
+    if (glv != nullptr) {
+        return glv->multiply(*this, scalar);
+    }
+
     Ecc_Point result;
     Ecc_Point point = *this;
 
@@ -54,14 +121,15 @@ Ecc_Point Ecc_Point::doublePoint() const {
         return Ecc_Point();
     }
 
-    BigInt lambda = (BigInt(static_cast<unsigned long int>(3)) * xCoord * xCoord + curveParams.a) * 
-                    (BigInt(static_cast<unsigned long int>(2)) * yCoord).modInverse(curveParams.p);
-    BigInt x3 = (lambda * lambda - BigInt(static_cast<unsigned long int>(2)) * xCoord) % curveParams.p;
-    BigInt y3 = (lambda * (xCoord - x3) - yCoord) % curveParams.p;
+    BigInt lambda = field->mul(BigInt(static_cast<unsigned long int>(3)) * field->sqr(xCoord) + curveParams.a,
+                               field->inv(BigInt(static_cast<unsigned long int>(2)) * yCoord));
+    BigInt x3 = field->sub(field->sqr(lambda), BigInt(static_cast<unsigned long int>(2)) * xCoord);
+    BigInt y3 = field->sub(field->mul(lambda, xCoord - x3), yCoord);
 
-    return Ecc_Point(x3, y3);
+    return withCoordinates(x3, y3);
 }
 
+#ifndef ZKSNARKS_LIBRARY
 int main() {
     Ecc_Point G;
     G=Ecc_Point(BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16),BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16));
@@ -111,4 +179,5 @@ int main() {
     std::cout << "Scalar Multiplication Test " << (isMultiplicationCorrect ? "PASSED" : "FAILED") << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
+#endif // ZKSNARKS_LIBRARY
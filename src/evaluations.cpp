@@ -0,0 +1,296 @@
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/evaluations.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+struct Evaluations::Node {
+    enum Kind { Leaf, Constant, Add, Sub, Mul, Scale, Combination };
+
+    Kind kind;
+    size_t count;                                         ///< Nodes in this subtree.
+    std::shared_ptr<const std::vector<BigInt>> values;   ///< Leaf values.
+    BigInt constant;                                      ///< Constant value.
+    std::vector<std::shared_ptr<const Node>> children;
+    std::vector<BigInt> weights;                          ///< Scale factor or combination weights.
+};
+
+namespace {
+
+typedef Evaluations::Node Node;
+
+// An instruction operand: an element of a leaf vector or a register.
+struct Operand {
+    bool leaf;
+    size_t index;
+};
+
+struct Instruction {
+    Node::Kind op;
+    size_t dst;
+    std::vector<Operand> args;
+    const std::vector<BigInt>* weights;
+};
+
+// A fused expression compiled to straight-line code over registers, run once per domain point.
+struct Program {
+    std::vector<const std::vector<BigInt>*> leaves;
+    std::vector<std::pair<size_t, BigInt>> preload; ///< Registers holding constants.
+    std::vector<Instruction> code;
+    size_t registers;
+    Operand result;
+
+    Program() : registers(0) {}
+};
+
+Operand compile(const Node* node, Program& program, std::map<const Node*, Operand>& seen) {
+    std::map<const Node*, Operand>::const_iterator found = seen.find(node);
+    if (found != seen.end()) {
+        return found->second;
+    }
+    Operand operand;
+    if (node->kind == Node::Leaf) {
+        operand.leaf = true;
+        operand.index = std::find(program.leaves.begin(), program.leaves.end(), node->values.get()) - program.leaves.begin();
+        if (operand.index == program.leaves.size()) {
+            program.leaves.push_back(node->values.get());
+        }
+    } else if (node->kind == Node::Constant) {
+        operand.leaf = false;
+        operand.index = program.registers++;
+        program.preload.push_back(std::make_pair(operand.index, node->constant));
+    } else {
+        Instruction instruction;
+        instruction.op = node->kind;
+        instruction.weights = &node->weights;
+        for (const auto& child : node->children) {
+            instruction.args.push_back(compile(child.get(), program, seen));
+        }
+        instruction.dst = program.registers++;
+        program.code.push_back(instruction);
+        operand.leaf = false;
+        operand.index = instruction.dst;
+    }
+    seen[node] = operand;
+    return operand;
+}
+
+std::vector<BigInt> run(const Program& program, size_t n, const FieldBackend& field, size_t chunk) {
+    static const unsigned scope = allocationScopeId("evaluations");
+    AllocationScope allocations(scope);
+    std::vector<BigInt> out(n);
+    mpz_srcptr p = field.modulus().get_mpz_t();
+    size_t chunks = (n + chunk - 1) / chunk;
+    parallelFor(chunks, [&](size_t c) {
+        std::vector<BigInt> regs(program.registers);
+        for (const auto& entry : program.preload) {
+            regs[entry.first] = entry.second;
+        }
+        auto source = [&](const Operand& operand, size_t i) -> mpz_srcptr {
+            return operand.leaf ? (*program.leaves[operand.index])[i].get_mpz_t() : regs[operand.index].get_mpz_t();
+        };
+        size_t end = std::min(n, (c + 1) * chunk);
+        for (size_t i = c * chunk; i < end; ++i) {
+            for (const Instruction& instruction : program.code) {
+                BigInt& dst = regs[instruction.dst];
+                mpz_ptr d = dst.get_mpz_t();
+                switch (instruction.op) {
+                case Node::Add:
+                    mpz_add(d, source(instruction.args[0], i), source(instruction.args[1], i));
+                    if (mpz_cmp(d, p) >= 0) {
+                        mpz_sub(d, d, p);
+                    }
+                    break;
+                case Node::Sub:
+                    mpz_sub(d, source(instruction.args[0], i), source(instruction.args[1], i));
+                    if (mpz_sgn(d) < 0) {
+                        mpz_add(d, d, p);
+                    }
+                    break;
+                case Node::Mul:
+                    mpz_mul(d, source(instruction.args[0], i), source(instruction.args[1], i));
+                    field.reduce(dst);
+                    break;
+                case Node::Scale:
+                    mpz_mul(d, source(instruction.args[0], i), (*instruction.weights)[0].get_mpz_t());
+                    field.reduce(dst);
+                    break;
+                case Node::Combination:
+                    mpz_mul(d, source(instruction.args[0], i), (*instruction.weights)[0].get_mpz_t());
+                    for (size_t j = 1; j < instruction.args.size(); ++j) {
+                        mpz_addmul(d, source(instruction.args[j], i), (*instruction.weights)[j].get_mpz_t());
+                    }
+                    field.reduce(dst);
+                    break;
+                default:
+                    break;
+                }
+            }
+            mpz_set(out[i].get_mpz_t(), source(program.result, i));
+        }
+    }, 0);
+    return out;
+}
+
+std::shared_ptr<const Node> leafNode(const std::shared_ptr<const std::vector<BigInt>>& values) {
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->kind = Node::Leaf;
+    node->count = 1;
+    node->values = values;
+    return node;
+}
+
+bool sameDomain(const EvaluationDomain& a, const EvaluationDomain& b) {
+    return &a == &b || (a.size() == b.size() && a.modulus() == b.modulus());
+}
+
+} // namespace
+
+Evaluations::Evaluations(const std::shared_ptr<const EvaluationDomain>& domain, const std::vector<BigInt>& values)
+    : domain(domain) {
+    if (values.size() != domain->size()) {
+        throw std::invalid_argument("Number of evaluations must equal the domain size.");
+    }
+    std::shared_ptr<std::vector<BigInt>> reduced = std::make_shared<std::vector<BigInt>>(values);
+    for (BigInt& v : *reduced) {
+        if (v.isNegative() || v >= domain->modulus()) {
+            v %= domain->modulus();
+        }
+    }
+    materialized = reduced;
+    expression = leafNode(materialized);
+}
+
+Evaluations::Evaluations(const std::shared_ptr<const EvaluationDomain>& domain, const std::shared_ptr<const Node>& expression)
+    : domain(domain), expression(expression) {
+    if (expression->kind == Node::Leaf) {
+        materialized = expression->values;
+    }
+}
+
+Evaluations Evaluations::fromPolynomial(const std::shared_ptr<const EvaluationDomain>& domain, const Polynomial& poly) {
+    if (poly.getMod() != domain->modulus()) {
+        throw std::invalid_argument("Polynomial and domain use different moduli.");
+    }
+    if (poly.deg() >= static_cast<int>(domain->size())) {
+        throw std::invalid_argument("Polynomial degree must be below the domain size.");
+    }
+    std::vector<BigInt> values = poly.getCoefficients();
+    domain->fft(values);
+    Evaluations result(domain, leafNode(std::make_shared<const std::vector<BigInt>>(values)));
+    result.coefficients = std::make_shared<const Polynomial>(poly);
+    return result;
+}
+
+Evaluations Evaluations::constant(const std::shared_ptr<const EvaluationDomain>& domain, const BigInt& c) {
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->kind = Node::Constant;
+    node->count = 1;
+    node->constant = c % domain->modulus();
+    return Evaluations(domain, node);
+}
+
+Evaluations Evaluations::linearCombination(const std::vector<Evaluations>& terms, const std::vector<BigInt>& weights) {
+    if (terms.empty() || terms.size() != weights.size()) {
+        throw std::invalid_argument("A linear combination needs one weight per term.");
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->kind = Node::Combination;
+    node->count = 1;
+    const BigInt& p = terms[0].domain->modulus();
+    for (size_t j = 0; j < terms.size(); ++j) {
+        if (!sameDomain(*terms[j].domain, *terms[0].domain)) {
+            throw std::invalid_argument("Evaluations must share the same domain.");
+        }
+        node->children.push_back(terms[j].operand());
+        node->count += node->children.back()->count;
+        node->weights.push_back(weights[j] % p);
+    }
+    return Evaluations(terms[0].domain, node);
+}
+
+bool Evaluations::isMaterialized() const {
+    return std::atomic_load(&materialized) != nullptr;
+}
+
+const std::vector<BigInt>& Evaluations::values() const {
+    std::shared_ptr<const std::vector<BigInt>> current = std::atomic_load(&materialized);
+    if (current) {
+        return *current;
+    }
+    Program program;
+    std::map<const Node*, Operand> seen;
+    program.result = compile(expression.get(), program, seen);
+    std::shared_ptr<const std::vector<BigInt>> computed =
+        std::make_shared<const std::vector<BigInt>>(run(program, domain->size(), domain->getField(), FUSED_CHUNK));
+    // Concurrent callers may both compute; the first stored result wins and the other is dropped.
+    std::shared_ptr<const std::vector<BigInt>> expected;
+    if (!std::atomic_compare_exchange_strong(&materialized, &expected, computed)) {
+        return *expected;
+    }
+    return *computed;
+}
+
+const Polynomial& Evaluations::toPolynomial() const {
+    std::shared_ptr<const Polynomial> current = std::atomic_load(&coefficients);
+    if (current) {
+        return *current;
+    }
+    std::vector<BigInt> coeffs = values();
+    domain->ifft(coeffs);
+    std::shared_ptr<const Polynomial> computed = std::make_shared<const Polynomial>(coeffs, domain->modulus());
+    std::shared_ptr<const Polynomial> expected;
+    if (!std::atomic_compare_exchange_strong(&coefficients, &expected, computed)) {
+        return *expected;
+    }
+    return *computed;
+}
+
+// The node a new operation should reference: the cached values if there are any, the pending
+// expression otherwise, unless fusing it would make the chain too long.
+std::shared_ptr<const Evaluations::Node> Evaluations::operand() const {
+    std::shared_ptr<const std::vector<BigInt>> current = std::atomic_load(&materialized);
+    if (!current && expression->count >= MAX_FUSED_NODES) {
+        values();
+        current = std::atomic_load(&materialized);
+    }
+    if (current) {
+        return expression->kind == Node::Leaf ? expression : leafNode(current);
+    }
+    return expression;
+}
+
+Evaluations Evaluations::combine(int kind, const Evaluations& other) const {
+    if (!sameDomain(*domain, *other.domain)) {
+        throw std::invalid_argument("Evaluations must share the same domain.");
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->kind = static_cast<Node::Kind>(kind);
+    node->children.push_back(operand());
+    node->children.push_back(other.operand());
+    node->count = 1 + node->children[0]->count + node->children[1]->count;
+    return Evaluations(domain, node);
+}
+
+Evaluations Evaluations::operator+(const Evaluations& other) const {
+    return combine(Node::Add, other);
+}
+
+Evaluations Evaluations::operator-(const Evaluations& other) const {
+    return combine(Node::Sub, other);
+}
+
+Evaluations Evaluations::operator*(const Evaluations& other) const {
+    return combine(Node::Mul, other);
+}
+
+Evaluations Evaluations::scale(const BigInt& c) const {
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->kind = Node::Scale;
+    node->children.push_back(operand());
+    node->count = 1 + node->children[0]->count;
+    node->weights.push_back(c % domain->modulus());
+    return Evaluations(domain, node);
+}
@@ -0,0 +1,162 @@
+#include "../include/bigint.hpp"
+#include "../include/exponentiation.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const size_t MULTI_EXP_MIN_TERMS = 4;
+
+// Sliding-window recoding: digits[b] is the odd window value ending at bit b, or 0.
+std::vector<unsigned> slidingWindows(const BigInt& e, unsigned width) {
+    size_t bits = e.isZero() ? 0 : e.bitSize();
+    std::vector<unsigned> digits(bits, 0);
+    mpz_srcptr k = e.get_mpz_t();
+    for (size_t top = bits; top-- > 0;) {
+        if (!mpz_tstbit(k, top)) {
+            continue;
+        }
+        size_t low = top + 1 > width ? top + 1 - width : 0;
+        while (!mpz_tstbit(k, low)) {
+            ++low;
+        }
+        unsigned digit = 0;
+        for (size_t b = top + 1; b-- > low;) {
+            digit = (digit << 1) | mpz_tstbit(k, b);
+        }
+        digits[low] = digit;
+        top = low;
+    }
+    return digits;
+}
+
+unsigned windowWidth(size_t bits) {
+    if (bits <= 24) return 1;
+    if (bits <= 80) return 3;
+    if (bits <= 240) return 4;
+    if (bits <= 672) return 5;
+    return 6;
+}
+
+} // namespace
+
+FixedBaseExp::FixedBaseExp(const BigInt& base, const BigInt& modulus, size_t maxExponentBits, unsigned windowBits)
+    : windowBits(windowBits) {
+    if (modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be nonzero.");
+    }
+    if (windowBits == 0 || windowBits > 16) {
+        throw std::invalid_argument("Window width must be between 1 and 16 bits.");
+    }
+    field = FieldBackend::forModulus(modulus);
+    this->base = base % modulus;
+    windows = (maxExponentBits + windowBits - 1) / windowBits;
+    size_t rowSize = (static_cast<size_t>(1) << windowBits) - 1;
+    table.reserve(windows * rowSize);
+    BigInt rowBase = this->base;
+    for (size_t j = 0; j < windows; ++j) {
+        BigInt acc = rowBase;
+        table.push_back(acc);
+        for (size_t d = 2; d <= rowSize; ++d) {
+            acc = field->mul(acc, rowBase);
+            table.push_back(acc);
+        }
+        rowBase = field->mul(acc, rowBase);
+    }
+}
+
+BigInt FixedBaseExp::pow(const BigInt& exponent) const {
+    const BigInt& m = field->modulus();
+    if (exponent.isNegative()) {
+        BigInt positive = exponent;
+        positive.negate();
+        return pow(positive).modInverse(m);
+    }
+    if (exponent.bitSize() > windows * windowBits) {
+        return base.powm(exponent, m);
+    }
+    size_t rowSize = (static_cast<size_t>(1) << windowBits) - 1;
+    BigInt result = BigInt(static_cast<unsigned long int>(1)) % m;
+    BigInt t;
+    mpz_srcptr e = exponent.get_mpz_t();
+    for (size_t j = 0; j < windows; ++j) {
+        unsigned digit = 0;
+        for (unsigned b = windowBits; b-- > 0;) {
+            digit = (digit << 1) | mpz_tstbit(e, j * windowBits + b);
+        }
+        if (digit != 0) {
+            mpz_mul(t.get_mpz_t(), result.get_mpz_t(), table[j * rowSize + digit - 1].get_mpz_t());
+            field->reduce(t);
+            result.swap(t);
+        }
+    }
+    return result;
+}
+
+BigInt multiExp(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents, const BigInt& modulus) {
+    if (bases.size() != exponents.size()) {
+        throw std::invalid_argument("Number of bases and exponents must be the same.");
+    }
+    if (modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be nonzero.");
+    }
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(modulus);
+
+    // GMP's powm runs on Montgomery limbs internally, which outweighs the shared squarings for a
+    // handful of terms.
+    if (bases.size() < MULTI_EXP_MIN_TERMS) {
+        BigInt result = BigInt(static_cast<unsigned long int>(1)) % modulus;
+        for (size_t i = 0; i < bases.size(); ++i) {
+            result = field->mul(result, bases[i].powm(exponents[i], modulus));
+        }
+        return result;
+    }
+
+    size_t maxBits = 0;
+    for (const BigInt& e : exponents) {
+        maxBits = std::max(maxBits, e.bitSize());
+    }
+    const unsigned width = windowWidth(maxBits);
+    const size_t oddCount = static_cast<size_t>(1) << (width - 1);
+
+    // Odd powers g, g³, …, g^(2^w − 1) of every base and the recoded exponents.
+    std::vector<std::vector<BigInt>> odd(bases.size());
+    std::vector<std::vector<unsigned>> digits(bases.size());
+    size_t length = 0;
+    for (size_t i = 0; i < bases.size(); ++i) {
+        BigInt g = bases[i] % modulus;
+        BigInt e = exponents[i];
+        if (e.isNegative()) {
+            e.negate();
+            g = g.modInverse(modulus);
+        }
+        digits[i] = slidingWindows(e, width);
+        length = std::max(length, digits[i].size());
+        if (digits[i].empty()) {
+            continue;
+        }
+        BigInt square = field->sqr(g);
+        odd[i].push_back(g);
+        for (size_t d = 1; d < oddCount; ++d) {
+            odd[i].push_back(field->mul(odd[i].back(), square));
+        }
+    }
+
+    BigInt result = BigInt(static_cast<unsigned long int>(1)) % modulus;
+    BigInt t;
+    for (size_t bit = length; bit-- > 0;) {
+        if (bit + 1 < length) {
+            mpz_mul(t.get_mpz_t(), result.get_mpz_t(), result.get_mpz_t());
+            field->reduce(t);
+            result.swap(t);
+        }
+        for (size_t i = 0; i < bases.size(); ++i) {
+            if (bit < digits[i].size() && digits[i][bit] != 0) {
+                mpz_mul(t.get_mpz_t(), result.get_mpz_t(), odd[i][digits[i][bit] / 2].get_mpz_t());
+                field->reduce(t);
+                result.swap(t);
+            }
+        }
+    }
+    return result;
+}
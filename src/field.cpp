@@ -0,0 +1,296 @@
+#include "../include/bigint.hpp"
+#include "../include/ecc.hpp"
+#include "../include/field.hpp"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Generic Backend
+FieldBackend::FieldBackend(const BigInt& modulus) : p(modulus) {}
+
+FieldBackend::~FieldBackend() {}
+
+const BigInt& FieldBackend::modulus() const {
+    return p;
+}
+
+const char* FieldBackend::name() const {
+    return "generic";
+}
+
+void FieldBackend::reduce(BigInt& x) const {
+    mpz_mod(x.get_mpz_t(), x.get_mpz_t(), p.get_mpz_t());
+}
+
+BigInt FieldBackend::add(const BigInt& a, const BigInt& b) const {
+    BigInt result = a + b;
+    reduce(result);
+    return result;
+}
+
+BigInt FieldBackend::sub(const BigInt& a, const BigInt& b) const {
+    BigInt result = a - b;
+    reduce(result);
+    return result;
+}
+
+BigInt FieldBackend::mul(const BigInt& a, const BigInt& b) const {
+    BigInt result = a * b;
+    reduce(result);
+    return result;
+}
+
+BigInt FieldBackend::sqr(const BigInt& a) const {
+    BigInt result = a * a;
+    reduce(result);
+    return result;
+}
+
+BigInt FieldBackend::inv(const BigInt& a) const {
+    return a.modInverse(p);
+}
+
+bool FieldBackend::sqrt(const BigInt& a, BigInt& root) const {
+    BigInt x = a;
+    reduce(x);
+    if (x.isZero()) {
+        root = x;
+        return true;
+    }
+    mpz_srcptr m = p.get_mpz_t();
+    if (mpz_legendre(x.get_mpz_t(), m) != 1) {
+        return false;
+    }
+
+    if (mpz_fdiv_ui(m, 4) == 3) {
+        BigInt e = (p + BigInt(static_cast<unsigned long int>(1))).rightShift(2);
+        mpz_powm(root.get_mpz_t(), x.get_mpz_t(), e.get_mpz_t(), m);
+        return true;
+    }
+
+    // Tonelli-Shanks: write p - 1 = q * 2^s with q odd.
+    BigInt q = p - BigInt(static_cast<unsigned long int>(1));
+    unsigned long s = mpz_scan1(q.get_mpz_t(), 0);
+    q = q.rightShift(s);
+
+    BigInt z(static_cast<unsigned long int>(2));
+    while (mpz_legendre(z.get_mpz_t(), m) != -1) {
+        z += BigInt(static_cast<unsigned long int>(1));
+    }
+    BigInt c, t, r;
+    mpz_powm(c.get_mpz_t(), z.get_mpz_t(), q.get_mpz_t(), m);
+    mpz_powm(t.get_mpz_t(), x.get_mpz_t(), q.get_mpz_t(), m);
+    BigInt e = (q + BigInt(static_cast<unsigned long int>(1))).rightShift(1);
+    mpz_powm(r.get_mpz_t(), x.get_mpz_t(), e.get_mpz_t(), m);
+
+    unsigned long mExp = s;
+    BigInt one(static_cast<unsigned long int>(1));
+    while (t != one) {
+        unsigned long i = 0;
+        BigInt t2 = t;
+        while (t2 != one) {
+            t2 = sqr(t2);
+            ++i;
+        }
+        BigInt b = c;
+        for (unsigned long j = 0; j + i + 1 < mExp; ++j) {
+            b = sqr(b);
+        }
+        mExp = i;
+        c = sqr(b);
+        t = mul(t, c);
+        r = mul(r, b);
+    }
+    root = r;
+    return true;
+}
+
+namespace {
+
+// Generic backends kept for moduli other than the built-in curve fields; the oldest is dropped
+// first. Objects holding a dropped backend keep it alive through their shared_ptr.
+const size_t MAX_CACHED_MODULI = 64;
+
+struct ModulusHash {
+    size_t operator()(const BigInt& modulus) const {
+        const mp_limb_t* limbs = mpz_limbs_read(modulus.get_mpz_t());
+        size_t hash = mpz_size(modulus.get_mpz_t());
+        for (size_t i = 0; i < mpz_size(modulus.get_mpz_t()); ++i) {
+            hash = hash * 1099511628211ULL ^ static_cast<size_t>(limbs[i]);
+        }
+        return hash;
+    }
+};
+
+} // namespace
+
+std::shared_ptr<const FieldBackend> FieldBackend::forModulus(const BigInt& modulus) {
+    // The curve primes and group orders are resolved without locking: function-local statics are
+    // initialized once and only read afterwards.
+    static const std::shared_ptr<const FieldBackend> common[] = {
+        std::make_shared<P256Field>(),
+        std::make_shared<Secp256k1Field>(),
+        std::make_shared<FieldBackend>(CurveParameters::p256().n),
+        std::make_shared<FieldBackend>(CurveParameters::secp256k1().n)
+    };
+    for (const auto& backend : common) {
+        if (backend->modulus() == modulus) {
+            return backend;
+        }
+    }
+
+    static std::mutex cacheMutex;
+    static std::unordered_map<BigInt, std::shared_ptr<const FieldBackend>, ModulusHash> cache;
+    static std::deque<BigInt> insertionOrder;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = cache.find(modulus);
+    if (found != cache.end()) {
+        return found->second;
+    }
+    if (cache.size() >= MAX_CACHED_MODULI) {
+        cache.erase(insertionOrder.front());
+        insertionOrder.pop_front();
+    }
+    std::shared_ptr<const FieldBackend> backend = std::make_shared<FieldBackend>(modulus);
+    cache.emplace(modulus, backend);
+    insertionOrder.push_back(modulus);
+    return backend;
+}
+
+#if GMP_NUMB_BITS == 64
+
+namespace {
+
+// Writes a 4-limb result back into x, mapping it to p - r when the input was negative.
+void storeReduced(BigInt& x, mp_limb_t r[4], const mp_limb_t* p, bool negative) {
+    if (negative && !mpn_zero_p(r, 4)) {
+        mpn_sub_n(r, p, r, 4);
+    }
+    mp_limb_t* d = mpz_limbs_modify(x.get_mpz_t(), 4);
+    for (int i = 0; i < 4; ++i) {
+        d[i] = r[i];
+    }
+    mpz_limbs_finish(x.get_mpz_t(), 4);
+}
+
+// Copies the absolute value of x into an 8-limb buffer. Returns false if it does not fit.
+bool loadWide(const BigInt& x, mp_limb_t t[8]) {
+    size_t n = mpz_size(x.get_mpz_t());
+    if (n > 8) {
+        return false;
+    }
+    const mp_limb_t* src = mpz_limbs_read(x.get_mpz_t());
+    for (size_t i = 0; i < 8; ++i) {
+        t[i] = i < n ? src[i] : 0;
+    }
+    return true;
+}
+
+} // namespace
+
+#endif
+
+// NIST P-256
+P256Field::P256Field()
+    : FieldBackend(BigInt("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff", 16)) {}
+
+const char* P256Field::name() const {
+    return "p256-solinas";
+}
+
+void P256Field::reduce(BigInt& x) const {
+#if GMP_NUMB_BITS == 64
+    mp_limb_t t[8];
+    if (!loadWide(x, t)) {
+        FieldBackend::reduce(x);
+        return;
+    }
+    bool negative = x.isNegative();
+
+    int64_t c[16];
+    for (int i = 0; i < 8; ++i) {
+        c[2 * i] = static_cast<int64_t>(t[i] & 0xffffffffUL);
+        c[2 * i + 1] = static_cast<int64_t>(t[i] >> 32);
+    }
+
+    // s1 + 2*s2 + 2*s3 + s4 + s5 - s6 - s7 - s8 - s9, one 32-bit word position at a time.
+    int64_t w[8];
+    w[0] = c[0] + c[8] + c[9] - c[11] - c[12] - c[13] - c[14];
+    w[1] = c[1] + c[9] + c[10] - c[12] - c[13] - c[14] - c[15];
+    w[2] = c[2] + c[10] + c[11] - c[13] - c[14] - c[15];
+    w[3] = c[3] + 2 * c[11] + 2 * c[12] + c[13] - c[15] - c[8] - c[9];
+    w[4] = c[4] + 2 * c[12] + 2 * c[13] + c[14] - c[9] - c[10];
+    w[5] = c[5] + 2 * c[13] + 2 * c[14] + c[15] - c[10] - c[11];
+    w[6] = c[6] + 3 * c[14] + 2 * c[15] + c[13] - c[8] - c[9];
+    w[7] = c[7] + 3 * c[15] + c[8] - c[10] - c[11] - c[12] - c[13];
+
+    int64_t carry = 0;
+    mp_limb_t r[4];
+    for (int i = 0; i < 8; ++i) {
+        int64_t v = w[i] + carry;
+        carry = v >> 32;
+        uint64_t word = static_cast<uint64_t>(v) & 0xffffffffUL;
+        if (i % 2 == 0) {
+            r[i / 2] = word;
+        } else {
+            r[i / 2] |= word << 32;
+        }
+    }
+
+    // The value is carry * 2^256 + r with a small signed carry; fold it back into [0, p).
+    const mp_limb_t* m = mpz_limbs_read(p.get_mpz_t());
+    while (carry < 0) {
+        carry += static_cast<int64_t>(mpn_add_n(r, r, m, 4));
+    }
+    while (carry > 0 || mpn_cmp(r, m, 4) >= 0) {
+        carry -= static_cast<int64_t>(mpn_sub_n(r, r, m, 4));
+    }
+    storeReduced(x, r, m, negative);
+#else
+    FieldBackend::reduce(x);
+#endif
+}
+
+// secp256k1
+Secp256k1Field::Secp256k1Field()
+    : FieldBackend(BigInt("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f", 16)) {}
+
+const char* Secp256k1Field::name() const {
+    return "secp256k1-pseudo-mersenne";
+}
+
+void Secp256k1Field::reduce(BigInt& x) const {
+#if GMP_NUMB_BITS == 64
+    // 2^256 = 2^32 + 977 (mod p)
+    const mp_limb_t fold = 0x1000003D1UL;
+
+    mp_limb_t t[8];
+    if (!loadWide(x, t)) {
+        FieldBackend::reduce(x);
+        return;
+    }
+    bool negative = x.isNegative();
+
+    // r = lo + hi * fold, which is below 2^290.
+    mp_limb_t r[4];
+    mp_limb_t top = mpn_mul_1(r, t + 4, 4, fold);
+    top += mpn_add_n(r, r, t, 4);
+
+    // Fold the remaining top limb once more; a final carry can only leave a tiny value.
+    mp_limb_t extra[2];
+    extra[1] = mpn_mul_1(extra, &top, 1, fold);
+    if (mpn_add(r, r, 4, extra, 2)) {
+        mpn_add_1(r, r, 4, fold);
+    }
+
+    const mp_limb_t* m = mpz_limbs_read(p.get_mpz_t());
+    while (mpn_cmp(r, m, 4) >= 0) {
+        mpn_sub_n(r, r, m, 4);
+    }
+    storeReduced(x, r, m, negative);
+#else
+    FieldBackend::reduce(x);
+#endif
+}
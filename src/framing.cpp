@@ -0,0 +1,80 @@
+#include "../include/framing.hpp"
+#include "../include/io.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+void sendAll(int fd, const unsigned char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == ENOTSOCK) {
+            sent = write(fd, data, size);
+        }
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Connection write failed: ") + std::strerror(errno));
+        }
+        data += sent;
+        size -= sent;
+    }
+}
+
+// Reads exactly size bytes; returns false if the stream ends before the first byte.
+bool receiveAll(int fd, unsigned char* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t got = read(fd, data + total, size - total);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) {
+            throw std::runtime_error(std::string("Connection read failed: ") + std::strerror(errno));
+        }
+        if (got == 0) {
+            if (total == 0) return false;
+            throw std::runtime_error("Connection closed in the middle of a frame.");
+        }
+        total += got;
+    }
+    return true;
+}
+
+} // namespace
+
+void writeFrame(int fd, uint32_t type, const std::vector<unsigned char>& payload) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    storeLE(header, type, 4);
+    storeLE(header + 4, payload.size(), 8);
+    sendAll(fd, header, FRAME_HEADER_SIZE);
+    sendAll(fd, payload.data(), payload.size());
+}
+
+bool readFrame(int fd, uint32_t& type, std::vector<unsigned char>& payload) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    if (!receiveAll(fd, header, FRAME_HEADER_SIZE)) {
+        return false;
+    }
+    type = static_cast<uint32_t>(loadLE(header, 4));
+    uint64_t length = loadLE(header + 4, 8);
+    if (length > MAX_FRAME_PAYLOAD) {
+        throw std::runtime_error("Frame is too large.");
+    }
+    payload.resize(length);
+    if (length > 0 && !receiveAll(fd, payload.data(), length)) {
+        throw std::runtime_error("Connection closed in the middle of a frame.");
+    }
+    return true;
+}
+
+sockaddr_un socketAddress(const std::string& socketPath) {
+    sockaddr_un address;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long.");
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+    return address;
+}
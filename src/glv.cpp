@@ -0,0 +1,67 @@
+#include "../include/bigint.hpp"
+#include "../include/glv.hpp"
+#include "../include/jacobian.hpp"
+
+// secp256k1 endomorphism and lattice constants (Guide to Elliptic Curve Cryptography, ex. 3.73).
+GLVEndomorphism::GLVEndomorphism()
+    : beta("7ae96a2b657c07106e64479eac3434e99cf0497512f58995c1396c28719501ee", 16),
+      lambda("5363ad4cc05c30e0a5261c028812645a122e22ea20816678df02967c1b23bd72", 16),
+      n(CurveParameters::secp256k1().n),
+      a1("3086d221a7d46bcde86c90e49284eb15", 16),
+      b1("-e4437ed6010e88286f547fa90abfe4c3", 16),
+      a2("114ca50f7a8e2f3f657c1108d9d44cfd8", 16),
+      b2("3086d221a7d46bcde86c90e49284eb15", 16) {
+    BigInt scale = BigInt(static_cast<unsigned long int>(1)).leftShift(384);
+    BigInt half = n.rightShift(1);
+    BigInt minusB1 = b1;
+    minusB1.negate();
+    g1 = (scale * b2 + half) / n;
+    g2 = (scale * minusB1 + half) / n;
+}
+
+const GLVEndomorphism* GLVEndomorphism::forCurve(const CurveParameters& params) {
+    static const GLVEndomorphism secp256k1;
+    const CurveParameters& k1 = CurveParameters::secp256k1();
+    if (params.a.isZero() && params.p == k1.p && params.n == k1.n) {
+        return &secp256k1;
+    }
+    return nullptr;
+}
+
+GLVDecomposition GLVEndomorphism::split(const BigInt& k) const {
+    BigInt scalar = k % n;
+    BigInt roundBit = BigInt(static_cast<unsigned long int>(1)).leftShift(383);
+    BigInt c1 = (scalar * g1 + roundBit).rightShift(384);
+    BigInt c2 = (scalar * g2 + roundBit).rightShift(384);
+
+    BigInt k1 = scalar - c1 * a1 - c2 * a2;
+    BigInt k2 = BigInt(static_cast<unsigned long int>(0)) - c1 * b1 - c2 * b2;
+
+    GLVDecomposition result;
+    result.k1Negative = k1.isNegative();
+    result.k2Negative = k2.isNegative();
+    if (result.k1Negative) k1.negate();
+    if (result.k2Negative) k2.negate();
+    result.k1 = k1;
+    result.k2 = k2;
+    return result;
+}
+
+Ecc_Point GLVEndomorphism::apply(const Ecc_Point& point) const {
+    if (point.isInfinity) {
+        return point;
+    }
+    return point.withCoordinates(point.getField()->mul(beta, point.getX()), point.getY());
+}
+
+Ecc_Point GLVEndomorphism::multiply(const Ecc_Point& point, const BigInt& k) const {
+    if (point.isInfinity) {
+        return Ecc_Point();
+    }
+    GLVDecomposition parts = split(k);
+    Ecc_Point p = parts.k1Negative ? -point : point;
+    Ecc_Point q = apply(parts.k2Negative ? -point : point);
+
+    JacobianArithmetic arithmetic(point);
+    return arithmetic.toAffine(arithmetic.mulDouble(p, parts.k1, q, parts.k2));
+}
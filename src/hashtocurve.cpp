@@ -0,0 +1,251 @@
+#include "../include/bigint.hpp"
+#include "../include/hashtocurve.hpp"
+#include "../include/parallel.hpp"
+#include "../include/sha256.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Messages per shared inversion in hashBatch(); a multiple of 64 so that blocks never share a word
+// of the PointVector infinity bitmap.
+const size_t BATCH_BLOCK = 256;
+
+const BigInt ZERO(static_cast<unsigned long int>(0));
+const BigInt ONE(static_cast<unsigned long int>(1));
+
+BigInt hex(const char* digits) {
+    return BigInt(digits, 16);
+}
+
+bool sameCurve(const CurveParameters& a, const CurveParameters& b) {
+    return a.p == b.p && a.a == b.a && a.b == b.b;
+}
+
+// SHA-256 after absorbing the 64-byte zero block Z_pad that starts every msg_prime.
+const Sha256& paddedHasher() {
+    static const Sha256 hasher = [] {
+        Sha256 h;
+        h.update(std::string(64, '\0'));
+        return h;
+    }();
+    return hasher;
+}
+
+} // namespace
+
+std::string expandMessageXmd(const std::string& message, const std::string& dst, size_t length) {
+    const size_t digestSize = Sha256::DIGEST_SIZE;
+    size_t blocks = (length + digestSize - 1) / digestSize;
+    if (dst.empty()) {
+        throw std::invalid_argument("Domain separation tag must not be empty.");
+    }
+    if (length == 0 || blocks > 255) {
+        throw std::invalid_argument("expand_message_xmd length must be between 1 and 8160 bytes.");
+    }
+    std::string tag = dst.size() > 255 ? Sha256::digest("H2C-OVERSIZE-DST-" + dst) : dst;
+    std::string dstPrime = tag + static_cast<char>(tag.size());
+
+    uint8_t b0[digestSize];
+    Sha256 h0 = paddedHasher();
+    h0.update(message);
+    h0.update(std::string{ static_cast<char>(length >> 8), static_cast<char>(length), '\0' });
+    h0.update(dstPrime);
+    h0.finish(b0);
+
+    std::string out;
+    out.reserve(blocks * digestSize);
+    uint8_t bi[digestSize];
+    uint8_t input[digestSize];
+    for (size_t i = 1; i <= blocks; ++i) {
+        for (size_t j = 0; j < digestSize; ++j) {
+            input[j] = i == 1 ? b0[j] : static_cast<uint8_t>(b0[j] ^ bi[j]);
+        }
+        Sha256 h;
+        h.update(input, digestSize);
+        h.update(std::string(1, static_cast<char>(i)));
+        h.update(dstPrime);
+        h.finish(bi);
+        out.append(reinterpret_cast<const char*>(bi), digestSize);
+    }
+    out.resize(length);
+    return out;
+}
+
+HashToCurve::HashToCurve(const CurveParameters& curve, const std::string& tag)
+    : prototype(curve.Gx, curve.Gy, curve), arithmetic(prototype), dst(tag), isogeny(false) {
+    if (tag.empty()) {
+        throw std::invalid_argument("Domain separation tag must not be empty.");
+    }
+    const FieldBackend& field = *prototype.getField();
+    const BigInt& p = curve.p;
+    if (sameCurve(curve, CurveParameters::p256())) {
+        A = curve.a;
+        B = curve.b;
+        Z = p - BigInt(static_cast<unsigned long int>(10));
+    } else if (sameCurve(curve, CurveParameters::secp256k1())) {
+        // E′: y² = x³ + A′x + B′, 3-isogenous to secp256k1 (RFC 9380 section 8.7 and appendix E.1).
+        A = hex("3f8731abdd661adca08a5558f0f5d272e953d363cb6f0e5d405447c01a444533");
+        B = BigInt(static_cast<unsigned long int>(1771));
+        Z = p - BigInt(static_cast<unsigned long int>(11));
+        isogeny = true;
+        xNum = { hex("8e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38daaaaa8c7"),
+                 hex("07d3d4c80bc321d5b9f315cea7fd44c5d595d2fc0bf63b92dfff1044f17c6581"),
+                 hex("534c328d23f234e6e2a413deca25caece4506144037c40314ecbd0b53d9dd262"),
+                 hex("8e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38e38daaaaa88c") };
+        xDen = { hex("d35771193d94918a9ca34ccbb7b640dd86cd409542f8487d9fe6b745781eb49b"),
+                 hex("edadc6f64383dc1df7c4b2d51b54225406d36b641f5e41bbc52a56612a8c6d14"),
+                 ONE };
+        yNum = { hex("4bda12f684bda12f684bda12f684bda12f684bda12f684bda12f684b8e38e23c"),
+                 hex("c75e0c32d5cb7c0fa9d0a54b12a0a6d5647ab046d686da6fdffc90fc201d71a3"),
+                 hex("29a6194691f91a73715209ef6512e576722830a201be2018a765e85a9ecee931"),
+                 hex("2f684bda12f684bda12f684bda12f684bda12f684bda12f684bda12f38e38d84") };
+        yDen = { hex("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffff93b"),
+                 hex("7a06534bb8bdb49fd5e9e6632722c2989467c1bfc8e8d978dfb425d2685c2573"),
+                 hex("6484aa716545ca2cf3a70c3fa8fe337e0a3d21162f0d6299a7bf8192bfd2a76f"),
+                 ONE };
+    } else {
+        throw std::invalid_argument("Hash-to-curve is only defined for P-256 and secp256k1.");
+    }
+    field.reduce(A);
+    c1 = (p - BigInt(static_cast<unsigned long int>(3))) / BigInt(static_cast<unsigned long int>(4));
+    if (!field.sqrt(field.sub(ZERO, Z), c2)) {
+        throw std::runtime_error("Hash-to-curve constant -Z is not a square.");
+    }
+}
+
+std::vector<BigInt> HashToCurve::hashToField(const std::string& message, size_t count) const {
+    std::string bytes = expandMessageXmd(message, dst, count * ELEMENT_BYTES);
+    std::vector<BigInt> elements(count);
+    for (size_t i = 0; i < count; ++i) {
+        mpz_import(elements[i].get_mpz_t(), ELEMENT_BYTES, 1, 1, 1, 0, bytes.data() + i * ELEMENT_BYTES);
+        prototype.getField()->reduce(elements[i]);
+    }
+    return elements;
+}
+
+// sqrt_ratio for p ≡ 3 (mod 4), RFC 9380 appendix F.2.1.2: one exponentiation yields √(u/v) when
+// u/v is a square and √(Z·u/v) otherwise, with no inversion of v.
+void HashToCurve::sqrtRatio(const BigInt& u, const BigInt& v, bool& square, BigInt& root) const {
+    const FieldBackend& field = *prototype.getField();
+    BigInt tv2 = field.mul(u, v);
+    BigInt tv1 = field.mul(field.sqr(v), tv2);
+    BigInt y1;
+    mpz_powm_sec(y1.get_mpz_t(), tv1.get_mpz_t(), c1.get_mpz_t(), getCurve().p.get_mpz_t());
+    y1 = field.mul(y1, tv2);
+    BigInt y2 = field.mul(y1, c2);
+    square = field.mul(field.sqr(y1), v) == u;
+    root = square ? y1 : y2;
+}
+
+// Σ cᵢ·xnⁱ·xd^(d−i) for a polynomial of degree d: the numerator of c(xn/xd) over xd^d.
+BigInt HashToCurve::horner(const std::vector<BigInt>& coefficients, const BigInt& xn, const std::vector<BigInt>& xdPowers) const {
+    const FieldBackend& field = *prototype.getField();
+    size_t degree = coefficients.size() - 1;
+    BigInt acc = coefficients[degree];
+    for (size_t i = degree; i-- > 0;) {
+        acc = field.add(field.mul(acc, xn), field.mul(coefficients[i], xdPowers[degree - i]));
+    }
+    return acc;
+}
+
+// map_to_curve_simple_swu, RFC 9380 appendix F.2, followed by the isogeny for secp256k1. The
+// result is returned in Jacobian form so that no division is needed.
+JacobianPoint HashToCurve::map(const BigInt& u) const {
+    const FieldBackend& field = *prototype.getField();
+    BigInt tv1 = field.mul(Z, field.sqr(u));
+    BigInt tv2 = field.add(field.sqr(tv1), tv1);
+    BigInt tv3 = field.mul(B, field.add(tv2, ONE));
+    BigInt tv4 = field.mul(A, tv2.isZero() ? Z : field.sub(ZERO, tv2));
+    BigInt tv6 = field.sqr(tv4);
+    BigInt gx = field.mul(field.add(field.sqr(tv3), field.mul(A, tv6)), tv3);
+    tv6 = field.mul(tv6, tv4);
+    gx = field.add(gx, field.mul(B, tv6));
+
+    // gx / tv6 is g(x1) for x1 = tv3 / tv4; when it is not a square, x2 = tv1·x1 is used instead.
+    bool square;
+    BigInt y1;
+    sqrtRatio(gx, tv6, square, y1);
+    BigInt xn = square ? tv3 : field.mul(tv1, tv3);
+    BigInt y = square ? y1 : field.mul(field.mul(tv1, u), y1);
+    if (mpz_odd_p(u.get_mpz_t()) != mpz_odd_p(y.get_mpz_t())) {
+        y = field.sub(ZERO, y);
+    }
+    const BigInt& xd = tv4;
+
+    BigInt xNumer, xDenom, yNumer, yDenom;
+    if (isogeny) {
+        std::vector<BigInt> xdPowers = { ONE, xd, field.sqr(xd) };
+        xdPowers.push_back(field.mul(xdPowers[2], xd));
+        xNumer = horner(xNum, xn, xdPowers);
+        xDenom = field.mul(xd, horner(xDen, xn, xdPowers));
+        yNumer = field.mul(y, horner(yNum, xn, xdPowers));
+        yDenom = horner(yDen, xn, xdPowers);
+    } else {
+        xNumer = xn;
+        xDenom = xd;
+        yNumer = y;
+        yDenom = ONE;
+    }
+
+    // (xN/xD, yN/yD) = (X/Z², Y/Z³) for Z = xD·yD, X = xN·xD·yD², Y = yN·xD³·yD². A zero
+    // isogeny denominator gives Z = 0, the point at infinity, as the RFC specifies.
+    JacobianPoint result;
+    BigInt yDenom2 = field.sqr(yDenom);
+    BigInt xDenom2 = field.sqr(xDenom);
+    result.Z = field.mul(xDenom, yDenom);
+    result.X = field.mul(field.mul(xNumer, xDenom), yDenom2);
+    result.Y = field.mul(field.mul(yNumer, field.mul(xDenom2, xDenom)), yDenom2);
+    return result;
+}
+
+JacobianPoint HashToCurve::hashJacobian(const std::string& message) const {
+    std::vector<BigInt> u = hashToField(message, 2);
+    return arithmetic.add(map(u[0]), map(u[1]));
+}
+
+Ecc_Point HashToCurve::hash(const std::string& message) const {
+    return arithmetic.toAffine(hashJacobian(message));
+}
+
+Ecc_Point HashToCurve::encode(const std::string& message) const {
+    return arithmetic.toAffine(map(hashToField(message, 1)[0]));
+}
+
+Ecc_Point HashToCurve::mapToCurve(const BigInt& u) const {
+    BigInt reduced = u;
+    prototype.getField()->reduce(reduced);
+    return arithmetic.toAffine(map(reduced));
+}
+
+void HashToCurve::hashBatch(const std::vector<std::string>& messages, PointVector& out, unsigned threads) const {
+    if (out.getCurve().p != getCurve().p) {
+        throw std::invalid_argument("Point vector is on another curve.");
+    }
+    out.resize(messages.size());
+    size_t blocks = (messages.size() + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    parallelFor(blocks, [&](size_t b) {
+        size_t begin = b * BATCH_BLOCK;
+        size_t end = std::min(messages.size(), begin + BATCH_BLOCK);
+        std::vector<JacobianPoint> sums;
+        sums.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            sums.push_back(hashJacobian(messages[i]));
+        }
+        PointVector block(getCurve());
+        arithmetic.toAffineBatch(sums, block);
+        for (size_t i = begin; i < end; ++i) {
+            if (block.isInfinity(i - begin)) {
+                out.setInfinity(i);
+            } else {
+                out.setAffineLimbs(i, block.xLimbs(i - begin), block.yLimbs(i - begin));
+            }
+        }
+    }, threads);
+}
+
+std::vector<Ecc_Point> HashToCurve::hashBatch(const std::vector<std::string>& messages, unsigned threads) const {
+    PointVector points(getCurve());
+    hashBatch(messages, points, threads);
+    return points.toPoints();
+}
@@ -1,18 +1,15 @@
 #include "../include/bigint.hpp"
+#include "../include/interpolation.hpp"
 #include <vector>
 #include <iostream>
 
-struct Data {
-    BigInt x, y;
-
-    Data(const std::string& xStr, const std::string& yStr, const std::string& modStr) {
-        x = BigInt(xStr, 10);
-        y = BigInt(yStr, 10);
-        // Assuming modulus is applied for each operation
-        x %= BigInt(modStr, 10);
-        y %= BigInt(modStr, 10);
-    }
-};
+Data::Data(const std::string& xStr, const std::string& yStr, const std::string& modStr) {
+    x = BigInt(xStr, 10);
+    y = BigInt(yStr, 10);
+    // Assuming modulus is applied for each operation
+    x %= BigInt(modStr, 10);
+    y %= BigInt(modStr, 10);
+}
 
 BigInt interpolate(const std::vector<Data>& f, const BigInt& xi, const std::string& modStr) {
     BigInt result("0", 10);
@@ -35,6 +32,7 @@ BigInt interpolate(const std::vector<Data>& f, const BigInt& xi, const std::stri
     return result;
 }
 
+#ifndef ZKSNARKS_LIBRARY
 int main() {
     std::vector<Data> points = {
         Data("1", "1", "101"),   // 1^2 = 1
@@ -51,3 +49,4 @@ int main() {
 
     return 0;
 }
+#endif // ZKSNARKS_LIBRARY
@@ -0,0 +1,118 @@
+#include "../include/io.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void storeLE(unsigned char* out, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+}
+
+void storeLE(std::vector<unsigned char>& out, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    }
+}
+
+uint64_t loadLE(const unsigned char* in, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        v |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return v;
+}
+
+void readAt(int fd, unsigned char* data, size_t size, off_t offset, const std::string& what) {
+    while (size > 0) {
+        ssize_t got = pread(fd, data, size, offset);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) {
+            throw std::runtime_error("Failed to read " + what + ".");
+        }
+        data += got;
+        size -= got;
+        offset += got;
+    }
+}
+
+void writeAt(int fd, const unsigned char* data, size_t size, off_t offset, const std::string& what) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write " + what + ": " + std::strerror(errno));
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+}
+
+FileHandle::FileHandle(const std::string& path, int flags, const std::string& what)
+    : fd(open(path.c_str(), flags, 0644)) {
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + what + " " + path + ": " + std::strerror(errno));
+    }
+}
+
+FileHandle::~FileHandle() {
+    close(fd);
+}
+
+MappedFile::MappedFile(const std::string& path, Mode mode, size_t createBytes) : data(nullptr), bytes(createBytes) {
+    int flags = mode == ReadOnly ? O_RDONLY : mode == ReadWrite ? O_RDWR : (O_RDWR | O_CREAT | O_TRUNC);
+    int fd = open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (mode == Create) {
+        if (ftruncate(fd, bytes) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot size " + path + ".");
+        }
+    } else if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot read the size of " + path + ".");
+    } else {
+        bytes = static_cast<size_t>(info.st_size);
+    }
+    // mmap rejects empty ranges; an empty file simply has no bytes to map.
+    if (bytes > 0) {
+        void* mapped = mode == ReadOnly ? mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0)
+                                        : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+        }
+        data = static_cast<unsigned char*>(mapped);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        munmap(data, bytes);
+    }
+}
+
+void MappedFile::adviseSequential() const {
+    if (data != nullptr) {
+        madvise(data, bytes, MADV_SEQUENTIAL);
+    }
+}
+
+void MappedFile::release(size_t offset, size_t length) const {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    size_t end = std::min(bytes, offset + length);
+    if (end > begin) {
+        madvise(data + begin, end - begin, MADV_DONTNEED);
+    }
+}
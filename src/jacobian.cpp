@@ -0,0 +1,225 @@
+#include "../include/bigint.hpp"
+#include "../include/ecc.hpp"
+#include "../include/jacobian.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+JacobianArithmetic::JacobianArithmetic(const Ecc_Point& curvePoint)
+    : prototype(curvePoint), a(curvePoint.getCurveParameters().a) {
+    if (curvePoint.getField() == nullptr) {
+        throw std::invalid_argument("Curve point must not be a default-constructed point at infinity.");
+    }
+    field = FieldBackend::forModulus(curvePoint.getP());
+}
+
+JacobianPoint JacobianArithmetic::fromAffine(const Ecc_Point& point) const {
+    JacobianPoint result;
+    if (!point.isInfinity) {
+        result.X = point.getX();
+        result.Y = point.getY();
+        result.Z = BigInt(static_cast<unsigned long int>(1));
+    }
+    return result;
+}
+
+Ecc_Point JacobianArithmetic::toAffine(const JacobianPoint& point) const {
+    if (point.isInfinity()) {
+        return Ecc_Point();
+    }
+    BigInt zInv = field->inv(point.Z);
+    BigInt zInv2 = field->sqr(zInv);
+    return prototype.withCoordinates(field->mul(point.X, zInv2), field->mul(point.Y, field->mul(zInv2, zInv)));
+}
+
+std::vector<Ecc_Point> JacobianArithmetic::toAffineBatch(const std::vector<JacobianPoint>& points) const {
+    PointVector affine(prototype.getCurveParameters());
+    toAffineBatch(points, affine);
+    return affine.toPoints();
+}
+
+void JacobianArithmetic::toAffineBatch(const std::vector<JacobianPoint>& points, PointVector& result) const {
+    result.resize(points.size());
+
+    // prefix[i] holds the product of all non-zero Z coordinates before index i.
+    std::vector<BigInt> prefix(points.size());
+    BigInt acc(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < points.size(); ++i) {
+        prefix[i] = acc;
+        if (!points[i].isInfinity()) {
+            acc = field->mul(acc, points[i].Z);
+        }
+    }
+
+    BigInt inv = field->inv(acc);
+    for (size_t i = points.size(); i-- > 0;) {
+        if (points[i].isInfinity()) {
+            result.setInfinity(i);
+            continue;
+        }
+        BigInt zInv = field->mul(inv, prefix[i]);
+        inv = field->mul(inv, points[i].Z);
+        BigInt zInv2 = field->sqr(zInv);
+        result.setAffine(i, field->mul(points[i].X, zInv2), field->mul(points[i].Y, field->mul(zInv2, zInv)));
+    }
+}
+
+JacobianPoint JacobianArithmetic::dbl(const JacobianPoint& p) const {
+    if (p.isInfinity() || p.Y.isZero()) {
+        return JacobianPoint();
+    }
+    BigInt XX = field->sqr(p.X);
+    BigInt YY = field->sqr(p.Y);
+    BigInt YYYY = field->sqr(YY);
+    BigInt ZZ = field->sqr(p.Z);
+    BigInt S = field->sub(field->sqr(p.X + YY), XX + YYYY);
+    S = field->add(S, S);
+    BigInt M = XX + XX + XX;
+    if (!a.isZero()) {
+        M += field->mul(a, field->sqr(ZZ));
+    }
+    field->reduce(M);
+
+    JacobianPoint result;
+    result.X = field->sub(field->sqr(M), S + S);
+    BigInt eightYYYY = YYYY.leftShift(3);
+    result.Y = field->sub(field->mul(M, S - result.X), eightYYYY);
+    result.Z = field->sub(field->sqr(p.Y + p.Z), YY + ZZ);
+    return result;
+}
+
+JacobianPoint JacobianArithmetic::add(const JacobianPoint& p, const JacobianPoint& q) const {
+    if (p.isInfinity()) return q;
+    if (q.isInfinity()) return p;
+
+    BigInt Z1Z1 = field->sqr(p.Z);
+    BigInt Z2Z2 = field->sqr(q.Z);
+    BigInt U1 = field->mul(p.X, Z2Z2);
+    BigInt U2 = field->mul(q.X, Z1Z1);
+    BigInt S1 = field->mul(p.Y, field->mul(q.Z, Z2Z2));
+    BigInt S2 = field->mul(q.Y, field->mul(p.Z, Z1Z1));
+    BigInt H = field->sub(U2, U1);
+    BigInt r = field->sub(S2, S1);
+    if (H.isZero()) {
+        return r.isZero() ? dbl(p) : JacobianPoint();
+    }
+    r = field->add(r, r);
+    BigInt I = field->sqr(H + H);
+    BigInt J = field->mul(H, I);
+    BigInt V = field->mul(U1, I);
+
+    JacobianPoint result;
+    result.X = field->sub(field->sqr(r), J + V + V);
+    BigInt S1J = field->mul(S1, J);
+    result.Y = field->sub(field->mul(r, V - result.X), S1J + S1J);
+    result.Z = field->mul(field->sub(field->sqr(p.Z + q.Z), Z1Z1 + Z2Z2), H);
+    return result;
+}
+
+JacobianPoint JacobianArithmetic::addMixed(const JacobianPoint& p, const Ecc_Point& q) const {
+    if (q.isInfinity) return p;
+    return addMixed(p, q.getX(), q.getY());
+}
+
+JacobianPoint JacobianArithmetic::addMixed(const JacobianPoint& p, const BigInt& x, const BigInt& y) const {
+    if (p.isInfinity()) {
+        JacobianPoint result;
+        result.X = x;
+        result.Y = y;
+        result.Z = BigInt(static_cast<unsigned long int>(1));
+        return result;
+    }
+
+    BigInt Z1Z1 = field->sqr(p.Z);
+    BigInt U2 = field->mul(x, Z1Z1);
+    BigInt S2 = field->mul(y, field->mul(p.Z, Z1Z1));
+    BigInt H = field->sub(U2, p.X);
+    BigInt r = field->sub(S2, p.Y);
+    if (H.isZero()) {
+        return r.isZero() ? dbl(p) : JacobianPoint();
+    }
+    r = field->add(r, r);
+    BigInt HH = field->sqr(H);
+    BigInt I = field->add(HH + HH, HH + HH);
+    BigInt J = field->mul(H, I);
+    BigInt V = field->mul(p.X, I);
+
+    JacobianPoint result;
+    result.X = field->sub(field->sqr(r), J + V + V);
+    BigInt Y1J = field->mul(p.Y, J);
+    result.Y = field->sub(field->mul(r, V - result.X), Y1J + Y1J);
+    result.Z = field->sub(field->sqr(p.Z + H), Z1Z1 + HH);
+    return result;
+}
+
+JacobianPoint JacobianArithmetic::negate(const JacobianPoint& p) const {
+    JacobianPoint result = p;
+    if (!p.isInfinity()) {
+        result.Y = field->sub(BigInt(static_cast<unsigned long int>(0)), p.Y);
+    }
+    return result;
+}
+
+JacobianPoint JacobianArithmetic::mulDouble(const Ecc_Point& p, const BigInt& k1, const Ecc_Point& q, const BigInt& k2) const {
+    const int w = 5;
+    const size_t tableSize = static_cast<size_t>(1) << (w - 2);
+
+    // Odd multiples 1P, 3P, ..., (2^(w-1) - 1)P for both bases, normalized to affine for mixed additions.
+    std::vector<JacobianPoint> odd;
+    odd.reserve(2 * tableSize);
+    const Ecc_Point* bases[2] = { &p, &q };
+    for (const Ecc_Point* base : bases) {
+        JacobianPoint current = fromAffine(*base);
+        JacobianPoint twice = dbl(current);
+        for (size_t i = 0; i < tableSize; ++i) {
+            odd.push_back(current);
+            current = add(current, twice);
+        }
+    }
+    std::vector<Ecc_Point> table = toAffineBatch(odd);
+
+    std::vector<int> naf1 = computeWNAF(k1, w);
+    std::vector<int> naf2 = computeWNAF(k2, w);
+    size_t length = std::max(naf1.size(), naf2.size());
+
+    JacobianPoint result;
+    for (size_t i = length; i-- > 0;) {
+        result = dbl(result);
+        int digits[2] = { i < naf1.size() ? naf1[i] : 0, i < naf2.size() ? naf2[i] : 0 };
+        for (int j = 0; j < 2; ++j) {
+            if (digits[j] > 0) {
+                result = addMixed(result, table[j * tableSize + digits[j] / 2]);
+            } else if (digits[j] < 0) {
+                result = addMixed(result, -table[j * tableSize + (-digits[j]) / 2]);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<int> computeWNAF(const BigInt& k, int w) {
+    if (w < 2 || w > 16) {
+        throw std::invalid_argument("wNAF width must be between 2 and 16.");
+    }
+    std::vector<int> naf;
+    mpz_t n;
+    mpz_init_set(n, k.get_mpz_t());
+    const long modulus = 1L << w;
+    while (mpz_sgn(n) > 0) {
+        int digit = 0;
+        if (mpz_odd_p(n)) {
+            digit = static_cast<int>(mpz_fdiv_ui(n, modulus));
+            if (digit >= modulus / 2) {
+                digit -= static_cast<int>(modulus);
+            }
+            if (digit > 0) {
+                mpz_sub_ui(n, n, digit);
+            } else {
+                mpz_add_ui(n, n, -digit);
+            }
+        }
+        naf.push_back(digit);
+        mpz_fdiv_q_2exp(n, n, 1);
+    }
+    mpz_clear(n);
+    return naf;
+}
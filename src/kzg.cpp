@@ -0,0 +1,398 @@
+#include "../include/bigint.hpp"
+#include "../include/kzg.hpp"
+#include "../include/msm.hpp"
+#include "../include/parallel.hpp"
+#include "../include/sha256.hpp"
+#include "../include/srs.hpp"
+#include <stdexcept>
+
+namespace {
+
+void absorb(std::string& transcript, const BigInt& v) {
+    transcript += v.toString(16);
+    transcript += ',';
+}
+
+void absorb(std::string& transcript, const Ecc_Point& p) {
+    if (p.isInfinity) {
+        transcript += "inf,";
+        return;
+    }
+    absorb(transcript, p.getX());
+    absorb(transcript, p.getY());
+}
+
+BigInt challenge(const std::string& transcript, const BigInt& mod) {
+    BigInt result;
+    std::string digest = Sha256::digest(transcript);
+    mpz_import(result.get_mpz_t(), digest.size(), 1, 1, 1, 0, digest.data());
+    return result % mod;
+}
+
+BigInt foldChallenge(const std::vector<Ecc_Point>& commitments, const std::vector<BigInt>& points,
+                     const std::vector<std::vector<BigInt>>& values, const BigInt& mod) {
+    std::string transcript = "kzg-batch-gamma,";
+    for (const Ecc_Point& c : commitments) absorb(transcript, c);
+    for (const BigInt& z : points) absorb(transcript, z);
+    for (const std::vector<BigInt>& row : values) {
+        for (const BigInt& v : row) absorb(transcript, v);
+    }
+    return challenge(transcript, mod);
+}
+
+// The challenge x at which the combined batch polynomial is opened, drawn after the commitment to h.
+BigInt pointChallenge(const BigInt& gamma, const BigInt& rho, const Ecc_Point& quotient, const BigInt& mod) {
+    std::string transcript = "kzg-batch-x,";
+    absorb(transcript, gamma);
+    absorb(transcript, rho);
+    absorb(transcript, quotient);
+    return challenge(transcript, mod);
+}
+
+BigInt separationChallenge(const BigInt& gamma, const BigInt& mod) {
+    std::string transcript = "kzg-batch-rho,";
+    absorb(transcript, gamma);
+    return challenge(transcript, mod);
+}
+
+// Z_{T∖j}(x) = Π_{k≠j} (x − zₖ) for every j, from prefix and suffix products; full receives Z_T(x).
+std::vector<BigInt> vanishingExcept(const std::vector<BigInt>& points, const BigInt& x, const FieldBackend& field,
+                                    BigInt& full) {
+    size_t m = points.size();
+    std::vector<BigInt> factors(m);
+    for (size_t j = 0; j < m; ++j) {
+        factors[j] = field.sub(x, points[j]);
+    }
+    std::vector<BigInt> products(m);
+    BigInt running(static_cast<unsigned long int>(1));
+    for (size_t j = 0; j < m; ++j) {
+        products[j] = running;
+        running = field.mul(running, factors[j]);
+    }
+    full = running;
+    running = BigInt(static_cast<unsigned long int>(1));
+    for (size_t j = m; j-- > 0;) {
+        products[j] = field.mul(products[j], running);
+        running = field.mul(running, factors[j]);
+    }
+    return products;
+}
+
+// sum += scale · terms, coefficient-wise.
+void addScaled(std::vector<BigInt>& sum, const std::vector<BigInt>& terms, const BigInt& scale, const FieldBackend& field) {
+    if (sum.size() < terms.size()) {
+        sum.resize(terms.size());
+    }
+    for (size_t i = 0; i < terms.size(); ++i) {
+        sum[i] = field.add(sum[i], field.mul(scale, terms[i]));
+    }
+}
+
+// Replaces every nonzero entry by its inverse with a single field inversion (Montgomery's trick).
+void batchInvert(std::vector<BigInt>& values, const FieldBackend& field) {
+    std::vector<BigInt> prefix(values.size());
+    BigInt running(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < values.size(); ++i) {
+        prefix[i] = running;
+        if (!values[i].isZero()) {
+            running = field.mul(running, values[i]);
+        }
+    }
+    BigInt inverse = field.inv(running);
+    for (size_t i = values.size(); i-- > 0;) {
+        if (values[i].isZero()) {
+            continue;
+        }
+        BigInt next = field.mul(inverse, values[i]);
+        values[i] = field.mul(inverse, prefix[i]);
+        inverse = next;
+    }
+}
+
+} // namespace
+
+KZGSetup kzgSetup(const CurveParameters& curve, const BigInt& tau, size_t maxDegree) {
+    KZGSetup setup;
+    setup.modulus = curve.n;
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+    std::vector<BigInt> powers(maxDegree + 1);
+    BigInt power(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i <= maxDegree; ++i) {
+        powers[i] = power;
+        power = (power * tau) % curve.n;
+    }
+    setup.powersOfTau = FixedBaseTable(g).multiplyBatch(powers);
+    return setup;
+}
+
+KZGSetup kzgLoadSetup(const std::string& path, const CurveParameters& curve) {
+    KZGSetup setup;
+    setup.modulus = curve.n;
+    setup.powersOfTau = readPowersOfTau(path, curve);
+    return setup;
+}
+
+Ecc_Point kzgCommit(const KZGSetup& setup, const Polynomial& poly) {
+    if (poly.getMod() != setup.modulus) {
+        throw std::invalid_argument("Polynomial modulus must match the scalar field of the setup.");
+    }
+    if (static_cast<size_t>(poly.deg() + 1) > setup.powersOfTau.size()) {
+        throw std::invalid_argument("Polynomial degree exceeds the size of the reference string.");
+    }
+    if (poly.isSparse()) {
+        std::vector<Ecc_Point> bases;
+        std::vector<BigInt> scalars;
+        for (const SparseTerm& term : poly.getTerms()) {
+            bases.push_back(setup.powersOfTau[term.exponent]);
+            scalars.push_back(term.coeff);
+        }
+        return multiScalarMul(bases, scalars);
+    }
+    const std::vector<BigInt>& coeffs = poly.getCoefficients();
+    std::vector<Ecc_Point> bases(setup.powersOfTau.begin(), setup.powersOfTau.begin() + coeffs.size());
+    return multiScalarMul(bases, coeffs);
+}
+
+KZGOpening kzgOpen(const KZGSetup& setup, const Polynomial& poly, const BigInt& point) {
+    KZGOpening opening;
+    opening.point = point % setup.modulus;
+    Polynomial quotient(std::vector<BigInt>(), setup.modulus);
+    divideByLinear(quotient, opening.value, poly, opening.point);
+    opening.witness = kzgCommit(setup, quotient);
+    return opening;
+}
+
+std::vector<Ecc_Point> kzgLagrangeBasis(const KZGSetup& setup, const EvaluationDomain& domain, unsigned threads) {
+    if (domain.modulus() != setup.modulus) {
+        throw std::invalid_argument("Domain modulus must match the scalar field of the setup.");
+    }
+    size_t n = domain.size();
+    if (n > setup.powersOfTau.size()) {
+        throw std::invalid_argument("Domain exceeds the size of the reference string.");
+    }
+    std::vector<Ecc_Point> points(setup.powersOfTau.begin(), setup.powersOfTau.begin() + n);
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(points[i], points[j]);
+        }
+    }
+
+    // Radix-2 butterflies with ω⁻¹ twiddles; the twiddle products of a level form one batch.
+    for (size_t half = 1; half < n; half <<= 1) {
+        size_t stride = n / (2 * half);
+        std::vector<Ecc_Point> odd;
+        std::vector<BigInt> twiddles;
+        odd.reserve(n / 2);
+        twiddles.reserve(n / 2);
+        for (size_t start = 0; start < n; start += 2 * half) {
+            for (size_t k = 0; k < half; ++k) {
+                odd.push_back(points[start + half + k]);
+                twiddles.push_back(domain.element(n - k * stride));
+            }
+        }
+        std::vector<Ecc_Point> products = batchScalarMul(odd, twiddles, threads);
+        parallelFor(n / 2, [&](size_t b) {
+            size_t start = (b / half) * 2 * half;
+            size_t k = b % half;
+            Ecc_Point even = points[start + k];
+            points[start + k] = even + products[b];
+            points[start + half + k] = even + (-products[b]);
+        }, threads);
+    }
+    return batchScalarMul(points, std::vector<BigInt>(n, domain.sizeInverse()), threads);
+}
+
+KZGOpening kzgOpenEvaluations(const std::vector<Ecc_Point>& lagrangeBasis, const EvaluationDomain& domain,
+                              const std::vector<BigInt>& values, const BigInt& point) {
+    size_t n = domain.size();
+    if (lagrangeBasis.size() != n) {
+        throw std::invalid_argument("Lagrange basis does not match the domain.");
+    }
+    if (values.size() > n) {
+        throw std::invalid_argument("More evaluations than domain points.");
+    }
+    const FieldBackend& field = domain.getField();
+    KZGOpening opening;
+    opening.point = point;
+    field.reduce(opening.point);
+
+    // differences[i] = 1/(ωⁱ − z), with the entry of z itself left at zero when z is on the domain.
+    std::vector<BigInt> omegas(n);
+    std::vector<BigInt> v(n);
+    std::vector<BigInt> differences(n);
+    size_t onDomain = n;
+    BigInt omega(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < n; ++i) {
+        omegas[i] = omega;
+        if (i < values.size()) {
+            v[i] = values[i];
+            field.reduce(v[i]);
+        }
+        differences[i] = field.sub(omega, opening.point);
+        if (differences[i].isZero()) {
+            onDomain = i;
+        }
+        omega = field.mul(omega, domain.generator());
+    }
+    batchInvert(differences, field);
+
+    std::vector<BigInt> quotient(n);
+    if (onDomain == n) {
+        // f(z) = (zⁿ − 1)/n · Σ vᵢ·ωⁱ/(z − ωⁱ)
+        BigInt sum;
+        for (size_t i = 0; i < n; ++i) {
+            sum = field.add(sum, field.mul(field.mul(v[i], omegas[i]), differences[i]));
+        }
+        BigInt scale = field.mul(domain.evaluateVanishing(opening.point), domain.sizeInverse());
+        opening.value = field.sub(BigInt(), field.mul(scale, sum));
+    } else {
+        opening.value = v[onDomain];
+    }
+    BigInt weighted;
+    for (size_t i = 0; i < n; ++i) {
+        if (i == onDomain) {
+            continue;
+        }
+        quotient[i] = field.mul(field.sub(v[i], opening.value), differences[i]);
+        if (onDomain != n) {
+            weighted = field.add(weighted, field.mul(quotient[i], omegas[i]));
+        }
+    }
+    if (onDomain != n) {
+        // q(ωᵐ) = f'(ωᵐ) = −ω⁻ᵐ · Σ_{i≠m} q(ωⁱ)·ωⁱ
+        quotient[onDomain] = field.sub(BigInt(), field.mul(weighted, domain.element(n - onDomain)));
+    }
+    opening.witness = multiScalarMul(lagrangeBasis, quotient);
+    return opening;
+}
+
+bool kzgVerify(const KZGVerifierKey& vk, const Ecc_Point& commitment, const KZGOpening& opening) {
+    const BigInt& n = vk.g.getCurveParameters().n;
+    std::vector<Ecc_Point> points = { commitment, vk.g, opening.witness };
+    std::vector<BigInt> scalars = { BigInt(static_cast<unsigned long int>(1)), n - opening.value % n, (opening.point - vk.tau) % n };
+    return multiScalarMul(points, scalars).isInfinity;
+}
+
+KZGBatchOpening kzgBatchOpen(const KZGSetup& setup, const std::vector<Polynomial>& polys,
+                             const std::vector<Ecc_Point>& commitments, const std::vector<BigInt>& points,
+                             const std::vector<std::vector<size_t>>& openSets) {
+    if (polys.size() != commitments.size() || points.size() != openSets.size()) {
+        throw std::invalid_argument("Batch opening inputs have mismatched sizes.");
+    }
+    const BigInt& n = setup.modulus;
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(n);
+    KZGBatchOpening opening;
+    opening.openSets = openSets;
+
+    // Evaluate every requested polynomial at its point first, since the values are bound into gamma.
+    for (size_t j = 0; j < points.size(); ++j) {
+        opening.points.push_back(points[j] % n);
+        std::vector<BigInt> row;
+        for (size_t index : openSets[j]) {
+            if (index >= polys.size()) {
+                throw std::invalid_argument("Open set refers to a polynomial that does not exist.");
+            }
+            row.push_back(polys[index].evaluate(opening.points[j]));
+        }
+        opening.values.push_back(row);
+    }
+    BigInt gamma = foldChallenge(commitments, opening.points, opening.values, n);
+    BigInt rho = separationChallenge(gamma, n);
+
+    // Fⱼ = Σ γᵏ·fₖ over the polynomials opened at zⱼ, and h = Σ ρʲ·(Fⱼ − vⱼ)/(X − zⱼ).
+    std::vector<std::vector<BigInt>> folded(points.size());
+    std::vector<BigInt> foldedValues(points.size());
+    std::vector<BigInt> h;
+    BigInt rhoPower(static_cast<unsigned long int>(1));
+    for (size_t j = 0; j < points.size(); ++j) {
+        BigInt weight(static_cast<unsigned long int>(1));
+        for (size_t index : openSets[j]) {
+            addScaled(folded[j], polys[index].getCoefficients(), weight, *field);
+            weight = field->mul(weight, gamma);
+        }
+        Polynomial quotient(std::vector<BigInt>(), n);
+        divideByLinear(quotient, foldedValues[j], Polynomial(folded[j], n), opening.points[j]);
+        addScaled(h, quotient.getCoefficients(), rhoPower, *field);
+        rhoPower = field->mul(rhoPower, rho);
+    }
+    opening.quotient = kzgCommit(setup, Polynomial(h, n));
+
+    // L = Σ ρʲ·Z_{T∖j}(x)·(Fⱼ − vⱼ) − Z_T(x)·h vanishes at x, so one quotient by (X − x) proves it.
+    BigInt x = pointChallenge(gamma, rho, opening.quotient, n);
+    BigInt vanishing;
+    std::vector<BigInt> partial = vanishingExcept(opening.points, x, *field, vanishing);
+    std::vector<BigInt> combined;
+    addScaled(combined, h, field->sub(BigInt(), vanishing), *field);
+    rhoPower = BigInt(static_cast<unsigned long int>(1));
+    for (size_t j = 0; j < points.size(); ++j) {
+        if (folded[j].empty()) {
+            folded[j].push_back(BigInt());
+        }
+        folded[j][0] = field->sub(folded[j][0], foldedValues[j]);
+        addScaled(combined, folded[j], field->mul(rhoPower, partial[j]), *field);
+        rhoPower = field->mul(rhoPower, rho);
+    }
+    Polynomial quotient(std::vector<BigInt>(), n);
+    BigInt remainder;
+    divideByLinear(quotient, remainder, Polynomial(combined, n), x);
+    opening.witness = kzgCommit(setup, quotient);
+    return opening;
+}
+
+bool kzgBatchVerify(const KZGVerifierKey& vk, const std::vector<Ecc_Point>& commitments, const KZGBatchOpening& opening) {
+    size_t pointCount = opening.points.size();
+    if (opening.openSets.size() != pointCount || opening.values.size() != pointCount) {
+        return false;
+    }
+    const BigInt& n = vk.g.getCurveParameters().n;
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(n);
+    BigInt gamma = foldChallenge(commitments, opening.points, opening.values, n);
+    BigInt rho = separationChallenge(gamma, n);
+    BigInt x = pointChallenge(gamma, rho, opening.quotient, n);
+    std::vector<BigInt> points = opening.points;
+    for (BigInt& z : points) {
+        field->reduce(z);
+    }
+    BigInt vanishing;
+    std::vector<BigInt> partial = vanishingExcept(points, x, *field, vanishing);
+
+    // [L] = Σ ρʲ·Z_{T∖j}(x)·(Fⱼ − vⱼ·G) − Z_T(x)·W must equal (τ − x)·W', with Fⱼ = Σ γᵏ·Cₖ and
+    // vⱼ = Σ γᵏ·yₖ, checked as [L] + (x − τ)·W' = O in one MSM.
+    std::vector<BigInt> commitmentScalars(commitments.size());
+    BigInt gScalar;
+    BigInt rhoPower(static_cast<unsigned long int>(1));
+    for (size_t j = 0; j < pointCount; ++j) {
+        if (opening.values[j].size() != opening.openSets[j].size()) {
+            return false;
+        }
+        BigInt weight = field->mul(rhoPower, partial[j]);
+        for (size_t k = 0; k < opening.openSets[j].size(); ++k) {
+            size_t index = opening.openSets[j][k];
+            if (index >= commitments.size()) {
+                return false;
+            }
+            BigInt y = opening.values[j][k];
+            field->reduce(y);
+            commitmentScalars[index] = field->add(commitmentScalars[index], weight);
+            gScalar = field->sub(gScalar, field->mul(weight, y));
+            weight = field->mul(weight, gamma);
+        }
+        rhoPower = field->mul(rhoPower, rho);
+    }
+    BigInt tau = vk.tau;
+    field->reduce(tau);
+    std::vector<Ecc_Point> bases(commitments);
+    std::vector<BigInt> scalars(commitmentScalars);
+    bases.push_back(vk.g);
+    scalars.push_back(gScalar);
+    bases.push_back(opening.quotient);
+    scalars.push_back(field->sub(BigInt(), vanishing));
+    bases.push_back(opening.witness);
+    scalars.push_back(field->sub(x, tau));
+    return multiScalarMul(bases, scalars).isInfinity;
+}
@@ -0,0 +1,275 @@
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/glv.hpp"
+#include "../include/jacobian.hpp"
+#include "../include/msm.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+int msmWindowBits(size_t termCount) {
+    if (termCount < 32) {
+        return 3;
+    }
+    int bits = static_cast<int>(std::log2(static_cast<double>(termCount)) * 0.69) + 2;
+    return std::min(bits, 16);
+}
+
+namespace {
+
+// Extracts bits [offset, offset + width) of a non-negative scalar.
+unsigned long windowDigit(const BigInt& k, size_t offset, int width) {
+    unsigned long digit = 0;
+    for (int b = width - 1; b >= 0; --b) {
+        digit = (digit << 1) | mpz_tstbit(k.get_mpz_t(), offset + b);
+    }
+    return digit;
+}
+
+const int BATCH_NAF_WIDTH = 5;
+const size_t BATCH_TABLE_SIZE = static_cast<size_t>(1) << (BATCH_NAF_WIDTH - 2);
+
+// One half of a product: a base point and the wNAF digits of its non-negative scalar.
+struct BatchLadder {
+    size_t term;
+    std::vector<int> naf;
+};
+
+// Multiplies one chunk of terms, normalizing the tables and the results with one inversion each.
+void multiplyChunk(const JacobianArithmetic& arithmetic, const Ecc_Point* points, const BigInt* scalars,
+                   size_t begin, size_t end, Ecc_Point* out) {
+    std::vector<BatchLadder> ladders;
+    std::vector<JacobianPoint> odd;
+    for (size_t i = begin; i < end; ++i) {
+        if (points[i].isInfinity || scalars[i].isZero()) {
+            continue;
+        }
+        const CurveParameters& params = points[i].getCurveParameters();
+        BigInt k = params.n.isZero() ? scalars[i] : scalars[i] % params.n;
+        Ecc_Point base = points[i];
+        if (k.isNegative()) {
+            k.negate();
+            base = -base;
+        }
+
+        std::vector<std::pair<Ecc_Point, BigInt> > halves;
+        const GLVEndomorphism* glv = GLVEndomorphism::forCurve(params);
+        if (glv != nullptr) {
+            GLVDecomposition parts = glv->split(k);
+            halves.push_back(std::make_pair(parts.k1Negative ? -base : base, parts.k1));
+            halves.push_back(std::make_pair(glv->apply(parts.k2Negative ? -base : base), parts.k2));
+        } else {
+            halves.push_back(std::make_pair(base, k));
+        }
+        for (const auto& half : halves) {
+            BatchLadder ladder;
+            ladder.term = i;
+            ladder.naf = computeWNAF(half.second, BATCH_NAF_WIDTH);
+            ladders.push_back(ladder);
+            JacobianPoint current = arithmetic.fromAffine(half.first);
+            JacobianPoint twice = arithmetic.dbl(current);
+            for (size_t j = 0; j < BATCH_TABLE_SIZE; ++j) {
+                odd.push_back(current);
+                current = arithmetic.add(current, twice);
+            }
+        }
+    }
+    std::vector<Ecc_Point> tables = arithmetic.toAffineBatch(odd);
+
+    // Ladders of the same term are adjacent; run them interleaved so they share the doublings.
+    std::vector<JacobianPoint> results;
+    std::vector<size_t> terms;
+    for (size_t l = 0; l < ladders.size();) {
+        size_t last = l + 1;
+        while (last < ladders.size() && ladders[last].term == ladders[l].term) {
+            ++last;
+        }
+        size_t length = 0;
+        for (size_t j = l; j < last; ++j) {
+            length = std::max(length, ladders[j].naf.size());
+        }
+        JacobianPoint acc;
+        for (size_t bit = length; bit-- > 0;) {
+            acc = arithmetic.dbl(acc);
+            for (size_t j = l; j < last; ++j) {
+                int digit = bit < ladders[j].naf.size() ? ladders[j].naf[bit] : 0;
+                const Ecc_Point* table = &tables[j * BATCH_TABLE_SIZE];
+                if (digit > 0) {
+                    acc = arithmetic.addMixed(acc, table[digit / 2]);
+                } else if (digit < 0) {
+                    acc = arithmetic.addMixed(acc, -table[(-digit) / 2]);
+                }
+            }
+        }
+        results.push_back(acc);
+        terms.push_back(ladders[l].term);
+        l = last;
+    }
+
+    std::vector<Ecc_Point> affine = arithmetic.toAffineBatch(results);
+    for (size_t j = 0; j < affine.size(); ++j) {
+        out[terms[j]] = affine[j];
+    }
+}
+
+// Appends scalar·(x, y) to the normalized terms: an affine base and a non-negative scalar below n,
+// split into two half-size terms when the curve has a GLV endomorphism.
+void appendTerm(const CurveParameters& params, const FieldBackend& field, const GLVEndomorphism* glv, const BigInt& x,
+                BigInt y, const BigInt& scalar, PointVector& bases, std::vector<BigInt>& ks) {
+    BigInt k = params.n.isZero() ? scalar : scalar % params.n;
+    if (k.isNegative()) {
+        k.negate();
+        y = field.sub(BigInt(), y);
+    }
+
+    if (glv != nullptr) {
+        GLVDecomposition parts = glv->split(k);
+        BigInt negY = field.sub(BigInt(), y);
+        bases.pushAffine(x, parts.k1Negative ? negY : y);
+        ks.push_back(parts.k1);
+        bases.pushAffine(field.mul(glv->getBeta(), x), parts.k2Negative ? negY : y);
+        ks.push_back(parts.k2);
+    } else {
+        bases.pushAffine(x, y);
+        ks.push_back(k);
+    }
+}
+
+// Pippenger's bucket method over normalized terms.
+Ecc_Point bucketSum(const PointVector& bases, const std::vector<BigInt>& ks) {
+    if (bases.empty()) {
+        return Ecc_Point();
+    }
+
+    JacobianArithmetic arithmetic(bases[0]);
+    BigInt x, y;
+    size_t maxBits = 0;
+    for (const BigInt& k : ks) {
+        maxBits = std::max(maxBits, k.bitSize());
+    }
+    const int c = msmWindowBits(bases.size());
+    const size_t windows = (maxBits + c - 1) / c;
+    const size_t bucketCount = (static_cast<size_t>(1) << c) - 1;
+
+    JacobianPoint result;
+    std::vector<JacobianPoint> buckets(bucketCount);
+    for (size_t w = windows; w-- > 0;) {
+        for (int i = 0; i < c; ++i) {
+            result = arithmetic.dbl(result);
+        }
+
+        std::fill(buckets.begin(), buckets.end(), JacobianPoint());
+        for (size_t i = 0; i < bases.size(); ++i) {
+            unsigned long digit = windowDigit(ks[i], w * c, c);
+            if (digit != 0) {
+                bases.loadX(i, x);
+                bases.loadY(i, y);
+                buckets[digit - 1] = arithmetic.addMixed(buckets[digit - 1], x, y);
+            }
+        }
+
+        // Σ j·B_j via running sums from the top bucket down.
+        JacobianPoint running;
+        JacobianPoint windowSum;
+        for (size_t j = bucketCount; j-- > 0;) {
+            running = arithmetic.add(running, buckets[j]);
+            windowSum = arithmetic.add(windowSum, running);
+        }
+        result = arithmetic.add(result, windowSum);
+    }
+    return arithmetic.toAffine(result);
+}
+
+} // namespace
+
+Ecc_Point multiScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars) {
+    static const unsigned scope = allocationScopeId("msm");
+    AllocationScope allocations(scope);
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars must be the same.");
+    }
+    const Ecc_Point* reference = nullptr;
+    for (size_t i = 0; i < points.size() && reference == nullptr; ++i) {
+        if (!points[i].isInfinity) {
+            reference = &points[i];
+        }
+    }
+    if (reference == nullptr) {
+        return Ecc_Point();
+    }
+
+    // The terms are normalized straight from the points, without an intermediate PointVector.
+    const CurveParameters& params = reference->getCurveParameters();
+    const FieldBackend& field = *reference->getField();
+    const GLVEndomorphism* glv = GLVEndomorphism::forCurve(params);
+    PointVector bases(params);
+    bases.reserve(glv != nullptr ? 2 * points.size() : points.size());
+    std::vector<BigInt> ks;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!points[i].isInfinity && !scalars[i].isZero()) {
+            appendTerm(params, field, glv, points[i].getX(), points[i].getY(), scalars[i], bases, ks);
+        }
+    }
+    return bucketSum(bases, ks);
+}
+
+Ecc_Point multiScalarMul(const PointView& points, const std::vector<BigInt>& scalars) {
+    static const unsigned scope = allocationScopeId("msm");
+    AllocationScope allocations(scope);
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars must be the same.");
+    }
+
+    const CurveParameters& params = points.getCurve();
+    const FieldBackend& field = points.getField();
+    const GLVEndomorphism* glv = GLVEndomorphism::forCurve(params);
+    PointVector bases(params);
+    bases.reserve(glv != nullptr ? 2 * points.size() : points.size());
+    std::vector<BigInt> ks;
+    BigInt x, y;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!points.isInfinity(i) && !scalars[i].isZero()) {
+            points.loadX(i, x);
+            points.loadY(i, y);
+            appendTerm(params, field, glv, x, y, scalars[i], bases, ks);
+        }
+    }
+    return bucketSum(bases, ks);
+}
+
+std::vector<Ecc_Point> batchScalarMul(const Ecc_Point* points, const BigInt* scalars, size_t count, unsigned threads) {
+    static const unsigned scope = allocationScopeId("msm");
+    AllocationScope allocations(scope);
+    std::vector<Ecc_Point> result(count);
+    const Ecc_Point* reference = nullptr;
+    for (size_t i = 0; i < count && reference == nullptr; ++i) {
+        if (!points[i].isInfinity) {
+            reference = &points[i];
+        }
+    }
+    if (reference == nullptr) {
+        return result;
+    }
+
+    JacobianArithmetic arithmetic(*reference);
+    if (threads == 0) {
+        threads = defaultThreadCount();
+    }
+    size_t chunk = std::max<size_t>(1, (count + threads - 1) / threads);
+    size_t chunks = (count + chunk - 1) / chunk;
+    parallelFor(chunks, [&](size_t c) {
+        size_t begin = c * chunk;
+        multiplyChunk(arithmetic, points, scalars, begin, std::min(begin + chunk, count), result.data());
+    }, threads);
+    return result;
+}
+
+std::vector<Ecc_Point> batchScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars,
+                                      unsigned threads) {
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars must be the same.");
+    }
+    return batchScalarMul(points.data(), scalars.data(), points.size(), threads);
+}
@@ -0,0 +1,280 @@
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/io.hpp"
+#include "../include/ntt.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const size_t ELEMENT_LIMBS = 4;
+const size_t ELEMENT_BYTES = ELEMENT_LIMBS * sizeof(uint64_t);
+
+// Transpose tiles are TILE x TILE elements (128 KiB), row passes work on bands of about 8 MiB.
+const size_t TILE = 64;
+const size_t BAND_BYTES = static_cast<size_t>(8) << 20;
+
+void reduceInto(BigInt& v, const BigInt& p) {
+    if (mpz_sgn(v.get_mpz_t()) < 0 || mpz_cmp(v.get_mpz_t(), p.get_mpz_t()) >= 0) {
+        v %= p;
+    }
+}
+
+uint64_t* elementAt(const MappedFile& file, size_t i) {
+    return reinterpret_cast<uint64_t*>(file.get()) + i * ELEMENT_LIMBS;
+}
+
+// Drops the resident pages of a finished range of elements.
+void releaseElements(const MappedFile& file, size_t firstElement, size_t count) {
+    file.release(firstElement * ELEMENT_BYTES, count * ELEMENT_BYTES);
+}
+
+void loadElement(BigInt& out, const uint64_t* e, const BigInt& p) {
+    mp_limb_t* limbs = mpz_limbs_write(out.get_mpz_t(), ELEMENT_LIMBS);
+    for (size_t j = 0; j < ELEMENT_LIMBS; ++j) {
+        limbs[j] = e[j];
+    }
+    mpz_limbs_finish(out.get_mpz_t(), ELEMENT_LIMBS);
+    reduceInto(out, p);
+}
+
+void storeElement(uint64_t* e, const BigInt& v) {
+    for (size_t j = 0; j < ELEMENT_LIMBS; ++j) {
+        e[j] = mpz_getlimbn(v.get_mpz_t(), j);
+    }
+}
+
+// Out-of-place tiled transpose of a rows x cols matrix into cols x rows.
+void transposeTiled(const MappedFile& src, const MappedFile& dst, size_t rows, size_t cols) {
+    for (size_t i0 = 0; i0 < rows; i0 += TILE) {
+        size_t i1 = std::min(rows, i0 + TILE);
+        for (size_t j0 = 0; j0 < cols; j0 += TILE) {
+            size_t j1 = std::min(cols, j0 + TILE);
+            for (size_t i = i0; i < i1; ++i) {
+                for (size_t j = j0; j < j1; ++j) {
+                    std::memcpy(elementAt(dst, j * rows + i), elementAt(src, i * cols + j), ELEMENT_BYTES);
+                }
+            }
+        }
+        releaseElements(src, i0 * cols, (i1 - i0) * cols);
+        releaseElements(dst, 0, rows * cols);
+    }
+}
+
+} // namespace
+
+const BigInt& nttFriendlyModulus() {
+    static const BigInt r("30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001", 16);
+    return r;
+}
+
+EvaluationDomain::EvaluationDomain(size_t size, const BigInt& modulus)
+    : n(size), logN(0), field(FieldBackend::forModulus(modulus)) {
+    if (size == 0 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("Evaluation domain size must be a power of two.");
+    }
+    while ((static_cast<size_t>(1) << logN) < size) {
+        ++logN;
+    }
+    BigInt pMinusOne = modulus - BigInt(static_cast<unsigned long int>(1));
+    if (mpz_scan1(pMinusOne.get_mpz_t(), 0) < logN) {
+        throw std::invalid_argument("Domain size does not divide p - 1.");
+    }
+
+    // The smallest quadratic non-residue generates the full 2-Sylow subgroup.
+    BigInt halfOrder = pMinusOne.rightShift(1);
+    BigInt g(static_cast<unsigned long int>(2));
+    BigInt check;
+    for (;; g += BigInt(static_cast<unsigned long int>(1))) {
+        mpz_powm(check.get_mpz_t(), g.get_mpz_t(), halfOrder.get_mpz_t(), modulus.get_mpz_t());
+        if (check == pMinusOne) {
+            break;
+        }
+    }
+    BigInt exponent = pMinusOne.rightShift(logN);
+    mpz_powm(omega.get_mpz_t(), g.get_mpz_t(), exponent.get_mpz_t(), modulus.get_mpz_t());
+    omegaInv = omega.modInverse(modulus);
+    sizeInv = BigInt(static_cast<unsigned long int>(size)).modInverse(modulus);
+
+    twiddles.resize(n / 2);
+    inverseTwiddles.resize(n / 2);
+    if (n >= 2) {
+        twiddles[0] = BigInt(static_cast<unsigned long int>(1));
+        inverseTwiddles[0] = BigInt(static_cast<unsigned long int>(1));
+    }
+    for (size_t i = 1; i < n / 2; ++i) {
+        twiddles[i] = field->mul(twiddles[i - 1], omega);
+        inverseTwiddles[i] = field->mul(inverseTwiddles[i - 1], omegaInv);
+    }
+}
+
+BigInt EvaluationDomain::element(size_t i) const {
+    BigInt result;
+    mpz_powm_ui(result.get_mpz_t(), omega.get_mpz_t(), i % n, modulus().get_mpz_t());
+    return result;
+}
+
+// Iterative radix-2 Cooley-Tukey on reduced inputs, without the 1/n scaling of the inverse.
+void EvaluationDomain::transform(std::vector<BigInt>& a, bool inverse) const {
+    static const unsigned scope = allocationScopeId("ntt");
+    AllocationScope allocations(scope);
+    mpz_srcptr p = modulus().get_mpz_t();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            a[i].swap(a[j]);
+        }
+    }
+
+    const std::vector<BigInt>& roots = inverse ? inverseTwiddles : twiddles;
+    BigInt t;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t step = n / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; ++j) {
+                mpz_ptr u = a[i + j].get_mpz_t();
+                mpz_ptr v = a[i + j + half].get_mpz_t();
+                mpz_mul(t.get_mpz_t(), v, roots[j * step].get_mpz_t());
+                field->reduce(t);
+                mpz_sub(v, u, t.get_mpz_t());
+                if (mpz_sgn(v) < 0) {
+                    mpz_add(v, v, p);
+                }
+                mpz_add(u, u, t.get_mpz_t());
+                if (mpz_cmp(u, p) >= 0) {
+                    mpz_sub(u, u, p);
+                }
+            }
+        }
+    }
+}
+
+void EvaluationDomain::fft(std::vector<BigInt>& values) const {
+    if (values.size() > n) {
+        throw std::invalid_argument("More values than points in the evaluation domain.");
+    }
+    values.resize(n);
+    for (BigInt& v : values) {
+        reduceInto(v, modulus());
+    }
+    transform(values, false);
+}
+
+void EvaluationDomain::ifft(std::vector<BigInt>& values) const {
+    if (values.size() > n) {
+        throw std::invalid_argument("More values than points in the evaluation domain.");
+    }
+    values.resize(n);
+    for (BigInt& v : values) {
+        reduceInto(v, modulus());
+    }
+    transform(values, true);
+    for (BigInt& v : values) {
+        v = field->mul(v, sizeInv);
+    }
+}
+
+void EvaluationDomain::cosetFft(std::vector<BigInt>& values, const BigInt& shift) const {
+    if (values.size() > n) {
+        throw std::invalid_argument("More values than points in the evaluation domain.");
+    }
+    BigInt power(static_cast<unsigned long int>(1));
+    BigInt s = shift % modulus();
+    for (BigInt& v : values) {
+        v = field->mul(v % modulus(), power);
+        power = field->mul(power, s);
+    }
+    fft(values);
+}
+
+void EvaluationDomain::cosetIfft(std::vector<BigInt>& values, const BigInt& shift) const {
+    ifft(values);
+    BigInt power(static_cast<unsigned long int>(1));
+    BigInt sInv = (shift % modulus()).modInverse(modulus());
+    for (BigInt& v : values) {
+        v = field->mul(v, power);
+        power = field->mul(power, sInv);
+    }
+}
+
+Polynomial EvaluationDomain::vanishingPolynomial() const {
+    return Polynomial::vanishing(n, modulus());
+}
+
+BigInt EvaluationDomain::evaluateVanishing(const BigInt& x) const {
+    BigInt result;
+    BigInt point = x % modulus();
+    mpz_powm_ui(result.get_mpz_t(), point.get_mpz_t(), n, modulus().get_mpz_t());
+    return field->sub(result, BigInt(static_cast<unsigned long int>(1)));
+}
+
+void outOfCoreNtt(const std::string& path, const EvaluationDomain& domain, bool inverse, unsigned threads) {
+    static const unsigned scope = allocationScopeId("ntt");
+    AllocationScope allocations(scope);
+    const BigInt& p = domain.modulus();
+    if (p.bitSize() > ELEMENT_LIMBS * 64) {
+        throw std::invalid_argument("Out-of-core NTT stores elements in 256 bits; the modulus is too wide.");
+    }
+    const size_t n = domain.size();
+    const unsigned log1 = (domain.logSize() + 1) / 2;
+    const size_t n1 = static_cast<size_t>(1) << log1;
+    const size_t n2 = n / n1;
+    const std::string scratchPath = path + ".ntt-scratch";
+
+    {
+        MappedFile data(path, MappedFile::ReadWrite);
+        if (data.size() != n * ELEMENT_BYTES) {
+            throw std::invalid_argument("File " + path + " does not hold exactly one element per domain point.");
+        }
+        MappedFile scratch(scratchPath, MappedFile::Create, n * ELEMENT_BYTES);
+        EvaluationDomain rowDomain1(n1, p);
+        EvaluationDomain rowDomain2(n2, p);
+        const BigInt& root = inverse ? domain.generatorInverse() : domain.generator();
+
+        // Transforms every row of a rows x cols matrix, then multiplies entry (r, c) by scale * w^(r·c).
+        auto rowPass = [&](const MappedFile& file, size_t rows, size_t cols, const EvaluationDomain& rowDomain,
+                           const BigInt* twiddleRoot, const BigInt& scale) {
+            size_t bandRows = std::max<size_t>(1, BAND_BYTES / (cols * ELEMENT_BYTES));
+            for (size_t r0 = 0; r0 < rows; r0 += bandRows) {
+                size_t r1 = std::min(rows, r0 + bandRows);
+                parallelFor(r1 - r0, [&](size_t k) {
+                    size_t r = r0 + k;
+                    std::vector<BigInt> row(cols);
+                    for (size_t c = 0; c < cols; ++c) {
+                        loadElement(row[c], elementAt(file, r * cols + c), p);
+                    }
+                    rowDomain.transform(row, inverse);
+                    BigInt factor = scale;
+                    BigInt step(static_cast<unsigned long int>(1));
+                    if (twiddleRoot != nullptr) {
+                        mpz_powm_ui(step.get_mpz_t(), twiddleRoot->get_mpz_t(), r, p.get_mpz_t());
+                    }
+                    for (size_t c = 0; c < cols; ++c) {
+                        storeElement(elementAt(file, r * cols + c), domain.getField().mul(row[c], factor));
+                        factor = domain.getField().mul(factor, step);
+                    }
+                }, threads);
+                releaseElements(file, r0 * cols, (r1 - r0) * cols);
+            }
+        };
+
+        BigInt one(static_cast<unsigned long int>(1));
+        transposeTiled(data, scratch, n1, n2);
+        rowPass(scratch, n2, n1, rowDomain1, &root, one);
+        transposeTiled(scratch, data, n2, n1);
+        rowPass(data, n1, n2, rowDomain2, nullptr, inverse ? domain.sizeInverse() : one);
+        transposeTiled(data, scratch, n1, n2);
+    }
+
+    if (std::rename(scratchPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace " + path + " with the transformed data.");
+    }
+}
@@ -0,0 +1,58 @@
+#include "../include/allocation.hpp"
+#include "../include/parallel.hpp"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+unsigned defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+void parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned threads) {
+    if (threads == 0) {
+        threads = defaultThreadCount();
+    }
+    if (threads > count) {
+        threads = static_cast<unsigned>(count);
+    }
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    const unsigned scope = currentAllocationScope();
+    auto worker = [&]() {
+        AllocationScope inherited(scope);
+        try {
+            for (size_t i = next++; i < count; i = next++) {
+                body(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            next = count;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,140 @@
+#include "../include/bigint.hpp"
+#include "../include/points.hpp"
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), "PointVector stores 64-bit GMP limbs.");
+
+PointVector::PointVector(const CurveParameters& curve)
+    : prototype(std::make_shared<const Ecc_Point>(curve.Gx, curve.Gy, curve)), width((curve.p.bitSize() + 63) / 64), count(0) {
+}
+
+PointVector::PointVector(const CurveParameters& curve, const std::vector<Ecc_Point>& points) : PointVector(curve) {
+    resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        set(i, points[i]);
+    }
+}
+
+void PointVector::reserve(size_t capacity) {
+    xs.reserve(capacity * width);
+    ys.reserve(capacity * width);
+    infinity.reserve((capacity + 63) / 64);
+}
+
+void PointVector::resize(size_t size) {
+    xs.resize(size * width, 0);
+    ys.resize(size * width, 0);
+    infinity.resize((size + 63) / 64, 0);
+    for (size_t i = count; i < size; ++i) {
+        infinity[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+    }
+    // Clear the bits past the end so that growing again starts from a known state.
+    if (size % 64 != 0) {
+        infinity[size / 64] &= (static_cast<uint64_t>(1) << (size % 64)) - 1;
+    }
+    count = size;
+}
+
+void PointVector::push_back(const Ecc_Point& point) {
+    resize(count + 1);
+    set(count - 1, point);
+}
+
+void PointVector::pushAffine(const BigInt& x, const BigInt& y) {
+    resize(count + 1);
+    setAffine(count - 1, x, y);
+}
+
+void PointVector::set(size_t i, const Ecc_Point& point) {
+    if (point.isInfinity) {
+        setInfinity(i);
+    } else {
+        setAffine(i, point.getX(), point.getY());
+    }
+}
+
+void PointVector::setAffine(size_t i, const BigInt& x, const BigInt& y) {
+    storeCoordinate(&xs[i * width], x);
+    storeCoordinate(&ys[i * width], y);
+    infinity[i / 64] &= ~(static_cast<uint64_t>(1) << (i % 64));
+}
+
+void PointVector::setAffineLimbs(size_t i, const uint64_t* x, const uint64_t* y) {
+    std::memcpy(&xs[i * width], x, width * sizeof(uint64_t));
+    std::memcpy(&ys[i * width], y, width * sizeof(uint64_t));
+    infinity[i / 64] &= ~(static_cast<uint64_t>(1) << (i % 64));
+}
+
+void PointVector::setInfinity(size_t i) {
+    std::memset(&xs[i * width], 0, width * sizeof(uint64_t));
+    std::memset(&ys[i * width], 0, width * sizeof(uint64_t));
+    infinity[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+}
+
+void PointVector::loadX(size_t i, BigInt& out) const {
+    loadCoordinate(&xs[i * width], out);
+}
+
+void PointVector::loadY(size_t i, BigInt& out) const {
+    loadCoordinate(&ys[i * width], out);
+}
+
+Ecc_Point PointVector::operator[](size_t i) const {
+    if (isInfinity(i)) {
+        return Ecc_Point();
+    }
+    BigInt x, y;
+    loadX(i, x);
+    loadY(i, y);
+    return prototype->withCoordinates(x, y);
+}
+
+std::vector<Ecc_Point> PointVector::toPoints() const {
+    std::vector<Ecc_Point> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back((*this)[i]);
+    }
+    return points;
+}
+
+size_t PointVector::memoryBytes() const {
+    return (xs.capacity() + ys.capacity() + infinity.capacity()) * sizeof(uint64_t);
+}
+
+PointView PointVector::view(size_t offset, size_t length) const {
+    return PointView(*this, offset, length);
+}
+
+void PointVector::storeCoordinate(uint64_t* out, const BigInt& v) const {
+    const BigInt* value = &v;
+    BigInt reduced;
+    if (v.isNegative() || v >= getCurve().p) {
+        reduced = v;
+        getField().reduce(reduced);
+        value = &reduced;
+    }
+    size_t used = mpz_size(value->get_mpz_t());
+    std::memcpy(out, mpz_limbs_read(value->get_mpz_t()), used * sizeof(uint64_t));
+    std::memset(out + used, 0, (width - used) * sizeof(uint64_t));
+}
+
+void PointVector::loadCoordinate(const uint64_t* in, BigInt& out) const {
+    mp_limb_t* d = mpz_limbs_write(out.get_mpz_t(), width);
+    std::memcpy(d, in, width * sizeof(uint64_t));
+    mpz_limbs_finish(out.get_mpz_t(), width);
+}
+
+PointView::PointView(const PointVector& points, size_t offset, size_t length) : points(&points), offset(offset), count(length) {
+    if (offset > points.size() || length > points.size() - offset) {
+        throw std::out_of_range("Point view exceeds the vector.");
+    }
+}
+
+PointView PointView::subview(size_t first, size_t length) const {
+    if (first > count || length > count - first) {
+        throw std::out_of_range("Point view exceeds the parent view.");
+    }
+    return PointView(*points, offset + first, length);
+}
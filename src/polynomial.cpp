@@ -1,62 +1,389 @@
+#include "../include/allocation.hpp"
 #include "../include/bigint.hpp"
 #include "../include/polynomial.hpp"
+#include "../include/field.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <stdexcept>
 #include <vector>
 #include <iostream>
 #include <sstream>
 
-Polynomial::Polynomial(const std::vector<std::string>& coeff_array, const std::string& modulusStr) {
+Polynomial::Polynomial(const std::vector<std::string>& coeff_array, const std::string& modulusStr) : length(0), sparse(false) {
     mod = BigInt(modulusStr, 10);
+    field = FieldBackend::forModulus(mod);
     for (const auto& coeff : coeff_array) {
         coefficients.emplace_back(coeff, 10);
     }
+    length = coefficients.size();
+    adaptRepresentation();
+}
+
+Polynomial::Polynomial(const std::vector<BigInt>& coeff_array, const BigInt& modulus)
+    : coefficients(coeff_array), length(coeff_array.size()), sparse(false), mod(modulus), field(FieldBackend::forModulus(modulus)) {
+    adaptRepresentation();
+}
+
+Polynomial Polynomial::fromTerms(const std::vector<SparseTerm>& terms, const BigInt& modulus) {
+    std::map<size_t, BigInt> merged;
+    for (const SparseTerm& term : terms) {
+        merged[term.exponent] += term.coeff;
+    }
+    std::vector<SparseTerm> nonzero;
+    size_t slots = 0;
+    for (auto& entry : merged) {
+        BigInt coeff = entry.second % modulus;
+        if (!coeff.isZero()) {
+            nonzero.push_back(SparseTerm{ entry.first, coeff });
+            slots = entry.first + 1;
+        }
+    }
+    Polynomial result;
+    result.assignSparse(nonzero, slots, modulus, FieldBackend::forModulus(modulus));
+    return result;
+}
+
+Polynomial Polynomial::vanishing(size_t n, const BigInt& modulus) {
+    std::vector<SparseTerm> terms = {
+        SparseTerm{ 0, modulus - BigInt(static_cast<unsigned long int>(1)) },
+        SparseTerm{ n, BigInt(static_cast<unsigned long int>(1)) }
+    };
+    return fromTerms(terms, modulus);
+}
+
+void Polynomial::assignDense(const std::vector<BigInt>& coeffs, const BigInt& modulus, const std::shared_ptr<const FieldBackend>& backend) {
+    coefficients = coeffs;
+    terms.clear();
+    length = coeffs.size();
+    sparse = false;
+    denseCache.reset();
+    mod = modulus;
+    field = backend;
+    adaptRepresentation();
+}
+
+void Polynomial::assignSparse(const std::vector<SparseTerm>& nonzero, size_t slots, const BigInt& modulus,
+                              const std::shared_ptr<const FieldBackend>& backend) {
+    coefficients.clear();
+    terms = nonzero;
+    length = slots;
+    sparse = true;
+    denseCache.reset();
+    mod = modulus;
+    field = backend;
+    adaptRepresentation();
+}
+
+// Chooses the representation from the density of nonzero coefficients.
+void Polynomial::adaptRepresentation() {
+    size_t nonzero = termCount();
+    bool wantSparse = length >= SPARSE_MIN_LENGTH && nonzero * SPARSE_DENSITY_RATIO <= length;
+    if (wantSparse == sparse) {
+        return;
+    }
+    if (wantSparse) {
+        terms.clear();
+        terms.reserve(nonzero);
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            if (!coefficients[i].isZero()) {
+                terms.push_back(SparseTerm{ i, coefficients[i] });
+            }
+        }
+        std::vector<BigInt>().swap(coefficients);
+    } else {
+        coefficients.assign(length, BigInt(static_cast<unsigned long int>(0)));
+        for (const SparseTerm& term : terms) {
+            coefficients[term.exponent] = term.coeff;
+        }
+        std::vector<SparseTerm>().swap(terms);
+    }
+    sparse = wantSparse;
+    denseCache.reset();
 }
 
 void Polynomial::print() const {
     bool first = true;
-    for (size_t i = 0; i < coefficients.size(); ++i) {
+    auto printTerm = [&first](size_t i, const BigInt& coeff) {
         if (!first) {
-            std::cout << (coefficients[i].isNegative() ? " - " : " + ");
-        } else if (coefficients[i].isNegative()) {
+            std::cout << (coeff.isNegative() ? " - " : " + ");
+        } else if (coeff.isNegative()) {
             std::cout << "-";
         }
         first = false;
 
-        coefficients[i].printAbsolute();
+        coeff.printAbsolute();
 
         if (i > 0) {
             std::cout << "*x^" << i;
         }
+    };
+    if (sparse) {
+        for (const SparseTerm& term : terms) {
+            printTerm(term.exponent, term.coeff);
+        }
+    } else {
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            printTerm(i, coefficients[i]);
+        }
     }
     std::cout << std::endl;
 }
 
 int Polynomial::deg() const {
-    return coefficients.size() - 1;
+    return length - 1;
+}
+
+const std::vector<BigInt>& Polynomial::getCoefficients() const {
+    if (!sparse) {
+        return coefficients;
+    }
+    std::shared_ptr<const std::vector<BigInt>> cached = std::atomic_load(&denseCache);
+    if (!cached) {
+        std::shared_ptr<std::vector<BigInt>> built = std::make_shared<std::vector<BigInt>>(length);
+        for (const SparseTerm& term : terms) {
+            (*built)[term.exponent] = term.coeff;
+        }
+        // The first thread to publish wins; the cache is never replaced while the polynomial is shared.
+        std::shared_ptr<const std::vector<BigInt>> expected;
+        std::shared_ptr<const std::vector<BigInt>> desired = built;
+        if (std::atomic_compare_exchange_strong(&denseCache, &expected, desired)) {
+            cached = desired;
+        } else {
+            cached = expected;
+        }
+    }
+    return *cached;
 }
 
-std::vector<BigInt> Polynomial::getCoefficients() const {
-    return coefficients;
+std::vector<SparseTerm> Polynomial::getTerms() const {
+    if (sparse) {
+        return terms;
+    }
+    std::vector<SparseTerm> result;
+    for (size_t i = 0; i < coefficients.size(); ++i) {
+        if (!coefficients[i].isZero()) {
+            result.push_back(SparseTerm{ i, coefficients[i] });
+        }
+    }
+    return result;
+}
+
+bool Polynomial::isSparse() const {
+    return sparse;
+}
+
+size_t Polynomial::termCount() const {
+    if (sparse) {
+        return terms.size();
+    }
+    size_t count = 0;
+    for (const BigInt& coeff : coefficients) {
+        if (!coeff.isZero()) {
+            ++count;
+        }
+    }
+    return count;
 }
 
 BigInt Polynomial::getMod() const {
     return mod;
 }
 
+namespace {
+
+// Below this length the power table costs more than the reductions it saves.
+const size_t LAZY_HORNER_LENGTH = 32;
+
+// Horner's rule over coeffs[begin, end) in steps of x^step, leaving the value in [0, p). Each block
+// of step coefficients is a dot product with x^0 … x^(step−1) accumulated unreduced, as in
+// evaluatePolynomials(), so about 2√n reductions replace the n of plain Horner.
+BigInt hornerRange(const std::vector<BigInt>& coeffs, size_t begin, size_t end, const BigInt& x, const FieldBackend& field) {
+    size_t length = end - begin;
+    if (length < LAZY_HORNER_LENGTH) {
+        BigInt acc(static_cast<unsigned long int>(0));
+        for (size_t i = end; i-- > begin;) {
+            mpz_mul(acc.get_mpz_t(), acc.get_mpz_t(), x.get_mpz_t());
+            mpz_add(acc.get_mpz_t(), acc.get_mpz_t(), coeffs[i].get_mpz_t());
+            field.reduce(acc);
+        }
+        return acc;
+    }
+    size_t step = 1;
+    while (step * step < length) {
+        ++step;
+    }
+    std::vector<BigInt> powers(step + 1);
+    powers[0] = BigInt(static_cast<unsigned long int>(1));
+    for (size_t i = 1; i <= step; ++i) {
+        mpz_mul(powers[i].get_mpz_t(), powers[i - 1].get_mpz_t(), x.get_mpz_t());
+        field.reduce(powers[i]);
+    }
+    BigInt acc(static_cast<unsigned long int>(0));
+    for (size_t block = (length + step - 1) / step; block-- > 0;) {
+        size_t first = begin + block * step;
+        size_t last = std::min(first + step, end);
+        mpz_mul(acc.get_mpz_t(), acc.get_mpz_t(), powers[step].get_mpz_t());
+        for (size_t i = first; i < last; ++i) {
+            mpz_addmul(acc.get_mpz_t(), coeffs[i].get_mpz_t(), powers[i - first].get_mpz_t());
+        }
+        field.reduce(acc);
+    }
+    return acc;
+}
+
+// Sum of coeff * x^exponent over sorted terms, multiplying x up only across exponent gaps.
+BigInt evaluateTerms(const std::vector<SparseTerm>& terms, const BigInt& x, const FieldBackend& field) {
+    mpz_srcptr p = field.modulus().get_mpz_t();
+    BigInt acc(static_cast<unsigned long int>(0));
+    BigInt xPower(static_cast<unsigned long int>(1));
+    size_t exponent = 0;
+    for (const SparseTerm& term : terms) {
+        if (term.exponent != exponent) {
+            BigInt step;
+            mpz_powm_ui(step.get_mpz_t(), x.get_mpz_t(), term.exponent - exponent, p);
+            mpz_mul(xPower.get_mpz_t(), xPower.get_mpz_t(), step.get_mpz_t());
+            field.reduce(xPower);
+            exponent = term.exponent;
+        }
+        mpz_addmul(acc.get_mpz_t(), term.coeff.get_mpz_t(), xPower.get_mpz_t());
+    }
+    field.reduce(acc);
+    return acc;
+}
+
+} // namespace
+
+BigInt Polynomial::evaluate(const BigInt& x, unsigned threads) const {
+    BigInt point = x % mod;
+    if (sparse) {
+        return evaluateTerms(terms, point, *field);
+    }
+    if (threads == 0) {
+        threads = defaultThreadCount();
+    }
+    if (threads <= 1 || coefficients.size() < PARALLEL_EVALUATION_LENGTH) {
+        return hornerRange(coefficients, 0, coefficients.size(), point, *field);
+    }
+
+    // Estrin-style split: independent blocks, recombined with Horner in x^blockSize.
+    size_t blockSize = (coefficients.size() + threads - 1) / threads;
+    size_t blocks = (coefficients.size() + blockSize - 1) / blockSize;
+    std::vector<BigInt> partial(blocks);
+    parallelFor(blocks, [&](size_t j) {
+        size_t begin = j * blockSize;
+        partial[j] = hornerRange(coefficients, begin, std::min(begin + blockSize, coefficients.size()), point, *field);
+    }, threads);
+    BigInt stride;
+    mpz_powm_ui(stride.get_mpz_t(), point.get_mpz_t(), blockSize, mod.get_mpz_t());
+    return hornerRange(partial, 0, blocks, stride, *field);
+}
+
+std::vector<BigInt> Polynomial::evaluateMany(const std::vector<BigInt>& points, unsigned threads) const {
+    std::vector<BigInt> values(points.size());
+    parallelFor(points.size(), [&](size_t i) {
+        BigInt point = points[i] % mod;
+        values[i] = sparse ? evaluateTerms(terms, point, *field) : hornerRange(coefficients, 0, coefficients.size(), point, *field);
+    }, threads);
+    return values;
+}
+
+std::vector<BigInt> evaluatePolynomials(const std::vector<Polynomial>& polys, const BigInt& x, unsigned threads) {
+    std::vector<BigInt> values(polys.size());
+    if (polys.empty()) {
+        return values;
+    }
+    const BigInt& mod = polys[0].mod;
+    size_t longest = 0;
+    for (const Polynomial& poly : polys) {
+        if (poly.mod != mod) {
+            throw std::invalid_argument("Moduli of the polynomials must be the same.");
+        }
+        if (!poly.sparse) {
+            longest = std::max(longest, poly.length);
+        }
+    }
+
+    const FieldBackend* field = polys[0].field.get();
+    BigInt point = x % mod;
+    std::vector<BigInt> powers(longest);
+    if (longest > 0) {
+        powers[0] = BigInt(static_cast<unsigned long int>(1));
+    }
+    for (size_t i = 1; i < longest; ++i) {
+        mpz_mul(powers[i].get_mpz_t(), powers[i - 1].get_mpz_t(), point.get_mpz_t());
+        field->reduce(powers[i]);
+    }
+
+    parallelFor(polys.size(), [&](size_t k) {
+        const Polynomial& poly = polys[k];
+        if (poly.sparse) {
+            values[k] = evaluateTerms(poly.terms, point, *field);
+            return;
+        }
+        BigInt acc(static_cast<unsigned long int>(0));
+        for (size_t i = 0; i < poly.coefficients.size(); ++i) {
+            mpz_addmul(acc.get_mpz_t(), poly.coefficients[i].get_mpz_t(), powers[i].get_mpz_t());
+        }
+        field->reduce(acc);
+        values[k] = acc;
+    }, threads);
+    return values;
+}
+
+namespace {
+
+// Merges two sorted term lists, combining equal exponents as a + sign * b.
+std::vector<SparseTerm> mergeTerms(const std::vector<SparseTerm>& a, const std::vector<SparseTerm>& b, bool subtract, const BigInt& mod) {
+    std::vector<SparseTerm> result;
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        BigInt coeff;
+        size_t exponent;
+        if (j == b.size() || (i < a.size() && a[i].exponent < b[j].exponent)) {
+            exponent = a[i].exponent;
+            coeff = a[i++].coeff % mod;
+        } else if (i == a.size() || b[j].exponent < a[i].exponent) {
+            exponent = b[j].exponent;
+            coeff = (subtract ? mod - b[j].coeff : b[j].coeff) % mod;
+            ++j;
+        } else {
+            exponent = a[i].exponent;
+            coeff = (subtract ? a[i].coeff - b[j].coeff : a[i].coeff + b[j].coeff) % mod;
+            ++i;
+            ++j;
+        }
+        if (!coeff.isZero()) {
+            result.push_back(SparseTerm{ exponent, coeff });
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 void addPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
     if (a.mod != b.mod) {
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
 
-    size_t max_degree = std::max(a.coefficients.size(), b.coefficients.size());
-    result.coefficients.resize(max_degree);
-    result.mod = a.mod; 
+    size_t max_degree = std::max(a.length, b.length);
+    if (a.sparse && b.sparse) {
+        result.assignSparse(mergeTerms(a.terms, b.terms, false, a.mod), max_degree, a.mod, a.field);
+        return;
+    }
 
+    const std::vector<BigInt>& ac = a.getCoefficients();
+    const std::vector<BigInt>& bc = b.getCoefficients();
+    std::vector<BigInt> coeffs(max_degree);
     for (size_t i = 0; i < max_degree; ++i) {
-        BigInt sum = (i < a.coefficients.size() ? a.coefficients[i] : BigInt(static_cast<unsigned long int>(0))) +
-                     (i < b.coefficients.size() ? b.coefficients[i] : BigInt(static_cast<unsigned long int>(0)));
+        BigInt sum = (i < ac.size() ? ac[i] : BigInt(static_cast<unsigned long int>(0))) +
+                     (i < bc.size() ? bc[i] : BigInt(static_cast<unsigned long int>(0)));
         sum %= a.mod;
-        result.coefficients[i] = sum;
+        coeffs[i] = sum;
     }
+    result.assignDense(coeffs, a.mod, a.field);
 }
 
 void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
@@ -64,60 +391,367 @@ void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomi
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
 
-    size_t max_degree = std::max(a.coefficients.size(), b.coefficients.size());
-    result.coefficients.resize(max_degree);
-    result.mod = a.mod;  // Set the modulus for the result polynomial
+    size_t max_degree = std::max(a.length, b.length);
+    if (a.sparse && b.sparse) {
+        result.assignSparse(mergeTerms(a.terms, b.terms, true, a.mod), max_degree, a.mod, a.field);
+        return;
+    }
 
+    const std::vector<BigInt>& ac = a.getCoefficients();
+    const std::vector<BigInt>& bc = b.getCoefficients();
+    std::vector<BigInt> coeffs(max_degree);
     for (size_t i = 0; i < max_degree; ++i) {
-        BigInt diff = (i < a.coefficients.size() ? a.coefficients[i] : BigInt(static_cast<unsigned long int>(0))) -
-                      (i < b.coefficients.size() ? b.coefficients[i] : BigInt(static_cast<unsigned long int>(0)));
+        BigInt diff = (i < ac.size() ? ac[i] : BigInt(static_cast<unsigned long int>(0))) -
+                      (i < bc.size() ? bc[i] : BigInt(static_cast<unsigned long int>(0)));
         diff %= a.mod;
-        result.coefficients[i] = diff;
+        coeffs[i] = diff;
+    }
+    result.assignDense(coeffs, a.mod, a.field);
+}
+
+namespace {
+
+// Packs the coefficients, reduced into [0, mod), into one integer with slotLimbs limbs per coefficient.
+void packCoefficients(mpz_ptr out, const std::vector<BigInt>& coeffs, size_t slotLimbs, const BigInt& mod) {
+    size_t total = coeffs.size() * slotLimbs;
+    mp_limb_t* limbs = mpz_limbs_write(out, total);
+    std::fill(limbs, limbs + total, 0);
+    BigInt reduced;
+    for (size_t i = 0; i < coeffs.size(); ++i) {
+        const BigInt* coeff = &coeffs[i];
+        if (coeff->isNegative() || *coeff >= mod) {
+            reduced = *coeff % mod;
+            coeff = &reduced;
+        }
+        const mp_limb_t* src = mpz_limbs_read(coeff->get_mpz_t());
+        std::copy(src, src + mpz_size(coeff->get_mpz_t()), limbs + i * slotLimbs);
+    }
+    mpz_limbs_finish(out, total);
+}
+
+// Kronecker substitution: evaluates both polynomials at x = 2^(64·slotLimbs), multiplies the two
+// integers once and reads the product coefficients back from the slots.
+std::vector<BigInt> multiplyKronecker(const std::vector<BigInt>& a, const std::vector<BigInt>& b, const FieldBackend& field) {
+    const BigInt& mod = field.modulus();
+    // Every product coefficient is a sum of at most min(|a|, |b|) products of residues.
+    size_t slotBits = 2 * mod.bitSize() + BigInt(static_cast<unsigned long int>(std::min(a.size(), b.size()))).bitSize();
+    size_t slotLimbs = (slotBits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+
+    BigInt packedA, packedB, product;
+    packCoefficients(packedA.get_mpz_t(), a, slotLimbs, mod);
+    if (&a == &b) {
+        mpz_mul(product.get_mpz_t(), packedA.get_mpz_t(), packedA.get_mpz_t());
+    } else {
+        packCoefficients(packedB.get_mpz_t(), b, slotLimbs, mod);
+        mpz_mul(product.get_mpz_t(), packedA.get_mpz_t(), packedB.get_mpz_t());
+    }
+
+    std::vector<BigInt> coeffs(a.size() + b.size() - 1);
+    const mp_limb_t* limbs = mpz_limbs_read(product.get_mpz_t());
+    size_t size = mpz_size(product.get_mpz_t());
+    for (size_t k = 0; k < coeffs.size(); ++k) {
+        size_t begin = k * slotLimbs;
+        if (begin >= size) {
+            break;
+        }
+        size_t count = std::min(slotLimbs, size - begin);
+        mp_limb_t* dst = mpz_limbs_write(coeffs[k].get_mpz_t(), count);
+        std::copy(limbs + begin, limbs + begin + count, dst);
+        mpz_limbs_finish(coeffs[k].get_mpz_t(), count);
+        field.reduce(coeffs[k]);
+    }
+    return coeffs;
+}
+
+// Product of two dense coefficient vectors, reduced into [0, mod).
+std::vector<BigInt> multiplyDense(const std::vector<BigInt>& a, const std::vector<BigInt>& b, const FieldBackend& field) {
+    const BigInt& mod = field.modulus();
+    if (a.empty() || b.empty()) {
+        return std::vector<BigInt>();
+    }
+    if (std::min(a.size(), b.size()) >= Polynomial::KRONECKER_MIN_LENGTH) {
+        return multiplyKronecker(a, b, field);
+    }
+    // Products are accumulated unreduced and reduced once per output coefficient.
+    std::vector<BigInt> coeffs(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            mpz_addmul(coeffs[i + j].get_mpz_t(), a[i].get_mpz_t(), b[j].get_mpz_t());
+        }
+    }
+    for (BigInt& coeff : coeffs) {
+        coeff %= mod;
     }
+    return coeffs;
 }
 
+} // namespace
+
 void multiplyPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
+    static const unsigned scope = allocationScopeId("polynomial");
+    AllocationScope allocations(scope);
     if (a.mod != b.mod) {
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
+    if (a.length == 0 || b.length == 0) {
+        result.assignDense(std::vector<BigInt>(), a.mod, a.field);
+        return;
+    }
+
+    size_t result_degree = a.length + b.length - 1;
+    if (a.sparse && b.sparse) {
+        std::map<size_t, BigInt> products;
+        for (const SparseTerm& s : a.terms) {
+            for (const SparseTerm& t : b.terms) {
+                mpz_addmul(products[s.exponent + t.exponent].get_mpz_t(), s.coeff.get_mpz_t(), t.coeff.get_mpz_t());
+            }
+        }
+        std::vector<SparseTerm> nonzero;
+        for (auto& entry : products) {
+            entry.second %= a.mod;
+            if (!entry.second.isZero()) {
+                nonzero.push_back(SparseTerm{ entry.first, entry.second });
+            }
+        }
+        result.assignSparse(nonzero, result_degree, a.mod, a.field);
+        return;
+    }
 
-    size_t result_degree = a.coefficients.size() + b.coefficients.size() - 1;
-    result.coefficients.resize(result_degree, BigInt(static_cast<unsigned long int>(0)));
-    result.mod = a.mod;
+    if (!a.sparse && !b.sparse) {
+        result.assignDense(multiplyDense(a.coefficients, b.coefficients, *a.field), a.mod, a.field);
+        return;
+    }
 
-    for (size_t i = 0; i < a.coefficients.size(); ++i) {
-        for (size_t j = 0; j < b.coefficients.size(); ++j) {
-            result.coefficients[i + j] += a.coefficients[i] * b.coefficients[j];
-            result.coefficients[i + j] %= a.mod;
+    // Products are accumulated unreduced and reduced once per output coefficient.
+    std::vector<BigInt> coeffs(result_degree);
+    const Polynomial& s = a.sparse ? a : b;
+    const std::vector<BigInt>& dense = a.sparse ? b.coefficients : a.coefficients;
+    for (const SparseTerm& term : s.terms) {
+        for (size_t j = 0; j < dense.size(); ++j) {
+            mpz_addmul(coeffs[term.exponent + j].get_mpz_t(), term.coeff.get_mpz_t(), dense[j].get_mpz_t());
         }
     }
+    for (BigInt& coeff : coeffs) {
+        coeff %= a.mod;
+    }
+    result.assignDense(coeffs, a.mod, a.field);
 }
 
 void multiplyPolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar) {
-    result.coefficients.resize(poly.coefficients.size());
-    result.mod = poly.mod;
+    if (poly.sparse) {
+        std::vector<SparseTerm> scaled;
+        for (const SparseTerm& term : poly.terms) {
+            BigInt coeff = (term.coeff * scalar) % poly.mod;
+            if (!coeff.isZero()) {
+                scaled.push_back(SparseTerm{ term.exponent, coeff });
+            }
+        }
+        result.assignSparse(scaled, poly.length, poly.mod, poly.field);
+        return;
+    }
 
+    std::vector<BigInt> coeffs(poly.coefficients.size());
     for (size_t i = 0; i < poly.coefficients.size(); ++i) {
-        result.coefficients[i] = poly.coefficients[i] * scalar;
-        result.coefficients[i] %= poly.mod;
+        coeffs[i] = poly.coefficients[i] * scalar;
+        coeffs[i] %= poly.mod;
     }
+    result.assignDense(coeffs, poly.mod, poly.field);
 }
 
 void dividePolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar) {
     if (scalar.isZero()) {
         throw std::invalid_argument("Division by zero is not allowed.");
     }
+    // Throws if the scalar is not invertible in mod.
+    BigInt inverse = scalar.modInverse(poly.mod);
+
+    if (poly.sparse) {
+        std::vector<SparseTerm> scaled;
+        for (const SparseTerm& term : poly.terms) {
+            BigInt coeff = (term.coeff * inverse) % poly.mod;
+            scaled.push_back(SparseTerm{ term.exponent, coeff });
+        }
+        result.assignSparse(scaled, poly.length, poly.mod, poly.field);
+        return;
+    }
 
-    result.coefficients.resize(poly.coefficients.size());
-    result.mod = poly.mod;
-
+    std::vector<BigInt> coeffs(poly.coefficients.size());
     for (size_t i = 0; i < poly.coefficients.size(); ++i) {
-        // Ensure scalar is invertible in mod before division
-        result.coefficients[i] = poly.coefficients[i] * scalar.modInverse(poly.mod);
-        result.coefficients[i] %= poly.mod;
+        coeffs[i] = poly.coefficients[i] * inverse;
+        coeffs[i] %= poly.mod;
+    }
+    result.assignDense(coeffs, poly.mod, poly.field);
+}
+
+void divideBySparse(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &divisor) {
+    if (a.mod != divisor.mod) {
+        throw std::invalid_argument("Moduli of the polynomials must be the same.");
+    }
+    const BigInt& mod = a.mod;
+    std::vector<SparseTerm> dterms;
+    for (const SparseTerm& term : divisor.getTerms()) {
+        BigInt coeff = term.coeff % mod;
+        if (!coeff.isZero()) {
+            dterms.push_back(SparseTerm{ term.exponent, coeff });
+        }
+    }
+    if (dterms.empty()) {
+        throw std::invalid_argument("Division by the zero polynomial is not allowed.");
+    }
+    size_t dd = dterms.back().exponent;
+    BigInt leadInverse = dterms.back().coeff.modInverse(mod);
+    dterms.pop_back();
+
+    // Working copy of the dividend; entries are reduced lazily when they become the leading term.
+    std::vector<BigInt> work = a.getCoefficients();
+    if (work.size() <= dd) {
+        for (BigInt& coeff : work) {
+            coeff %= mod;
+        }
+        quotient.assignDense(std::vector<BigInt>(), mod, a.field);
+        remainder.assignDense(work, mod, a.field);
+        return;
+    }
+
+    std::vector<BigInt> q(work.size() - dd);
+    for (size_t k = work.size(); k-- > dd;) {
+        BigInt& lead = work[k];
+        lead %= mod;
+        if (lead.isZero()) {
+            continue;
+        }
+        BigInt& coeff = q[k - dd];
+        coeff = (lead * leadInverse) % mod;
+        for (const SparseTerm& term : dterms) {
+            mpz_submul(work[k - dd + term.exponent].get_mpz_t(), coeff.get_mpz_t(), term.coeff.get_mpz_t());
+        }
+    }
+    work.resize(dd);
+    for (BigInt& coeff : work) {
+        coeff %= mod;
+    }
+    quotient.assignDense(q, mod, a.field);
+    remainder.assignDense(work, mod, a.field);
+}
+
+namespace {
+
+// Inverse of the power series f modulo x^n by Newton iteration, f[0] must be invertible. If
+// f·g ≡ 1 mod x^k, then g' = g − g·(f·g − 1) satisfies f·g' ≡ 1 mod x^(2k); since f·g − 1 vanishes
+// below x^k, only its coefficients from k on enter the second product.
+std::vector<BigInt> inverseSeries(const std::vector<BigInt>& f, size_t n, const FieldBackend& field) {
+    const BigInt& mod = field.modulus();
+    std::vector<BigInt> g(1, f[0].modInverse(mod));
+    while (g.size() < n) {
+        size_t k = g.size();
+        size_t next = std::min(2 * k, n);
+        std::vector<BigInt> low(f.begin(), f.begin() + std::min(next, f.size()));
+        std::vector<BigInt> error = multiplyDense(low, g, field);
+        std::vector<BigInt> high;
+        if (error.size() > k) {
+            high.assign(error.begin() + k, error.begin() + std::min(next, error.size()));
+        }
+        std::vector<BigInt> correction = multiplyDense(g, high, field);
+        g.resize(next);
+        for (size_t i = 0; i < next - k && i < correction.size(); ++i) {
+            if (!correction[i].isZero()) {
+                g[k + i] = mod - correction[i];
+            }
+        }
+    }
+    return g;
+}
+
+} // namespace
+
+void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b) {
+    static const unsigned scope = allocationScopeId("polynomial");
+    AllocationScope allocations(scope);
+    if (a.mod != b.mod) {
+        throw std::invalid_argument("Moduli of the polynomials must be the same.");
+    }
+    const BigInt& mod = a.mod;
+    if (b.sparse) {
+        divideBySparse(quotient, remainder, a, b);
+        return;
+    }
+
+    std::vector<BigInt> divisor(b.coefficients);
+    for (BigInt& coeff : divisor) {
+        coeff %= mod;
+    }
+    while (!divisor.empty() && divisor.back().isZero()) {
+        divisor.pop_back();
+    }
+    if (divisor.empty()) {
+        throw std::invalid_argument("Division by the zero polynomial is not allowed.");
+    }
+    size_t db = divisor.size() - 1;
+    if (db == 1) {
+        // b1·x + b0 = b1·(x − root): divide by the monic factor, then by b1.
+        BigInt leadInverse = divisor[1].modInverse(mod);
+        BigInt root = (mod - divisor[0]) * leadInverse % mod;
+        Polynomial q(std::vector<BigInt>(), mod);
+        BigInt value;
+        divideByLinear(q, value, a, root);
+        multiplyPolynomialByScalar(quotient, q, leadInverse);
+        remainder.assignDense(std::vector<BigInt>(1, value), mod, a.field);
+        return;
+    }
+    size_t da = a.length == 0 ? 0 : a.length - 1;
+    if (a.length <= db || da - db + 1 < Polynomial::NEWTON_DIVISION_MIN_LENGTH || db + 1 < Polynomial::NEWTON_DIVISION_MIN_LENGTH) {
+        divideBySparse(quotient, remainder, a, Polynomial(divisor, mod));
+        return;
+    }
+
+    std::vector<BigInt> dividend = a.getCoefficients();
+    for (BigInt& coeff : dividend) {
+        coeff %= mod;
+    }
+    size_t m = da - db;
+    // rev(q) = rev(a) · rev(b)^-1 mod x^(m+1), where rev reverses the coefficients of a degree-d polynomial.
+    std::vector<BigInt> reversedA(dividend.rbegin(), dividend.rbegin() + m + 1);
+    std::vector<BigInt> reversedB(divisor.rbegin(), divisor.rbegin() + std::min(db, m) + 1);
+    std::vector<BigInt> q = multiplyDense(reversedA, inverseSeries(reversedB, m + 1, *a.field), *a.field);
+    q.resize(m + 1);
+    std::reverse(q.begin(), q.end());
+
+    // Only the coefficients below deg b of a − q·b survive.
+    std::vector<BigInt> product = multiplyDense(q, divisor, *a.field);
+    std::vector<BigInt> r(db);
+    for (size_t i = 0; i < db; ++i) {
+        r[i] = dividend[i] - product[i];
+        if (r[i].isNegative()) {
+            r[i] += mod;
+        }
+    }
+    quotient.assignDense(q, mod, a.field);
+    remainder.assignDense(r, mod, a.field);
+}
+
+void divideByLinear(Polynomial &quotient, BigInt &remainder, const Polynomial &a, const BigInt &root) {
+    const BigInt& mod = a.mod;
+    const FieldBackend* field = a.field.get();
+    const std::vector<BigInt>& coeffs = a.getCoefficients();
+    BigInt z = root;
+    field->reduce(z);
+
+    std::vector<BigInt> q(coeffs.empty() ? 0 : coeffs.size() - 1);
+    BigInt acc, t;
+    for (size_t i = coeffs.size(); i-- > 0;) {
+        mpz_mul(t.get_mpz_t(), acc.get_mpz_t(), z.get_mpz_t());
+        mpz_add(t.get_mpz_t(), t.get_mpz_t(), coeffs[i].get_mpz_t());
+        field->reduce(t);
+        acc.swap(t);
+        if (i > 0) {
+            q[i - 1] = acc;
+        }
     }
+    remainder = acc;
+    quotient.assignDense(q, mod, a.field);
 }
 
+#ifndef ZKSNARKS_LIBRARY
 int main() {
     std::vector<std::string> coeffs1 = {"1", "-2", "3","15"};
     Polynomial poly1(coeffs1, "7");
@@ -172,3 +806,4 @@ int main() {
 
     return 0;
 }
+#endif // ZKSNARKS_LIBRARY
@@ -0,0 +1,471 @@
+#include "../include/bigint.hpp"
+#include "../include/parallel.hpp"
+#include "../include/poseidon.hpp"
+#include "../include/random.hpp"
+#include "../include/sha256.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+typedef std::vector<std::vector<BigInt>> Matrix;
+
+const BigInt ZERO(static_cast<unsigned long int>(0));
+const BigInt ONE(static_cast<unsigned long int>(1));
+
+double log2Of(const BigInt& value) {
+    signed long exponent;
+    double mantissa = mpz_get_d_2exp(&exponent, value.get_mpz_t());
+    return std::log2(mantissa) + exponent;
+}
+
+double logBase(double x, double base) {
+    return std::log(x) / std::log(base);
+}
+
+double log2Binomial(double n, double k) {
+    return (std::lgamma(n + 1) - std::lgamma(k + 1) - std::lgamma(n - k + 1)) / std::log(2.0);
+}
+
+// The attack bounds of the Poseidon paper (statistical, interpolation, three Gröbner-basis bounds)
+// and the binomial bound of eprint 2023/537, as in the reference round-number script.
+bool secure(double pLog, size_t t, size_t fullRounds, size_t partialRounds, unsigned long alpha, size_t securityBits) {
+    double M = static_cast<double>(securityBits);
+    double T = static_cast<double>(t);
+    double RF = static_cast<double>(fullRounds);
+    double RP = static_cast<double>(partialRounds);
+    double a = static_cast<double>(alpha);
+    double n = std::ceil(pLog);
+
+    double statistical = M <= std::floor(pLog - (a - 1) / 2.0) * (T + 1) ? 6 : 10;
+    double interpolation = 1 + std::ceil(logBase(2, a) * std::min(M, n)) + std::ceil(logBase(T, a)) - RP;
+    double groebner1 = logBase(2, a) * std::min(M, pLog) - RP;
+    double groebner2 = T - 1 + logBase(2, a) * std::min(M / (T + 1), pLog / 2) - RP;
+    double groebner3 = (T - 2 + M / (2 * std::log2(a)) - RP) / (T - 1);
+    double required = std::max(std::max(std::ceil(statistical), std::ceil(interpolation)),
+                               std::max(std::max(std::ceil(groebner1), std::ceil(groebner2)), std::ceil(groebner3)));
+
+    double r = std::floor(T / 3);
+    double over = (RF - 1) * T + RP + r + r * (RF / 2) + RP + a;
+    double under = r * (RF / 2) + RP + a;
+    double binomial = log2Binomial(over, under);
+    if (std::isinf(binomial)) {
+        binomial = M + 1;
+    }
+    return RF >= required && std::ceil(2 * binomial) >= M;
+}
+
+// The round numbers minimizing the S-box count t·R_F + R_P, with the security margin applied.
+void chooseRounds(double pLog, size_t t, unsigned long alpha, size_t securityBits, size_t& fullRounds, size_t& partialRounds) {
+    size_t best = std::numeric_limits<size_t>::max();
+    for (size_t rp = 1; rp < 500; ++rp) {
+        for (size_t rf = 4; rf < 100; rf += 2) {
+            if (!secure(pLog, t, rf, rp, alpha, securityBits)) {
+                continue;
+            }
+            size_t f = rf + 2;
+            size_t p = static_cast<size_t>(std::ceil(rp * 1.075));
+            size_t cost = t * f + p;
+            if (cost < best || (cost == best && f < fullRounds)) {
+                best = cost;
+                fullRounds = f;
+                partialRounds = p;
+            }
+        }
+    }
+}
+
+// Σ matrix[row][j]·state[j] mod p, reducing once at the end.
+void dot(const std::vector<BigInt>& row, const std::vector<BigInt>& state, BigInt& out, const FieldBackend& field) {
+    mpz_mul(out.get_mpz_t(), row[0].get_mpz_t(), state[0].get_mpz_t());
+    for (size_t j = 1; j < state.size(); ++j) {
+        mpz_addmul(out.get_mpz_t(), row[j].get_mpz_t(), state[j].get_mpz_t());
+    }
+    field.reduce(out);
+}
+
+// Solves A·x = b modulo p by Gauss–Jordan elimination; A must be invertible.
+std::vector<BigInt> solve(Matrix a, std::vector<BigInt> b, const FieldBackend& field) {
+    size_t n = b.size();
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        while (pivot < n && a[pivot][col].isZero()) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            throw std::runtime_error("Poseidon MDS submatrix is singular.");
+        }
+        std::swap(a[pivot], a[col]);
+        std::swap(b[pivot], b[col]);
+        BigInt scale = field.inv(a[col][col]);
+        for (size_t j = col; j < n; ++j) {
+            a[col][j] = field.mul(a[col][j], scale);
+        }
+        b[col] = field.mul(b[col], scale);
+        for (size_t row = 0; row < n; ++row) {
+            if (row == col || a[row][col].isZero()) {
+                continue;
+            }
+            BigInt factor = a[row][col];
+            for (size_t j = col; j < n; ++j) {
+                a[row][j] = field.sub(a[row][j], field.mul(factor, a[col][j]));
+            }
+            b[row] = field.sub(b[row], field.mul(factor, b[col]));
+        }
+    }
+    return b;
+}
+
+// diag(1, A)·M, where A is the lower-right block of the factored matrix.
+Matrix pushThrough(const Matrix& block, const Matrix& mds, const FieldBackend& field) {
+    size_t t = mds.size();
+    Matrix out(t, std::vector<BigInt>(t));
+    out[0] = mds[0];
+    std::vector<BigInt> column(t - 1);
+    for (size_t j = 0; j < t; ++j) {
+        for (size_t k = 1; k < t; ++k) {
+            column[k - 1] = mds[k][j];
+        }
+        for (size_t i = 1; i < t; ++i) {
+            dot(block[i - 1], column, out[i][j], field);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+PoseidonParameters PoseidonParameters::generate(const BigInt& modulus, size_t width, size_t securityBits) {
+    if (width < 2) {
+        throw std::invalid_argument("Poseidon width must be at least 2.");
+    }
+    if (modulus.bitSize() <= 64) {
+        throw std::invalid_argument("Poseidon modulus must exceed 2^64.");
+    }
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(modulus);
+
+    PoseidonParameters params;
+    params.modulus = modulus;
+    params.width = width;
+    BigInt order = modulus - ONE;
+    params.alpha = 3;
+    while (mpz_gcd_ui(NULL, order.get_mpz_t(), params.alpha) != 1) {
+        params.alpha += 2;
+    }
+    params.fullRounds = 0;
+    params.partialRounds = 0;
+    chooseRounds(log2Of(modulus), width, params.alpha, securityBits, params.fullRounds, params.partialRounds);
+
+    std::string description = "snark-cpp poseidon|p=" + modulus.toString(16) + "|t=" + std::to_string(width) +
+                              "|alpha=" + std::to_string(params.alpha) + "|RF=" + std::to_string(params.fullRounds) +
+                              "|RP=" + std::to_string(params.partialRounds);
+    ChaCha20Rng rng(Sha256::digest(description));
+
+    size_t rounds = params.fullRounds + params.partialRounds;
+    params.roundConstants.assign(rounds, std::vector<BigInt>(width));
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < width; ++i) {
+            rng.uniform(params.roundConstants[r][i], modulus);
+        }
+    }
+
+    // Cauchy matrix 1/(xᵢ + yⱼ) with distinct xᵢ, distinct yⱼ and no zero sum; every square
+    // submatrix of a Cauchy matrix is again Cauchy, hence invertible, so the matrix is MDS.
+    std::vector<BigInt> xs(width), ys(width);
+    bool valid = false;
+    while (!valid) {
+        for (size_t i = 0; i < width; ++i) {
+            rng.uniform(xs[i], modulus);
+            rng.uniform(ys[i], modulus);
+        }
+        valid = true;
+        for (size_t i = 0; i < width && valid; ++i) {
+            for (size_t j = 0; j < width && valid; ++j) {
+                valid = field->add(xs[i], ys[j]) != ZERO && (i == j || (xs[i] != xs[j] && ys[i] != ys[j]));
+            }
+        }
+    }
+    params.mds.assign(width, std::vector<BigInt>(width));
+    for (size_t i = 0; i < width; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+            params.mds[i][j] = field->inv(field->add(xs[i], ys[j]));
+        }
+    }
+    return params;
+}
+
+Poseidon::Poseidon(const PoseidonParameters& parameters) : params(parameters), field(FieldBackend::forModulus(parameters.modulus)) {
+    size_t t = params.width;
+    size_t half = params.fullRounds / 2;
+    if (t < 2 || params.fullRounds == 0 || params.fullRounds % 2 != 0 || params.alpha < 3 ||
+        params.roundConstants.size() != params.fullRounds + params.partialRounds || params.mds.size() != t) {
+        throw std::invalid_argument("Inconsistent Poseidon parameters.");
+    }
+    for (const std::vector<BigInt>& row : params.roundConstants) {
+        if (row.size() != t) {
+            throw std::invalid_argument("Inconsistent Poseidon parameters.");
+        }
+    }
+    for (const std::vector<BigInt>& row : params.mds) {
+        if (row.size() != t) {
+            throw std::invalid_argument("Inconsistent Poseidon parameters.");
+        }
+    }
+
+    // A partial round leaves state elements 1..t − 1 alone until the matrix, so their constants can
+    // be added after it instead: M·(0, c₁, …) joins the constants of the next round. Only the first
+    // constant of each partial round remains, and the last carry lands in the next full round.
+    fullConstants.assign(params.roundConstants.begin(), params.roundConstants.begin() + half);
+    partialConstants.resize(params.partialRounds);
+    std::vector<BigInt> carry(t, ZERO);
+    std::vector<BigInt> shifted(t);
+    for (size_t r = 0; r < params.partialRounds; ++r) {
+        const std::vector<BigInt>& constants = params.roundConstants[half + r];
+        partialConstants[r] = field->add(constants[0], carry[0]);
+        shifted[0] = ZERO;
+        for (size_t i = 1; i < t; ++i) {
+            shifted[i] = field->add(constants[i], carry[i]);
+        }
+        for (size_t i = 0; i < t; ++i) {
+            dot(params.mds[i], shifted, carry[i], *field);
+        }
+    }
+    for (size_t r = half + params.partialRounds; r < params.roundConstants.size(); ++r) {
+        fullConstants.push_back(params.roundConstants[r]);
+    }
+    for (size_t i = 0; i < t; ++i) {
+        fullConstants[half][i] = field->add(fullConstants[half][i], carry[i]);
+    }
+
+    // Factor each partial-round matrix X = S·diag(1, A), where S is sparse. diag(1, A) commutes with
+    // the S-box and the constant on element 0, so it moves into the previous round's matrix,
+    // working backwards from the last partial round to the last full round before them.
+    Matrix current = params.mds;
+    sparse.resize(params.partialRounds);
+    Matrix block(t - 1, std::vector<BigInt>(t - 1));
+    std::vector<BigInt> firstRow(t - 1);
+    for (size_t r = params.partialRounds; r-- > 0;) {
+        Matrix transposed(t - 1, std::vector<BigInt>(t - 1));
+        for (size_t i = 1; i < t; ++i) {
+            firstRow[i - 1] = current[0][i];
+            for (size_t j = 1; j < t; ++j) {
+                block[i - 1][j - 1] = current[i][j];
+                transposed[j - 1][i - 1] = current[i][j];
+            }
+        }
+        SparseMatrix& s = sparse[r];
+        s.m00 = current[0][0];
+        s.w.resize(t - 1);
+        for (size_t i = 1; i < t; ++i) {
+            s.w[i - 1] = current[i][0];
+        }
+        // The first row of S·diag(1, A) is (m00, uᵀA), so u solves Aᵀu = (X₀₁, …, X₀,ₜ₋₁).
+        s.u = solve(transposed, firstRow, *field);
+        current = pushThrough(block, params.mds, *field);
+    }
+    preSparse = current;
+}
+
+std::shared_ptr<const Poseidon> Poseidon::forModulus(const BigInt& modulus, size_t width) {
+    static std::mutex cacheMutex;
+    static std::vector<std::shared_ptr<const Poseidon>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (const auto& instance : cache) {
+        if (instance->params.modulus == modulus && instance->params.width == width) {
+            return instance;
+        }
+    }
+    std::shared_ptr<const Poseidon> instance = std::make_shared<Poseidon>(PoseidonParameters::generate(modulus, width));
+    cache.push_back(instance);
+    return instance;
+}
+
+void Poseidon::sbox(BigInt& x) const {
+    BigInt base = x;
+    int top = 63 - __builtin_clzl(params.alpha);
+    for (int bit = top - 1; bit >= 0; --bit) {
+        x = field->sqr(x);
+        if ((params.alpha >> bit) & 1) {
+            x = field->mul(x, base);
+        }
+    }
+}
+
+void Poseidon::multiply(const Matrix& matrix, std::vector<BigInt>& state, std::vector<BigInt>& scratch) const {
+    for (size_t i = 0; i < state.size(); ++i) {
+        dot(matrix[i], state, scratch[i], *field);
+    }
+    for (size_t i = 0; i < state.size(); ++i) {
+        state[i].swap(scratch[i]);
+    }
+}
+
+void Poseidon::permute(std::vector<BigInt>& state) const {
+    size_t t = params.width;
+    if (state.size() != t) {
+        throw std::invalid_argument("Poseidon state has the wrong width.");
+    }
+    size_t half = params.fullRounds / 2;
+    std::vector<BigInt> scratch(t);
+    BigInt first;
+
+    for (size_t r = 0; r < half; ++r) {
+        for (size_t i = 0; i < t; ++i) {
+            state[i] += fullConstants[r][i];
+            field->reduce(state[i]);
+            sbox(state[i]);
+        }
+        multiply(r + 1 == half ? preSparse : params.mds, state, scratch);
+    }
+    for (size_t r = 0; r < params.partialRounds; ++r) {
+        const SparseMatrix& s = sparse[r];
+        state[0] += partialConstants[r];
+        field->reduce(state[0]);
+        sbox(state[0]);
+        mpz_mul(first.get_mpz_t(), s.m00.get_mpz_t(), state[0].get_mpz_t());
+        for (size_t i = 1; i < t; ++i) {
+            mpz_addmul(first.get_mpz_t(), s.u[i - 1].get_mpz_t(), state[i].get_mpz_t());
+            mpz_addmul(state[i].get_mpz_t(), s.w[i - 1].get_mpz_t(), state[0].get_mpz_t());
+            field->reduce(state[i]);
+        }
+        field->reduce(first);
+        state[0].swap(first);
+    }
+    for (size_t r = half; r < params.fullRounds; ++r) {
+        for (size_t i = 0; i < t; ++i) {
+            state[i] += fullConstants[r][i];
+            field->reduce(state[i]);
+            sbox(state[i]);
+        }
+        multiply(params.mds, state, scratch);
+    }
+}
+
+BigInt Poseidon::hash(const std::vector<BigInt>& inputs) const {
+    size_t t = params.width;
+    std::vector<BigInt> state(t, ZERO);
+    mpz_mul_2exp(state[0].get_mpz_t(), BigInt(static_cast<unsigned long int>(inputs.size())).get_mpz_t(), 64);
+    field->reduce(state[0]);
+    size_t next = 0;
+    do {
+        for (size_t i = 1; i < t && next < inputs.size(); ++i, ++next) {
+            state[i] += inputs[next];
+            field->reduce(state[i]);
+        }
+        permute(state);
+    } while (next < inputs.size());
+    return state[1];
+}
+
+std::vector<BigInt> Poseidon::hashBatch(const std::vector<std::vector<BigInt>>& inputs, unsigned threads) const {
+    std::vector<BigInt> digests(inputs.size());
+    parallelFor(inputs.size(), [&](size_t i) {
+        digests[i] = hash(inputs[i]);
+    }, threads);
+    return digests;
+}
+
+std::vector<BigInt> Poseidon::merkleLevel(const std::vector<BigInt>& nodes, unsigned threads) const {
+    if (nodes.empty()) {
+        throw std::invalid_argument("Merkle level must not be empty.");
+    }
+    size_t arity = rate();
+    std::vector<BigInt> parents((nodes.size() + arity - 1) / arity);
+    parallelFor(parents.size(), [&](size_t i) {
+        std::vector<BigInt> children(arity, ZERO);
+        for (size_t j = 0; j < arity && i * arity + j < nodes.size(); ++j) {
+            children[j] = nodes[i * arity + j];
+        }
+        parents[i] = hash(children);
+    }, threads);
+    return parents;
+}
+
+BigInt Poseidon::merkleRoot(const std::vector<BigInt>& leaves, unsigned threads) const {
+    std::vector<BigInt> level = merkleLevel(leaves, threads);
+    while (level.size() > 1) {
+        level = merkleLevel(level, threads);
+    }
+    return level[0];
+}
+
+PoseidonTranscript::PoseidonTranscript(const BigInt& modulus, const std::string& label)
+    : PoseidonTranscript(Poseidon::forModulus(modulus), label) {
+}
+
+PoseidonTranscript::PoseidonTranscript(std::shared_ptr<const Poseidon> instance, const std::string& label)
+    : hash(instance), state(instance->parameters().width, ZERO), position(0) {
+    // The capacity holds the label length plus one, which no hash() domain tag (a multiple of 2⁶⁴)
+    // equals; the label bytes follow in big-endian chunks that fit below p.
+    state[0] = BigInt(static_cast<unsigned long int>(label.size() + 1));
+    size_t chunk = (hash->parameters().modulus.bitSize() - 1) / 8;
+    for (size_t offset = 0; offset < label.size(); offset += chunk) {
+        BigInt value;
+        size_t length = std::min(chunk, label.size() - offset);
+        mpz_import(value.get_mpz_t(), length, 1, 1, 1, 0, label.data() + offset);
+        absorb(value);
+    }
+}
+
+void PoseidonTranscript::absorb(const BigInt& value) {
+    if (position == hash->rate()) {
+        hash->permute(state);
+        position = 0;
+    }
+    BigInt& slot = state[1 + position];
+    slot += value;
+    hash->getField().reduce(slot);
+    ++position;
+}
+
+void PoseidonTranscript::absorb(const std::vector<BigInt>& values) {
+    for (const BigInt& value : values) {
+        absorb(value);
+    }
+}
+
+void PoseidonTranscript::absorb(const Ecc_Point& point) {
+    size_t chunkBits = hash->parameters().modulus.bitSize() - 1;
+    size_t chunks = (point.getCurveParameters().p.bitSize() + chunkBits - 1) / chunkBits;
+    if (point.isInfinity) {
+        absorb(ONE);
+        for (size_t i = 0; i < 2 * chunks; ++i) {
+            absorb(ZERO);
+        }
+        return;
+    }
+    absorb(ZERO);
+    absorbChunks(point.getX(), chunks);
+    absorbChunks(point.getY(), chunks);
+}
+
+void PoseidonTranscript::absorbChunks(const BigInt& value, size_t chunks) {
+    size_t chunkBits = hash->parameters().modulus.bitSize() - 1;
+    BigInt rest = value;
+    BigInt low;
+    for (size_t i = 0; i < chunks; ++i) {
+        mpz_fdiv_r_2exp(low.get_mpz_t(), rest.get_mpz_t(), chunkBits);
+        mpz_fdiv_q_2exp(rest.get_mpz_t(), rest.get_mpz_t(), chunkBits);
+        absorb(low);
+    }
+}
+
+BigInt PoseidonTranscript::challenge() {
+    absorb(ONE);
+    hash->permute(state);
+    position = hash->rate();
+    return state[1];
+}
+
+std::vector<BigInt> PoseidonTranscript::challenges(size_t count) {
+    std::vector<BigInt> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(challenge());
+    }
+    return out;
+}
@@ -0,0 +1,529 @@
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/framing.hpp"
+#include "../include/io.hpp"
+#include "../include/msm.hpp"
+#include "../include/parallel.hpp"
+#include "../include/polynomial.hpp"
+#include "../include/prover.hpp"
+#include "../include/sha256.hpp"
+#include "../include/srs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct ProverService::Circuit {
+    CompiledCircuit circuit;
+};
+
+struct ProverService::Job {
+    ProofRequest request;
+    std::shared_ptr<const Circuit> circuit;
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    std::promise<ProofResponse> promise;
+};
+
+struct ProverService::Session {
+    std::mutex mutex;                        ///< Held while a proof updates the session.
+    std::shared_ptr<const Circuit> circuit;  ///< Circuit of the previous proof; null before the first.
+    std::vector<BigInt> values;              ///< Witness values of the previous proof.
+    Ecc_Point commitment;                    ///< Commitment of the previous proof.
+    std::list<std::string>::iterator recent; ///< Position in recentSessions; guarded by the service mutex.
+};
+
+namespace {
+
+const uint32_t FRAME_REQUEST = 1;
+const uint32_t FRAME_RESPONSE = 2;
+const uint32_t FRAME_END_SESSION = 3;
+
+// Length-prefixed big-endian encoding of a non-negative value.
+void storeBig(std::vector<unsigned char>& out, const BigInt& v) {
+    size_t count = 0;
+    std::vector<unsigned char> raw((v.bitSize() + 7) / 8 + 1);
+    mpz_export(raw.data(), &count, 1, 1, 1, 0, v.get_mpz_t());
+    storeLE(out, count, 4);
+    out.insert(out.end(), raw.begin(), raw.begin() + count);
+}
+
+void storePoint(std::vector<unsigned char>& out, const Ecc_Point& point) {
+    out.push_back(point.isInfinity ? 1 : 0);
+    if (!point.isInfinity) {
+        storeBig(out, point.getX());
+        storeBig(out, point.getY());
+    }
+}
+
+// Bounds-checked cursor over a received payload.
+class Reader {
+public:
+    explicit Reader(const std::vector<unsigned char>& payload) : data(payload), offset(0) {}
+
+    bool done() const { return offset == data.size(); }
+
+    const unsigned char* take(size_t size) {
+        if (size > data.size() - offset) {
+            throw std::runtime_error("Malformed prover frame.");
+        }
+        offset += size;
+        return data.data() + offset - size;
+    }
+
+    uint64_t integer(size_t bytes) { return loadLE(take(bytes), bytes); }
+
+    BigInt big() {
+        size_t count = static_cast<size_t>(integer(4));
+        BigInt result;
+        mpz_import(result.get_mpz_t(), count, 1, 1, 1, 0, take(count));
+        return result;
+    }
+
+    Ecc_Point point(const CurveParameters& curve) {
+        if (integer(1) != 0) {
+            return Ecc_Point();
+        }
+        BigInt x = big();
+        return Ecc_Point(x, big(), curve);
+    }
+
+    std::string rest() {
+        std::string result(data.begin() + offset, data.end());
+        offset = data.size();
+        return result;
+    }
+
+private:
+    const std::vector<unsigned char>& data;
+    size_t offset;
+};
+
+std::vector<unsigned char> encodeRequest(const ProofRequest& request, const BigInt& order) {
+    std::vector<unsigned char> payload;
+    storeLE(payload, request.circuit.size(), 4);
+    payload.insert(payload.end(), request.circuit.begin(), request.circuit.end());
+    storeLE(payload, request.deadlineMs, 4);
+    storeLE(payload, request.inputs.size(), 4);
+    for (const BigInt& input : request.inputs) {
+        storeBig(payload, input % order);
+    }
+    storeLE(payload, request.session.size(), 4);
+    payload.insert(payload.end(), request.session.begin(), request.session.end());
+    return payload;
+}
+
+ProofRequest decodeRequest(const std::vector<unsigned char>& payload) {
+    Reader reader(payload);
+    ProofRequest request;
+    size_t nameLength = static_cast<size_t>(reader.integer(4));
+    const unsigned char* name = reader.take(nameLength);
+    request.circuit.assign(name, name + nameLength);
+    request.deadlineMs = static_cast<uint32_t>(reader.integer(4));
+    size_t count = static_cast<size_t>(reader.integer(4));
+    for (size_t i = 0; i < count; ++i) {
+        request.inputs.push_back(reader.big());
+    }
+    if (!reader.done()) {
+        size_t sessionLength = static_cast<size_t>(reader.integer(4));
+        const unsigned char* session = reader.take(sessionLength);
+        request.session.assign(session, session + sessionLength);
+    }
+    return request;
+}
+
+std::vector<unsigned char> encodeResponse(const ProofResponse& response) {
+    std::vector<unsigned char> payload;
+    payload.push_back(static_cast<unsigned char>(response.status));
+    if (response.status == ProofStatus::Ok) {
+        storePoint(payload, response.commitment);
+        storeBig(payload, response.opening.point);
+        storeBig(payload, response.opening.value);
+        storePoint(payload, response.opening.witness);
+    } else {
+        payload.insert(payload.end(), response.error.begin(), response.error.end());
+    }
+    return payload;
+}
+
+ProofResponse decodeResponse(const std::vector<unsigned char>& payload, const CurveParameters& curve) {
+    Reader reader(payload);
+    ProofResponse response;
+    uint64_t status = reader.integer(1);
+    if (status > static_cast<uint64_t>(ProofStatus::Failed)) {
+        throw std::runtime_error("Malformed prover frame.");
+    }
+    response.status = static_cast<ProofStatus>(status);
+    if (response.status == ProofStatus::Ok) {
+        response.commitment = reader.point(curve);
+        response.opening.point = reader.big();
+        response.opening.value = reader.big();
+        response.opening.witness = reader.point(curve);
+    } else {
+        response.error = reader.rest();
+    }
+    return response;
+}
+
+void serveConnection(ProverService& service, int fd) {
+    uint32_t type;
+    std::vector<unsigned char> payload;
+    while (readFrame(fd, type, payload)) {
+        if (type == FRAME_END_SESSION) {
+            service.endSession(std::string(payload.begin(), payload.end()));
+            continue;
+        }
+        if (type != FRAME_REQUEST) {
+            break;
+        }
+        ProofResponse response;
+        try {
+            response = service.prove(decodeRequest(payload));
+        } catch (const std::exception& e) {
+            response.error = e.what();
+        }
+        writeFrame(fd, FRAME_RESPONSE, encodeResponse(response));
+    }
+}
+
+} // namespace
+
+BigInt proofChallenge(const std::string& circuit, const Ecc_Point& commitment, const BigInt& order) {
+    Sha256 hasher;
+    hasher.update("snark-cpp proof challenge");
+    hasher.update(reinterpret_cast<const uint8_t*>(circuit.c_str()), circuit.size() + 1);
+    if (commitment.isInfinity) {
+        hasher.update("infinity");
+    } else {
+        hasher.update(commitment.getX().toString(16) + ":" + commitment.getY().toString(16));
+    }
+    uint8_t digest[Sha256::DIGEST_SIZE];
+    hasher.finish(digest);
+    BigInt challenge;
+    mpz_import(challenge.get_mpz_t(), Sha256::DIGEST_SIZE, 1, 1, 1, 0, digest);
+    return challenge % order;
+}
+
+ProverService::ProverService(const CurveParameters& curve, const std::string& srsPath, size_t maxPending,
+                             size_t maxBatch, unsigned threads, size_t maxSessions)
+    : curve(curve), maxPending(maxPending), maxBatch(maxBatch), threads(threads), maxSessions(maxSessions),
+      stopping(false), listener(-1) {
+    if (maxPending == 0 || maxBatch == 0 || maxSessions == 0) {
+        throw std::invalid_argument("Queue, batch and session limits must be positive.");
+    }
+    setup = kzgLoadSetup(srsPath, curve);
+    counters = ProverStats();
+}
+
+ProverService::~ProverService() {
+    stop();
+}
+
+void ProverService::registerCircuit(const std::string& name, const CompiledCircuit& circuit) {
+    if (circuit.getModulus() != curve.n) {
+        throw std::invalid_argument("Circuit modulus must be the curve order.");
+    }
+    if (circuit.witnessSize() > maxWitnessSize()) {
+        throw std::invalid_argument("Circuit witness has " + std::to_string(circuit.witnessSize()) +
+                                    " values; the reference string covers at most " + std::to_string(maxWitnessSize()) + ".");
+    }
+    std::shared_ptr<Circuit> entry = std::make_shared<Circuit>();
+    entry->circuit = circuit;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    circuits[name] = entry;
+}
+
+size_t ProverService::maxWitnessSize() const {
+    return setup.powersOfTau.size();
+}
+
+void ProverService::start(unsigned workerCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!workers.empty() || stopping) {
+        return;
+    }
+    for (unsigned i = 0; i < std::max(workerCount, 1u); ++i) {
+        workers.push_back(std::thread(&ProverService::work, this));
+    }
+}
+
+std::future<ProofResponse> ProverService::submit(const ProofRequest& request) {
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    std::future<ProofResponse> result = job->promise.get_future();
+    ProofResponse immediate;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, std::shared_ptr<const Circuit>>::const_iterator found = circuits.find(request.circuit);
+        if (stopping) {
+            immediate.error = "Prover service is stopped.";
+        } else if (found == circuits.end()) {
+            immediate.status = ProofStatus::UnknownCircuit;
+            immediate.error = "Unknown circuit: " + request.circuit;
+        } else if (queue.size() >= maxPending) {
+            immediate.status = ProofStatus::Busy;
+            ++counters.rejected;
+        } else {
+            job->request = request;
+            job->circuit = found->second;
+            job->hasDeadline = request.deadlineMs != 0;
+            job->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(request.deadlineMs);
+            queue.push_back(job);
+            ++counters.accepted;
+            ready.notify_one();
+            return result;
+        }
+    }
+    job->promise.set_value(immediate);
+    return result;
+}
+
+ProofResponse ProverService::proveJob(const Job& job) {
+    static const unsigned scope = allocationScopeId("prover");
+    AllocationScope allocations(scope);
+    if (!job.request.session.empty()) {
+        return proveSession(job);
+    }
+    const Circuit& circuit = *job.circuit;
+    Polynomial witness(circuit.circuit.evaluate(job.request.inputs, 1), curve.n);
+
+    ProofResponse response;
+    response.commitment = kzgCommit(setup, witness);
+    response.opening = kzgOpen(setup, witness, proofChallenge(job.request.circuit, response.commitment, curve.n));
+    response.status = ProofStatus::Ok;
+    return response;
+}
+
+ProofResponse ProverService::proveSession(const Job& job) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, std::shared_ptr<Session>>::iterator found = sessions.find(job.request.session);
+        if (found != sessions.end()) {
+            session = found->second;
+            recentSessions.splice(recentSessions.begin(), recentSessions, session->recent);
+        } else {
+            // A proof still running on an evicted session finishes on its own copy of the state.
+            if (sessions.size() >= maxSessions) {
+                sessions.erase(recentSessions.back());
+                recentSessions.pop_back();
+            }
+            session = std::make_shared<Session>();
+            recentSessions.push_front(job.request.session);
+            session->recent = recentSessions.begin();
+            sessions[job.request.session] = session;
+        }
+    }
+    std::vector<BigInt> values = job.circuit->circuit.evaluate(job.request.inputs, 1);
+
+    // Proofs of one session run one at a time, each against the state its predecessor left.
+    std::lock_guard<std::mutex> hold(session->mutex);
+    Polynomial witness(values, curve.n);
+    ProofResponse response;
+    if (session->circuit == job.circuit) {
+        std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(curve.n);
+        std::vector<Ecc_Point> points;
+        std::vector<BigInt> deltas;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] != session->values[i]) {
+                points.push_back(setup.powersOfTau[i]);
+                deltas.push_back(field->sub(values[i], session->values[i]));
+            }
+        }
+        response.commitment = session->commitment + multiScalarMul(points, deltas);
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.incremental;
+    } else {
+        response.commitment = kzgCommit(setup, witness);
+    }
+    response.opening = kzgOpen(setup, witness, proofChallenge(job.request.circuit, response.commitment, curve.n));
+    response.status = ProofStatus::Ok;
+
+    session->circuit = job.circuit;
+    session->values.swap(values);
+    session->commitment = response.commitment;
+    return response;
+}
+
+void ProverService::endSession(const std::string& session) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, std::shared_ptr<Session>>::iterator found = sessions.find(session);
+    if (found != sessions.end()) {
+        recentSessions.erase(found->second->recent);
+        sessions.erase(found);
+    }
+}
+
+void ProverService::work() {
+    for (;;) {
+        std::vector<std::shared_ptr<Job>> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            // Take every queued job for the circuit at the head of the queue, in arrival order.
+            std::shared_ptr<const Circuit> circuit = queue.front()->circuit;
+            for (std::deque<std::shared_ptr<Job>>::iterator it = queue.begin(); it != queue.end() && batch.size() < maxBatch;) {
+                if ((*it)->circuit == circuit) {
+                    batch.push_back(*it);
+                    it = queue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            ++counters.batches;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::vector<std::shared_ptr<Job>> live;
+        std::vector<std::shared_ptr<Job>> expired;
+        for (const std::shared_ptr<Job>& job : batch) {
+            (job->hasDeadline && now > job->deadline ? expired : live).push_back(job);
+        }
+        std::vector<ProofResponse> responses(live.size());
+        parallelFor(live.size(), [&](size_t i) {
+            try {
+                responses[i] = proveJob(*live[i]);
+            } catch (const std::exception& e) {
+                responses[i].status = ProofStatus::Failed;
+                responses[i].error = e.what();
+            }
+        }, threads);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.expired += expired.size();
+            counters.proved += live.size();
+        }
+        for (const std::shared_ptr<Job>& job : expired) {
+            ProofResponse response;
+            response.status = ProofStatus::DeadlineExceeded;
+            job->promise.set_value(response);
+        }
+        for (size_t i = 0; i < live.size(); ++i) {
+            live[i]->promise.set_value(responses[i]);
+        }
+    }
+}
+
+void ProverService::serve(const std::string& socketPath, size_t maxConnections) {
+    sockaddr_un address = socketAddress(socketPath);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Cannot create prover socket: ") + std::strerror(errno));
+    }
+    unlink(socketPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot listen on " + socketPath + ": " + std::strerror(errno));
+    }
+    listener = fd;
+
+    // Each connection has its own handler thread. Finished handlers are joined whenever another
+    // connection arrives, so a long-running server holds only the threads of live connections.
+    struct Handler {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+    std::list<Handler> handlers;
+    auto reap = [&handlers] {
+        for (auto it = handlers.begin(); it != handlers.end();) {
+            if (it->finished->load()) {
+                it->thread.join();
+                it = handlers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+    for (size_t accepted = 0; maxConnections == 0 || accepted < maxConnections; ++accepted) {
+        int connection = accept(fd, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                --accepted;
+                continue;
+            }
+            break;
+        }
+        reap();
+        std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+        handlers.push_back(Handler{ std::thread([this, connection, finished] {
+            try {
+                serveConnection(*this, connection);
+            } catch (const std::exception&) {
+                // A broken connection only ends that session.
+            }
+            close(connection);
+            finished->store(true);
+        }), finished });
+    }
+    for (Handler& handler : handlers) {
+        handler.thread.join();
+    }
+    listener = -1;
+    close(fd);
+    unlink(socketPath.c_str());
+}
+
+void ProverService::stop() {
+    std::vector<std::thread> running;
+    std::deque<std::shared_ptr<Job>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        running.swap(workers);
+        abandoned.swap(queue);
+    }
+    ready.notify_all();
+    int fd = listener;
+    if (fd >= 0) {
+        shutdown(fd, SHUT_RDWR);
+    }
+    for (std::thread& worker : running) {
+        worker.join();
+    }
+    for (const std::shared_ptr<Job>& job : abandoned) {
+        ProofResponse response;
+        response.error = "Prover service is stopped.";
+        job->promise.set_value(response);
+    }
+}
+
+ProverStats ProverService::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+int connectProver(const std::string& socketPath) {
+    sockaddr_un address = socketAddress(socketPath);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Cannot create prover socket: ") + std::strerror(errno));
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot connect to prover at " + socketPath + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+void endProverSession(int fd, const std::string& session) {
+    writeFrame(fd, FRAME_END_SESSION, std::vector<unsigned char>(session.begin(), session.end()));
+}
+
+ProofResponse requestProof(int fd, const ProofRequest& request, const CurveParameters& curve) {
+    writeFrame(fd, FRAME_REQUEST, encodeRequest(request, curve.n));
+    uint32_t type;
+    std::vector<unsigned char> payload;
+    if (!readFrame(fd, type, payload) || type != FRAME_RESPONSE) {
+        throw std::runtime_error("Prover closed the connection without a response.");
+    }
+    return decodeResponse(payload, curve);
+}
@@ -0,0 +1,266 @@
+#include "../include/bigint.hpp"
+#include "../include/parallel.hpp"
+#include "../include/random.hpp"
+#include "../include/sha256.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDOM_X86 1
+#endif
+
+namespace {
+
+const size_t LANES = ChaCha20Rng::BUFFER_BLOCKS;
+
+// Elements per stream in sampleUniform().
+const size_t SAMPLE_CHUNK = 1024;
+
+typedef void (*BlockKernel)(uint32_t* out, const uint32_t* key, uint64_t nonce, uint64_t counter);
+
+// Word i of every lane's state; GCC and Clang lower operations on it to SIMD instructions.
+typedef uint32_t Lanes __attribute__((vector_size(sizeof(uint32_t) * LANES)));
+
+__attribute__((always_inline)) inline void rotate(Lanes& v, int c) {
+    v = (v << c) | (v >> (32 - c));
+}
+
+__attribute__((always_inline)) inline void quarterRound(Lanes (&x)[16], int a, int b, int c, int d) {
+    x[a] += x[b]; x[d] ^= x[a]; rotate(x[d], 16);
+    x[c] += x[d]; x[b] ^= x[c]; rotate(x[b], 12);
+    x[a] += x[b]; x[d] ^= x[a]; rotate(x[d], 8);
+    x[c] += x[d]; x[b] ^= x[c]; rotate(x[b], 7);
+}
+
+// Keystream blocks counter .. counter + LANES - 1, one per lane, written block after block.
+__attribute__((always_inline)) inline void chachaBlocks(uint32_t* out, const uint32_t* key, uint64_t nonce, uint64_t counter) {
+    static const uint32_t SIGMA[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 }; // "expand 32-byte k"
+    Lanes s[16];
+    for (size_t i = 0; i < 4; ++i) {
+        s[i] = Lanes{} + SIGMA[i];
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        s[4 + i] = Lanes{} + key[i];
+    }
+    for (size_t j = 0; j < LANES; ++j) {
+        uint64_t block = counter + j;
+        s[12][j] = static_cast<uint32_t>(block);
+        s[13][j] = static_cast<uint32_t>(block >> 32);
+    }
+    s[14] = Lanes{} + static_cast<uint32_t>(nonce);
+    s[15] = Lanes{} + static_cast<uint32_t>(nonce >> 32);
+
+    Lanes x[16];
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] = s[i];
+    }
+    for (int round = 0; round < 10; ++round) {
+        quarterRound(x, 0, 4, 8, 12);
+        quarterRound(x, 1, 5, 9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7, 8, 13);
+        quarterRound(x, 3, 4, 9, 14);
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        x[i] += s[i];
+    }
+    for (size_t j = 0; j < LANES; ++j) {
+        for (size_t i = 0; i < 16; ++i) {
+            out[j * 16 + i] = x[i][j];
+        }
+    }
+}
+
+void blocksGeneric(uint32_t* out, const uint32_t* key, uint64_t nonce, uint64_t counter) {
+    chachaBlocks(out, key, nonce, counter);
+}
+
+#ifdef RANDOM_X86
+__attribute__((target("avx2")))
+void blocksAvx2(uint32_t* out, const uint32_t* key, uint64_t nonce, uint64_t counter) {
+    chachaBlocks(out, key, nonce, counter);
+}
+#endif
+
+BlockKernel selectKernel() {
+#ifdef RANDOM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return blocksAvx2;
+    }
+#endif
+    return blocksGeneric;
+}
+
+void blocks(uint32_t* out, const uint32_t* key, uint64_t nonce, uint64_t counter) {
+    static const BlockKernel kernel = selectKernel();
+    kernel(out, key, nonce, counter);
+}
+
+void checkBound(const BigInt& bound) {
+    if (bound.isZero() || bound.isNegative()) {
+        throw std::invalid_argument("Sampling bound must be positive.");
+    }
+}
+
+// The SHA-256 digest of the seed as eight little-endian bytes.
+std::string seedKey(uint64_t seed) {
+    std::string bytes;
+    for (size_t i = 0; i < 8; ++i) {
+        bytes.push_back(static_cast<char>(seed >> (8 * i)));
+    }
+    return Sha256::digest(bytes);
+}
+
+} // namespace
+
+static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), "ChaCha20Rng writes 64-bit GMP limbs.");
+
+ChaCha20Rng::ChaCha20Rng(uint64_t seed, uint64_t stream) : ChaCha20Rng(seedKey(seed), stream) {
+}
+
+ChaCha20Rng::ChaCha20Rng(const std::string& bytes, uint64_t stream) : nonce(stream), counter(0), position(BUFFER_BLOCKS * 16) {
+    if (bytes.size() != KEY_SIZE) {
+        throw std::invalid_argument("ChaCha20 key must be 32 bytes.");
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        key[i] = static_cast<uint8_t>(bytes[4 * i]) | static_cast<uint32_t>(static_cast<uint8_t>(bytes[4 * i + 1])) << 8 |
+                 static_cast<uint32_t>(static_cast<uint8_t>(bytes[4 * i + 2])) << 16 |
+                 static_cast<uint32_t>(static_cast<uint8_t>(bytes[4 * i + 3])) << 24;
+    }
+}
+
+ChaCha20Rng ChaCha20Rng::fromEntropy(uint64_t stream) {
+    std::random_device device;
+    std::string bytes;
+    for (size_t i = 0; i < KEY_SIZE / 4; ++i) {
+        uint32_t word = device();
+        for (size_t b = 0; b < 4; ++b) {
+            bytes.push_back(static_cast<char>(word >> (8 * b)));
+        }
+    }
+    return ChaCha20Rng(bytes, stream);
+}
+
+ChaCha20Rng ChaCha20Rng::fork(uint64_t stream) const {
+    ChaCha20Rng other(*this);
+    other.nonce = stream;
+    other.seek(0);
+    return other;
+}
+
+void ChaCha20Rng::seek(uint64_t block) {
+    counter = block;
+    position = BUFFER_BLOCKS * 16;
+}
+
+void ChaCha20Rng::refill() {
+    blocks(buffer, key, nonce, counter);
+    counter += BUFFER_BLOCKS;
+    position = 0;
+}
+
+uint32_t ChaCha20Rng::nextU32() {
+    if (position == BUFFER_BLOCKS * 16) {
+        refill();
+    }
+    return buffer[position++];
+}
+
+uint64_t ChaCha20Rng::nextU64() {
+    uint64_t low = nextU32();
+    return low | static_cast<uint64_t>(nextU32()) << 32;
+}
+
+void ChaCha20Rng::fill(uint8_t* out, size_t length) {
+    // Whole words are consumed; the unused bytes of a final partial word are discarded.
+    for (size_t i = 0; i < length; i += 4) {
+        uint32_t word = nextU32();
+        for (size_t b = 0; b < 4 && i + b < length; ++b) {
+            out[i + b] = static_cast<uint8_t>(word >> (8 * b));
+        }
+    }
+}
+
+void ChaCha20Rng::uniformLimbs(uint64_t* out, const uint64_t* bound, size_t limbs) {
+    if (limbs == 0 || bound[limbs - 1] == 0) {
+        throw std::invalid_argument("Sampling bound must have a nonzero top limb.");
+    }
+    uint64_t mask = ~static_cast<uint64_t>(0) >> __builtin_clzll(bound[limbs - 1]);
+    while (true) {
+        for (size_t i = 0; i < limbs; ++i) {
+            out[i] = nextU64();
+        }
+        out[limbs - 1] &= mask;
+        size_t i = limbs;
+        while (i > 0 && out[i - 1] == bound[i - 1]) {
+            --i;
+        }
+        if (i > 0 && out[i - 1] < bound[i - 1]) {
+            return;
+        }
+    }
+}
+
+void ChaCha20Rng::uniform(BigInt& out, const BigInt& bound) {
+    checkBound(bound);
+    if (&out == &bound) {
+        BigInt copy(bound);
+        uniform(out, copy);
+        return;
+    }
+    size_t limbs = mpz_size(bound.get_mpz_t());
+    mp_limb_t* d = mpz_limbs_write(out.get_mpz_t(), limbs);
+    uniformLimbs(reinterpret_cast<uint64_t*>(d), reinterpret_cast<const uint64_t*>(mpz_limbs_read(bound.get_mpz_t())), limbs);
+    mpz_limbs_finish(out.get_mpz_t(), limbs);
+}
+
+BigInt ChaCha20Rng::uniform(const BigInt& bound) {
+    BigInt out;
+    uniform(out, bound);
+    return out;
+}
+
+void ChaCha20Rng::uniformNonZero(BigInt& out, const BigInt& bound) {
+    if (bound < BigInt(static_cast<unsigned long int>(2))) {
+        throw std::invalid_argument("Nonzero sampling bound must be at least 2.");
+    }
+    do {
+        uniform(out, bound);
+    } while (out.isZero());
+}
+
+void ChaCha20Rng::randomBits(BigInt& out, size_t bits) {
+    size_t limbs = (bits + 63) / 64;
+    if (limbs == 0) {
+        out = BigInt(static_cast<unsigned long int>(0));
+        return;
+    }
+    mp_limb_t* d = mpz_limbs_write(out.get_mpz_t(), limbs);
+    for (size_t i = 0; i < limbs; ++i) {
+        d[i] = nextU64();
+    }
+    if (bits % 64 != 0) {
+        d[limbs - 1] &= (static_cast<mp_limb_t>(1) << (bits % 64)) - 1;
+    }
+    mpz_limbs_finish(out.get_mpz_t(), limbs);
+}
+
+void sampleUniform(std::vector<BigInt>& out, size_t count, const BigInt& bound, ChaCha20Rng& rng, unsigned threads) {
+    checkBound(bound);
+    std::string key(ChaCha20Rng::KEY_SIZE, '\0');
+    rng.fill(reinterpret_cast<uint8_t*>(&key[0]), key.size());
+    out.resize(count);
+    size_t chunks = (count + SAMPLE_CHUNK - 1) / SAMPLE_CHUNK;
+    parallelFor(chunks, [&](size_t c) {
+        ChaCha20Rng local(key, c);
+        size_t end = std::min(count, (c + 1) * SAMPLE_CHUNK);
+        for (size_t i = c * SAMPLE_CHUNK; i < end; ++i) {
+            local.uniform(out[i], bound);
+        }
+    }, threads);
+}
@@ -0,0 +1,349 @@
+#include "../include/bigint.hpp"
+#include "../include/io.hpp"
+#include "../include/parallel.hpp"
+#include "../include/serialization.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+const char VECTOR_MAGIC[8] = { 'S', 'N', 'K', 'F', 'E', 'V', '0', '1' };
+const char POLYNOMIAL_MAGIC[8] = { 'S', 'N', 'K', 'P', 'O', 'L', '0', '1' };
+const char POINTS_MAGIC[8] = { 'S', 'N', 'K', 'P', 'T', 'S', '0', '1' };
+const size_t HEADER_SIZE = 24;
+const uint32_t FLAG_SPARSE = 1;
+const uint32_t FLAG_INFINITY = 2;    // Point files: an infinity bitmap follows the records.
+const size_t EXPONENT_BYTES = 8;
+const size_t CHUNK_RECORDS = 1024;   // Records per encode or decode task.
+const size_t BLOCK_RECORDS = 65536;  // Records encoded before each write.
+
+// How a file's records are laid out: an optional 64-bit exponent, then some field elements.
+struct RecordLayout {
+    size_t width;
+    bool exponent;
+    size_t fields;
+
+    size_t size() const { return (exponent ? EXPONENT_BYTES : 0) + fields * width; }
+};
+
+size_t elementWidth(const BigInt& modulus) {
+    return (modulus.bitSize() + 63) / 64 * 8;
+}
+
+// Writes a value in [0, 2^(8·width)) as width little-endian bytes, in 64-bit words, least significant first.
+void storeElement(unsigned char* out, const BigInt& v, size_t width) {
+    std::memset(out, 0, width);
+    mpz_export(out, nullptr, -1, 8, -1, 0, v.get_mpz_t());
+}
+
+void storeReduced(unsigned char* out, const BigInt& v, const BigInt& p, size_t width) {
+    if (v.isNegative() || v >= p) {
+        storeElement(out, v % p, width);
+    } else {
+        storeElement(out, v, width);
+    }
+}
+
+void loadElement(BigInt& v, const unsigned char* in, size_t width) {
+    mpz_import(v.get_mpz_t(), width / 8, -1, 8, -1, 0, in);
+}
+
+// Writes a new or truncated file front to back.
+class OutputFile {
+public:
+    explicit OutputFile(const std::string& path) : handle(path, O_WRONLY | O_CREAT | O_TRUNC, "field element file"), offset(0) {}
+
+    void write(const unsigned char* data, size_t size) {
+        writeAt(handle.get(), data, size, offset, "field element file");
+        offset += size;
+    }
+
+private:
+    FileHandle handle;
+    off_t offset;
+};
+
+// Checks that a mapped input can hold a header and prepares it for a front-to-back read.
+void prepareInput(const MappedFile& file, const std::string& path) {
+    if (file.size() < HEADER_SIZE) {
+        throw std::runtime_error("File " + path + " is not a field element file.");
+    }
+    file.adviseSequential();
+}
+
+typedef std::function<const BigInt&(size_t record, size_t field)> ElementSource;
+typedef std::function<uint64_t(size_t record)> ExponentSource;
+
+void writeRecords(const std::string& path, const char magic[8], uint32_t flags, const BigInt& modulus,
+                  const RecordLayout& layout, size_t count, const ElementSource& element,
+                  const ExponentSource& exponent, unsigned threads) {
+    OutputFile file(path);
+    std::vector<unsigned char> header(HEADER_SIZE + layout.width);
+    std::memcpy(&header[0], magic, 8);
+    storeLE(&header[8], layout.width, 4);
+    storeLE(&header[12], flags, 4);
+    storeLE(&header[16], count, 8);
+    storeElement(&header[HEADER_SIZE], modulus, layout.width);
+    file.write(header.data(), header.size());
+
+    const size_t recordSize = layout.size();
+    std::vector<unsigned char> buffer(std::min(count, BLOCK_RECORDS) * recordSize);
+    for (size_t begin = 0; begin < count; begin += BLOCK_RECORDS) {
+        size_t end = std::min(count, begin + BLOCK_RECORDS);
+        parallelFor((end - begin + CHUNK_RECORDS - 1) / CHUNK_RECORDS, [&](size_t chunk) {
+            size_t first = begin + chunk * CHUNK_RECORDS;
+            size_t last = std::min(end, first + CHUNK_RECORDS);
+            for (size_t i = first; i < last; ++i) {
+                unsigned char* out = &buffer[(i - begin) * recordSize];
+                if (layout.exponent) {
+                    storeLE(out, exponent(i), EXPONENT_BYTES);
+                    out += EXPONENT_BYTES;
+                }
+                for (size_t f = 0; f < layout.fields; ++f) {
+                    storeReduced(out + f * layout.width, element(i, f), modulus, layout.width);
+                }
+            }
+        }, threads);
+        file.write(buffer.data(), (end - begin) * recordSize);
+    }
+}
+
+typedef std::function<void(size_t record, uint64_t exponent)> ExponentSink;
+
+// Validates the header of a mapped file and returns its record count; fills in the modulus and width.
+size_t readHeader(const MappedFile& file, const char magic[8], uint32_t& flags, BigInt& modulus, RecordLayout& layout) {
+    const unsigned char* data = file.get();
+    if (std::memcmp(data, magic, 8) != 0) {
+        throw std::runtime_error("File has the wrong type or is not a field element file.");
+    }
+    layout.width = static_cast<size_t>(loadLE(data + 8, 4));
+    flags = static_cast<uint32_t>(loadLE(data + 12, 4));
+    uint64_t count = loadLE(data + 16, 8);
+    if (layout.width == 0 || layout.width % 8 != 0 || file.size() < HEADER_SIZE + layout.width) {
+        throw std::runtime_error("Field element file has a malformed header.");
+    }
+    loadElement(modulus, data + HEADER_SIZE, layout.width);
+    if (modulus.isZero() || elementWidth(modulus) != layout.width) {
+        throw std::runtime_error("Field element file has a malformed modulus.");
+    }
+    size_t trailer = (flags & FLAG_INFINITY) != 0 ? (count + 63) / 64 * 8 : 0;
+    if (file.size() < HEADER_SIZE + layout.width + trailer ||
+        (file.size() - HEADER_SIZE - layout.width - trailer) / layout.size() != count ||
+        (file.size() - HEADER_SIZE - layout.width - trailer) % layout.size() != 0) {
+        throw std::runtime_error("Field element file is truncated or has trailing data.");
+    }
+    return static_cast<size_t>(count);
+}
+
+void readRecords(const MappedFile& file, const BigInt& modulus, const RecordLayout& layout, size_t count,
+                 const std::function<BigInt&(size_t record, size_t field)>& element,
+                 const ExponentSink& exponent, unsigned threads) {
+    const unsigned char* records = file.get() + HEADER_SIZE + layout.width;
+    const size_t recordSize = layout.size();
+    std::atomic<bool> outOfRange(false);
+    parallelFor((count + CHUNK_RECORDS - 1) / CHUNK_RECORDS, [&](size_t chunk) {
+        size_t last = std::min(count, (chunk + 1) * CHUNK_RECORDS);
+        for (size_t i = chunk * CHUNK_RECORDS; i < last; ++i) {
+            const unsigned char* in = records + i * recordSize;
+            if (layout.exponent) {
+                exponent(i, loadLE(in, EXPONENT_BYTES));
+                in += EXPONENT_BYTES;
+            }
+            for (size_t f = 0; f < layout.fields; ++f) {
+                BigInt& v = element(i, f);
+                loadElement(v, in + f * layout.width, layout.width);
+                if (v >= modulus) {
+                    outOfRange = true;
+                }
+            }
+        }
+    }, threads);
+    if (outOfRange) {
+        throw std::runtime_error("Field element file holds a value that is not below the modulus.");
+    }
+}
+
+void checkModulus(const BigInt& modulus) {
+    if (modulus.isNegative() || modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be positive.");
+    }
+}
+
+} // namespace
+
+void writeFieldElements(const std::string& path, const std::vector<BigInt>& values, const BigInt& modulus,
+                        unsigned threads) {
+    checkModulus(modulus);
+    RecordLayout layout = { elementWidth(modulus), false, 1 };
+    writeRecords(path, VECTOR_MAGIC, 0, modulus, layout, values.size(),
+                 [&](size_t i, size_t) -> const BigInt& { return values[i]; }, ExponentSource(), threads);
+}
+
+std::vector<BigInt> readFieldElements(const std::string& path, BigInt& modulus, unsigned threads) {
+    MappedFile file(path, MappedFile::ReadOnly);
+    prepareInput(file, path);
+    uint32_t flags;
+    RecordLayout layout = { 0, false, 1 };
+    size_t count = readHeader(file, VECTOR_MAGIC, flags, modulus, layout);
+    std::vector<BigInt> values(count);
+    readRecords(file, modulus, layout, count, [&](size_t i, size_t) -> BigInt& { return values[i]; }, ExponentSink(),
+                threads);
+    return values;
+}
+
+void writePolynomial(const std::string& path, const Polynomial& poly, unsigned threads) {
+    const BigInt modulus = poly.getMod();
+    checkModulus(modulus);
+    if (poly.isSparse()) {
+        std::vector<SparseTerm> terms = poly.getTerms();
+        RecordLayout layout = { elementWidth(modulus), true, 1 };
+        writeRecords(path, POLYNOMIAL_MAGIC, FLAG_SPARSE, modulus, layout, terms.size(),
+                     [&](size_t i, size_t) -> const BigInt& { return terms[i].coeff; },
+                     [&](size_t i) { return static_cast<uint64_t>(terms[i].exponent); }, threads);
+        return;
+    }
+    const std::vector<BigInt>& coeffs = poly.getCoefficients();
+    RecordLayout layout = { elementWidth(modulus), false, 1 };
+    writeRecords(path, POLYNOMIAL_MAGIC, 0, modulus, layout, coeffs.size(),
+                 [&](size_t i, size_t) -> const BigInt& { return coeffs[i]; }, ExponentSource(), threads);
+}
+
+Polynomial readPolynomial(const std::string& path, unsigned threads) {
+    MappedFile file(path, MappedFile::ReadOnly);
+    prepareInput(file, path);
+    // The record layout depends on the flags, so they are read before the header is validated.
+    uint32_t flags = static_cast<uint32_t>(loadLE(file.get() + 12, 4));
+    BigInt modulus;
+    RecordLayout layout = { 0, (flags & FLAG_SPARSE) != 0, 1 };
+    size_t count = readHeader(file, POLYNOMIAL_MAGIC, flags, modulus, layout);
+    if (layout.exponent) {
+        std::vector<SparseTerm> terms(count);
+        readRecords(file, modulus, layout, count, [&](size_t i, size_t) -> BigInt& { return terms[i].coeff; },
+                    [&](size_t i, uint64_t exponent) { terms[i].exponent = static_cast<size_t>(exponent); }, threads);
+        return Polynomial::fromTerms(terms, modulus);
+    }
+    std::vector<BigInt> coeffs(count);
+    readRecords(file, modulus, layout, count, [&](size_t i, size_t) -> BigInt& { return coeffs[i]; }, ExponentSink(),
+                threads);
+    return Polynomial(coeffs, modulus);
+}
+
+void writePoints(const std::string& path, const std::vector<Data>& points, const BigInt& modulus, unsigned threads) {
+    checkModulus(modulus);
+    RecordLayout layout = { elementWidth(modulus), false, 2 };
+    writeRecords(path, POINTS_MAGIC, 0, modulus, layout, points.size(),
+                 [&](size_t i, size_t f) -> const BigInt& { return f == 0 ? points[i].x : points[i].y; },
+                 ExponentSource(), threads);
+}
+
+std::vector<Data> readPoints(const std::string& path, BigInt& modulus, unsigned threads) {
+    MappedFile file(path, MappedFile::ReadOnly);
+    prepareInput(file, path);
+    uint32_t flags;
+    RecordLayout layout = { 0, false, 2 };
+    size_t count = readHeader(file, POINTS_MAGIC, flags, modulus, layout);
+    if ((flags & FLAG_INFINITY) != 0) {
+        throw std::runtime_error("Point file holds points at infinity; read it with readPointVector().");
+    }
+    std::vector<Data> points(count);
+    readRecords(file, modulus, layout, count,
+                [&](size_t i, size_t f) -> BigInt& { return f == 0 ? points[i].x : points[i].y; }, ExponentSink(),
+                threads);
+    return points;
+}
+
+void writePointVector(const std::string& path, const PointView& points, unsigned threads) {
+    const BigInt& modulus = points.getCurve().p;
+    const size_t limbs = points.limbs();
+    const size_t count = points.size();
+    std::vector<uint64_t> bitmap((count + 63) / 64, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (points.isInfinity(i)) {
+            bitmap[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+        }
+    }
+    bool anyInfinity = std::find_if(bitmap.begin(), bitmap.end(), [](uint64_t word) { return word != 0; }) != bitmap.end();
+
+    OutputFile file(path);
+    std::vector<unsigned char> header(HEADER_SIZE + limbs * 8);
+    std::memcpy(&header[0], POINTS_MAGIC, 8);
+    storeLE(&header[8], limbs * 8, 4);
+    storeLE(&header[12], anyInfinity ? FLAG_INFINITY : 0, 4);
+    storeLE(&header[16], count, 8);
+    storeElement(&header[HEADER_SIZE], modulus, limbs * 8);
+    file.write(header.data(), header.size());
+
+    const size_t recordSize = 2 * limbs * 8;
+    std::vector<unsigned char> buffer(std::min(count, BLOCK_RECORDS) * recordSize);
+    for (size_t begin = 0; begin < count; begin += BLOCK_RECORDS) {
+        size_t end = std::min(count, begin + BLOCK_RECORDS);
+        parallelFor((end - begin + CHUNK_RECORDS - 1) / CHUNK_RECORDS, [&](size_t chunk) {
+            size_t first = begin + chunk * CHUNK_RECORDS;
+            size_t last = std::min(end, first + CHUNK_RECORDS);
+            for (size_t i = first; i < last; ++i) {
+                unsigned char* out = &buffer[(i - begin) * recordSize];
+                const uint64_t* x = points.xLimbs(i);
+                const uint64_t* y = points.yLimbs(i);
+                for (size_t l = 0; l < limbs; ++l) {
+                    storeLE(out + 8 * l, x[l], 8);
+                    storeLE(out + 8 * (limbs + l), y[l], 8);
+                }
+            }
+        }, threads);
+        file.write(buffer.data(), (end - begin) * recordSize);
+    }
+    if (anyInfinity) {
+        std::vector<unsigned char> encoded(bitmap.size() * 8);
+        for (size_t w = 0; w < bitmap.size(); ++w) {
+            storeLE(&encoded[8 * w], bitmap[w], 8);
+        }
+        file.write(encoded.data(), encoded.size());
+    }
+}
+
+PointVector readPointVector(const std::string& path, const CurveParameters& curve, unsigned threads) {
+    MappedFile file(path, MappedFile::ReadOnly);
+    prepareInput(file, path);
+    uint32_t flags;
+    BigInt modulus;
+    RecordLayout layout = { 0, false, 2 };
+    size_t count = readHeader(file, POINTS_MAGIC, flags, modulus, layout);
+    if (modulus != curve.p) {
+        throw std::runtime_error("Point file was written for a different field.");
+    }
+    PointVector points(curve);
+    points.resize(count);
+    const size_t limbs = points.limbs();
+    const unsigned char* records = file.get() + HEADER_SIZE + layout.width;
+    const unsigned char* bitmap = (flags & FLAG_INFINITY) != 0 ? records + count * layout.size() : nullptr;
+    const mp_limb_t* p = mpz_limbs_read(modulus.get_mpz_t());
+    std::atomic<bool> outOfRange(false);
+    // CHUNK_RECORDS is a multiple of 64, so no two chunks share a word of the infinity bitmap.
+    parallelFor((count + CHUNK_RECORDS - 1) / CHUNK_RECORDS, [&](size_t chunk) {
+        std::vector<uint64_t> x(limbs), y(limbs);
+        size_t last = std::min(count, (chunk + 1) * CHUNK_RECORDS);
+        for (size_t i = chunk * CHUNK_RECORDS; i < last; ++i) {
+            if (bitmap != nullptr && ((loadLE(bitmap + 8 * (i / 64), 8) >> (i % 64)) & 1) != 0) {
+                continue;
+            }
+            const unsigned char* in = records + i * layout.size();
+            for (size_t l = 0; l < limbs; ++l) {
+                x[l] = loadLE(in + 8 * l, 8);
+                y[l] = loadLE(in + 8 * (limbs + l), 8);
+            }
+            if (mpn_cmp(reinterpret_cast<const mp_limb_t*>(x.data()), p, limbs) >= 0 ||
+                mpn_cmp(reinterpret_cast<const mp_limb_t*>(y.data()), p, limbs) >= 0) {
+                outOfRange = true;
+            }
+            points.setAffineLimbs(i, x.data(), y.data());
+        }
+    }, threads);
+    if (outOfRange) {
+        throw std::runtime_error("Point file holds a coordinate that is not below the modulus.");
+    }
+    return points;
+}
@@ -0,0 +1,331 @@
+#include "../include/bigint.hpp"
+#include "../include/msm.hpp"
+#include "../include/random.hpp"
+#include "../include/sha256.hpp"
+#include "../include/signature.hpp"
+#include <stdexcept>
+
+namespace {
+
+size_t byteLength(const BigInt& v) {
+    return (v.bitSize() + 7) / 8;
+}
+
+// Fixed-width big-endian encoding of a non-negative integer.
+std::string toBytes(const BigInt& v, size_t length) {
+    std::string out(length, '\0');
+    size_t count = 0;
+    std::string raw((v.bitSize() + 7) / 8 + 1, '\0');
+    mpz_export(&raw[0], &count, 1, 1, 1, 0, v.get_mpz_t());
+    if (count > length) {
+        throw std::invalid_argument("Integer does not fit in the requested width.");
+    }
+    out.replace(length - count, count, raw.substr(0, count));
+    return out;
+}
+
+BigInt fromBytes(const std::string& bytes) {
+    BigInt result;
+    mpz_import(result.get_mpz_t(), bytes.size(), 1, 1, 1, 0, bytes.data());
+    return result;
+}
+
+// RFC 6979, section 2.3.2: keep the leftmost qlen bits of a hash.
+BigInt bits2int(const std::string& bytes, const BigInt& n) {
+    BigInt v = fromBytes(bytes);
+    size_t qlen = n.bitSize();
+    if (bytes.size() * 8 > qlen) {
+        v = v.rightShift(bytes.size() * 8 - qlen);
+    }
+    return v;
+}
+
+// RFC 6979, section 3.2, with optional additional data k' (section 3.6) for domain separation.
+BigInt deterministicNonce(const BigInt& n, const BigInt& privateKey, const std::string& digest, const std::string& extra) {
+    size_t rlen = byteLength(n);
+    std::string x = toBytes(privateKey, rlen);
+    std::string h1 = toBytes(bits2int(digest, n) % n, rlen);
+
+    std::string V(32, '\x01');
+    std::string K(32, '\0');
+    K = hmacSha256(K, V + std::string(1, '\0') + x + h1 + extra);
+    V = hmacSha256(K, V);
+    K = hmacSha256(K, V + std::string(1, '\x01') + x + h1 + extra);
+    V = hmacSha256(K, V);
+
+    while (true) {
+        std::string T;
+        while (T.size() < rlen) {
+            V = hmacSha256(K, V);
+            T += V;
+        }
+        BigInt k = bits2int(T.substr(0, rlen), n);
+        if (!k.isZero() && k < n) {
+            return k;
+        }
+        K = hmacSha256(K, V + std::string(1, '\0'));
+        V = hmacSha256(K, V);
+    }
+}
+
+Ecc_Point generator(const CurveParameters& curve) {
+    return Ecc_Point(curve.Gx, curve.Gy, curve);
+}
+
+bool inScalarRange(const BigInt& v, const BigInt& n) {
+    return !v.isZero() && !v.isNegative() && v < n;
+}
+
+bool sameCurve(const CurveParameters& first, const CurveParameters& second) {
+    return first.p == second.p && first.a == second.a && first.b == second.b && first.n == second.n &&
+           first.Gx == second.Gx && first.Gy == second.Gy;
+}
+
+// A finite point of the given curve with reduced coordinates satisfying y² = x³ + ax + b. The
+// group law does not check this, and an off-curve point would be multiplied in a weaker group.
+bool onCurve(const Ecc_Point& point, const CurveParameters& curve) {
+    if (point.isInfinity || !sameCurve(point.getCurveParameters(), curve)) {
+        return false;
+    }
+    const BigInt& x = point.getX();
+    const BigInt& y = point.getY();
+    if (x.isNegative() || y.isNegative() || x >= curve.p || y >= curve.p) {
+        return false;
+    }
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(curve.p);
+    BigInt rhs = field->add(field->mul(field->sqr(x), x), field->add(field->mul(curve.a, x), curve.b));
+    return field->sqr(y) == rhs;
+}
+
+std::string encodePoint(const Ecc_Point& point) {
+    size_t length = byteLength(point.getP());
+    return toBytes(point.getX(), length) + toBytes(point.getY(), length);
+}
+
+BigInt schnorrChallenge(const Ecc_Point& R, const Ecc_Point& publicKey, const std::string& message, const BigInt& n) {
+    return bits2int(Sha256::digest(encodePoint(R) + encodePoint(publicKey) + message), n) % n;
+}
+
+// Random 128-bit weights; the first one is fixed to 1 since only relative weights matter.
+std::vector<BigInt> batchWeights(size_t count) {
+    ChaCha20Rng rng = ChaCha20Rng::fromEntropy();
+    std::vector<BigInt> weights(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            weights[i] = BigInt(static_cast<unsigned long int>(1));
+            continue;
+        }
+        rng.randomBits(weights[i], 128);
+    }
+    return weights;
+}
+
+void checkBatchSizes(size_t keys, size_t messages, size_t signatures) {
+    if (keys != messages || keys != signatures) {
+        throw std::invalid_argument("Number of public keys, messages and signatures must be the same.");
+    }
+}
+
+bool ecdsaBatchRange(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                     const std::vector<EcdsaSignature>& signatures, size_t begin, size_t end) {
+    if (begin == end) {
+        return true;
+    }
+    const CurveParameters& curve = publicKeys[begin].getCurveParameters();
+    const BigInt& n = curve.n;
+    std::vector<BigInt> weights = batchWeights(end - begin);
+
+    std::vector<Ecc_Point> points(1, generator(curve));
+    std::vector<BigInt> scalars(1, BigInt(static_cast<unsigned long int>(0)));
+    for (size_t i = begin; i < end; ++i) {
+        const EcdsaSignature& sig = signatures[i];
+        Ecc_Point R;
+        if (!onCurve(publicKeys[i], curve) || !inScalarRange(sig.r, n) || !inScalarRange(sig.s, n) ||
+            !ecdsaRecoverR(curve, sig, R)) {
+            return false;
+        }
+        const BigInt& w = weights[i - begin];
+        BigInt z = bits2int(Sha256::digest(messages[i]), n);
+        BigInt sInv = sig.s.modInverse(n);
+        scalars[0] = (scalars[0] + w * z * sInv) % n;
+        points.push_back(publicKeys[i]);
+        scalars.push_back((w * sig.r * sInv) % n);
+        points.push_back(R);
+        scalars.push_back(n - w);
+    }
+    return multiScalarMul(points, scalars).isInfinity;
+}
+
+bool schnorrBatchRange(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                       const std::vector<SchnorrSignature>& signatures, size_t begin, size_t end) {
+    if (begin == end) {
+        return true;
+    }
+    const CurveParameters& curve = publicKeys[begin].getCurveParameters();
+    const BigInt& n = curve.n;
+    std::vector<BigInt> weights = batchWeights(end - begin);
+
+    std::vector<Ecc_Point> points(1, generator(curve));
+    std::vector<BigInt> scalars(1, BigInt(static_cast<unsigned long int>(0)));
+    for (size_t i = begin; i < end; ++i) {
+        const SchnorrSignature& sig = signatures[i];
+        if (!onCurve(publicKeys[i], curve) || !onCurve(sig.R, curve) || sig.s.isNegative() || sig.s >= n) {
+            return false;
+        }
+        const BigInt& w = weights[i - begin];
+        BigInt e = schnorrChallenge(sig.R, publicKeys[i], messages[i], n);
+        scalars[0] = (scalars[0] + w * sig.s) % n;
+        points.push_back(sig.R);
+        scalars.push_back(n - w);
+        points.push_back(publicKeys[i]);
+        scalars.push_back(n - (w * e) % n);
+    }
+    return multiScalarMul(points, scalars).isInfinity;
+}
+
+// Bisects failing ranges until the invalid signatures are isolated.
+template <typename Signature, typename BatchCheck, typename SingleCheck>
+void identifyFailures(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                      const std::vector<Signature>& signatures, size_t begin, size_t end,
+                      BatchCheck batch, SingleCheck single, std::vector<bool>& valid) {
+    if (end - begin == 1) {
+        valid[begin] = single(publicKeys[begin], messages[begin], signatures[begin]);
+        return;
+    }
+    if (batch(publicKeys, messages, signatures, begin, end)) {
+        for (size_t i = begin; i < end; ++i) {
+            valid[i] = true;
+        }
+        return;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    identifyFailures(publicKeys, messages, signatures, begin, middle, batch, single, valid);
+    identifyFailures(publicKeys, messages, signatures, middle, end, batch, single, valid);
+}
+
+} // namespace
+
+Ecc_Point derivePublicKey(const CurveParameters& curve, const BigInt& privateKey) {
+    if (!inScalarRange(privateKey, curve.n)) {
+        throw std::invalid_argument("Private key must be in the range [1, n).");
+    }
+    return generator(curve) * privateKey;
+}
+
+EcdsaSignature ecdsaSign(const CurveParameters& curve, const BigInt& privateKey, const std::string& message) {
+    if (!inScalarRange(privateKey, curve.n)) {
+        throw std::invalid_argument("Private key must be in the range [1, n).");
+    }
+    const BigInt& n = curve.n;
+    std::string digest = Sha256::digest(message);
+    BigInt z = bits2int(digest, n);
+    std::string extra;
+
+    while (true) {
+        BigInt k = deterministicNonce(n, privateKey, digest, extra);
+        Ecc_Point R = generator(curve) * k;
+        EcdsaSignature sig;
+        sig.r = R.getX() % n;
+        sig.s = (k.modInverse(n) * (z + sig.r * privateKey)) % n;
+        if (!sig.r.isZero() && !sig.s.isZero()) {
+            sig.recoveryId = (mpz_odd_p(R.getY().get_mpz_t()) ? 1 : 0) | (R.getX() >= n ? 2 : 0);
+            return sig;
+        }
+        extra += '\0';
+    }
+}
+
+bool ecdsaVerify(const Ecc_Point& publicKey, const std::string& message, const EcdsaSignature& signature) {
+    const CurveParameters& curve = publicKey.getCurveParameters();
+    if (!onCurve(publicKey, curve)) {
+        return false;
+    }
+    const BigInt& n = curve.n;
+    if (!inScalarRange(signature.r, n) || !inScalarRange(signature.s, n)) {
+        return false;
+    }
+    BigInt z = bits2int(Sha256::digest(message), n);
+    BigInt sInv = signature.s.modInverse(n);
+    std::vector<Ecc_Point> points = { generator(curve), publicKey };
+    std::vector<BigInt> scalars = { (z * sInv) % n, (signature.r * sInv) % n };
+    Ecc_Point R = multiScalarMul(points, scalars);
+    return !R.isInfinity && R.getX() % n == signature.r;
+}
+
+bool ecdsaRecoverR(const CurveParameters& curve, const EcdsaSignature& signature, Ecc_Point& R) {
+    BigInt x = signature.r;
+    if (signature.recoveryId & 2) {
+        x += curve.n;
+    }
+    if (x >= curve.p) {
+        return false;
+    }
+    std::shared_ptr<const FieldBackend> field = FieldBackend::forModulus(curve.p);
+    BigInt rhs = field->add(field->mul(field->sqr(x), x), field->mul(curve.a, x) + curve.b);
+    BigInt y;
+    if (!field->sqrt(rhs, y)) {
+        return false;
+    }
+    bool odd = mpz_odd_p(y.get_mpz_t()) != 0;
+    if (odd != ((signature.recoveryId & 1) != 0)) {
+        y = field->sub(BigInt(static_cast<unsigned long int>(0)), y);
+    }
+    R = Ecc_Point(x, y, curve);
+    return true;
+}
+
+bool ecdsaBatchVerify(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                      const std::vector<EcdsaSignature>& signatures) {
+    checkBatchSizes(publicKeys.size(), messages.size(), signatures.size());
+    return ecdsaBatchRange(publicKeys, messages, signatures, 0, publicKeys.size());
+}
+
+std::vector<bool> ecdsaBatchVerifyEach(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                                       const std::vector<EcdsaSignature>& signatures) {
+    checkBatchSizes(publicKeys.size(), messages.size(), signatures.size());
+    std::vector<bool> valid(publicKeys.size(), false);
+    if (!publicKeys.empty()) {
+        identifyFailures(publicKeys, messages, signatures, 0, publicKeys.size(), ecdsaBatchRange, ecdsaVerify, valid);
+    }
+    return valid;
+}
+
+SchnorrSignature schnorrSign(const CurveParameters& curve, const BigInt& privateKey, const std::string& message) {
+    Ecc_Point publicKey = derivePublicKey(curve, privateKey);
+    const BigInt& n = curve.n;
+    BigInt k = deterministicNonce(n, privateKey, Sha256::digest(message), "schnorr");
+
+    SchnorrSignature sig;
+    sig.R = generator(curve) * k;
+    BigInt e = schnorrChallenge(sig.R, publicKey, message, n);
+    sig.s = (k + e * privateKey) % n;
+    return sig;
+}
+
+bool schnorrVerify(const Ecc_Point& publicKey, const std::string& message, const SchnorrSignature& signature) {
+    const CurveParameters& curve = publicKey.getCurveParameters();
+    const BigInt& n = curve.n;
+    if (!onCurve(publicKey, curve) || !onCurve(signature.R, curve) || signature.s.isNegative() || signature.s >= n) {
+        return false;
+    }
+    BigInt e = schnorrChallenge(signature.R, publicKey, message, n);
+    std::vector<Ecc_Point> points = { generator(curve), publicKey };
+    std::vector<BigInt> scalars = { signature.s, n - e };
+    return multiScalarMul(points, scalars) == signature.R;
+}
+
+bool schnorrBatchVerify(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                        const std::vector<SchnorrSignature>& signatures) {
+    checkBatchSizes(publicKeys.size(), messages.size(), signatures.size());
+    return schnorrBatchRange(publicKeys, messages, signatures, 0, publicKeys.size());
+}
+
+std::vector<bool> schnorrBatchVerifyEach(const std::vector<Ecc_Point>& publicKeys, const std::vector<std::string>& messages,
+                                         const std::vector<SchnorrSignature>& signatures) {
+    checkBatchSizes(publicKeys.size(), messages.size(), signatures.size());
+    std::vector<bool> valid(publicKeys.size(), false);
+    if (!publicKeys.empty()) {
+        identifyFailures(publicKeys, messages, signatures, 0, publicKeys.size(), schnorrBatchRange, schnorrVerify, valid);
+    }
+    return valid;
+}
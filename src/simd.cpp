@@ -0,0 +1,423 @@
+#include "../include/bigint.hpp"
+#include "../include/simd.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+
+const size_t IFMA_LANES = 8;
+const size_t AVX2_LANES = 4;
+
+// Reads bits [bit, bit + width) of a four-limb element.
+inline uint64_t extractBits(const uint64_t* e, unsigned bit, unsigned width) {
+    unsigned w = bit / 64;
+    unsigned s = bit % 64;
+    if (w >= SimdField::LIMBS) {
+        return 0;
+    }
+    uint64_t v = e[w] >> s;
+    if (s + width > 64 && w + 1 < SimdField::LIMBS) {
+        v |= e[w + 1] << (64 - s);
+    }
+    return width == 64 ? v : v & ((static_cast<uint64_t>(1) << width) - 1);
+}
+
+// ORs a width-bit value into bits [bit, bit + width) of a four-limb element.
+inline void depositBits(uint64_t* e, unsigned bit, unsigned width, uint64_t v) {
+    unsigned w = bit / 64;
+    unsigned s = bit % 64;
+    if (w >= SimdField::LIMBS) {
+        return;
+    }
+    e[w] |= v << s;
+    if (s + width > 64 && w + 1 < SimdField::LIMBS) {
+        e[w + 1] |= v >> (64 - s);
+    }
+}
+
+SimdField::Montgomery montgomeryConstants(const BigInt& p, unsigned radixBits, size_t limbs) {
+    SimdField::Montgomery m;
+    m.radixBits = radixBits;
+    m.limbs = limbs;
+
+    BigInt radix, inverse, r2;
+    mpz_setbit(radix.get_mpz_t(), radixBits);
+    mpz_invert(inverse.get_mpz_t(), p.get_mpz_t(), radix.get_mpz_t());
+    mpz_sub(inverse.get_mpz_t(), radix.get_mpz_t(), inverse.get_mpz_t());
+    m.pInv = mpz_get_ui(inverse.get_mpz_t());
+
+    mpz_setbit(r2.get_mpz_t(), 2 * radixBits * limbs);
+    mpz_mod(r2.get_mpz_t(), r2.get_mpz_t(), p.get_mpz_t());
+
+    uint64_t pLimbs[SimdField::LIMBS], r2Limbs[SimdField::LIMBS];
+    for (size_t i = 0; i < SimdField::LIMBS; ++i) {
+        pLimbs[i] = mpz_getlimbn(p.get_mpz_t(), i);
+        r2Limbs[i] = mpz_getlimbn(r2.get_mpz_t(), i);
+    }
+    for (size_t i = 0; i < limbs; ++i) {
+        m.p[i] = extractBits(pLimbs, i * radixBits, radixBits);
+        m.r2[i] = extractBits(r2Limbs, i * radixBits, radixBits);
+    }
+    return m;
+}
+
+// The kernels rely on full unrolling (GCC does not unroll at -O2) to keep accumulators in registers.
+
+// Scalar CIOS Montgomery multiplication with R = 2^256: out = a * b / R mod p.
+void montMulScalar(const SimdField::Montgomery& m, uint64_t* out, const uint64_t* a, const uint64_t* b) {
+    uint64_t t[6] = { 0, 0, 0, 0, 0, 0 };
+    #pragma GCC unroll 10
+    for (size_t i = 0; i < 4; ++i) {
+        uint128_t c = 0;
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 4; ++j) {
+            c += static_cast<uint128_t>(a[j]) * b[i] + t[j];
+            t[j] = static_cast<uint64_t>(c);
+            c >>= 64;
+        }
+        c += t[4];
+        t[4] = static_cast<uint64_t>(c);
+        t[5] = static_cast<uint64_t>(c >> 64);
+
+        uint64_t q = t[0] * m.pInv;
+        c = static_cast<uint128_t>(q) * m.p[0] + t[0];
+        c >>= 64;
+        #pragma GCC unroll 10
+        for (size_t j = 1; j < 4; ++j) {
+            c += static_cast<uint128_t>(q) * m.p[j] + t[j];
+            t[j - 1] = static_cast<uint64_t>(c);
+            c >>= 64;
+        }
+        c += t[4];
+        t[3] = static_cast<uint64_t>(c);
+        t[4] = t[5] + static_cast<uint64_t>(c >> 64);
+    }
+
+    uint64_t d[4];
+    uint128_t borrow = 0;
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 4; ++j) {
+        uint128_t diff = static_cast<uint128_t>(t[j]) - m.p[j] - borrow;
+        d[j] = static_cast<uint64_t>(diff);
+        borrow = (diff >> 64) & 1;
+    }
+    bool keep = t[4] == 0 && borrow != 0;
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 4; ++j) {
+        out[j] = keep ? t[j] : d[j];
+    }
+}
+
+#ifdef SIMD_X86
+
+// Eight lanes of radix-2^52 Montgomery multiplication. Operands are limb-major: x[limb * 8 + lane].
+__attribute__((target("avx512f,avx512ifma")))
+void montMulIfma(const SimdField::Montgomery& m, uint64_t* out, const uint64_t* a, const uint64_t* b) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i mask = _mm512_set1_epi64((static_cast<uint64_t>(1) << 52) - 1);
+    const __m512i pInv = _mm512_set1_epi64(m.pInv);
+    __m512i A[5], B[5], N[5], T[6];
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 5; ++j) {
+        A[j] = _mm512_loadu_si512(a + j * IFMA_LANES);
+        B[j] = _mm512_loadu_si512(b + j * IFMA_LANES);
+        N[j] = _mm512_set1_epi64(m.p[j]);
+        T[j] = zero;
+    }
+    T[5] = zero;
+
+    #pragma GCC unroll 10
+    for (size_t i = 0; i < 5; ++i) {
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 5; ++j) {
+            T[j] = _mm512_madd52lo_epu64(T[j], A[i], B[j]);
+            T[j + 1] = _mm512_madd52hi_epu64(T[j + 1], A[i], B[j]);
+        }
+        // Only the low 52 bits of T[0] enter the product, which is exactly q = T[0] * pInv mod 2^52.
+        __m512i q = _mm512_madd52lo_epu64(zero, T[0], pInv);
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 5; ++j) {
+            T[j] = _mm512_madd52lo_epu64(T[j], q, N[j]);
+            T[j + 1] = _mm512_madd52hi_epu64(T[j + 1], q, N[j]);
+        }
+        T[1] = _mm512_add_epi64(T[1], _mm512_srli_epi64(T[0], 52));
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 5; ++j) {
+            T[j] = T[j + 1];
+        }
+        T[5] = zero;
+    }
+
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 4; ++j) {
+        T[j + 1] = _mm512_add_epi64(T[j + 1], _mm512_srli_epi64(T[j], 52));
+        T[j] = _mm512_and_si512(T[j], mask);
+    }
+    __m512i D[5];
+    __m512i borrow = zero;
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 5; ++j) {
+        __m512i d = _mm512_add_epi64(_mm512_sub_epi64(T[j], N[j]), borrow);
+        borrow = _mm512_srai_epi64(d, 52);
+        D[j] = _mm512_and_si512(d, mask);
+    }
+    __mmask8 keep = _mm512_cmplt_epi64_mask(borrow, zero);
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 5; ++j) {
+        _mm512_storeu_si512(out + j * IFMA_LANES, _mm512_mask_blend_epi64(keep, D[j], T[j]));
+    }
+}
+
+// Four lanes of radix-2^28 Montgomery multiplication. Operands are limb-major: x[limb * 4 + lane].
+__attribute__((target("avx2")))
+void montMulAvx2(const SimdField::Montgomery& m, uint64_t* out, const uint64_t* a, const uint64_t* b) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask = _mm256_set1_epi64x((static_cast<uint64_t>(1) << 28) - 1);
+    const __m256i pInv = _mm256_set1_epi64x(m.pInv);
+    __m256i A[10], B[10], N[10], T[10];
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 10; ++j) {
+        A[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j * AVX2_LANES));
+        B[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j * AVX2_LANES));
+        N[j] = _mm256_set1_epi64x(m.p[j]);
+        T[j] = zero;
+    }
+
+    // Full 56-bit products fit a lane, so each accumulator absorbs at most 20 of them without carrying.
+    #pragma GCC unroll 10
+    for (size_t i = 0; i < 10; ++i) {
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 10; ++j) {
+            T[j] = _mm256_add_epi64(T[j], _mm256_mul_epu32(A[i], B[j]));
+        }
+        __m256i q = _mm256_and_si256(_mm256_mul_epu32(T[0], pInv), mask);
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 10; ++j) {
+            T[j] = _mm256_add_epi64(T[j], _mm256_mul_epu32(q, N[j]));
+        }
+        __m256i carry = _mm256_srli_epi64(T[0], 28);
+        #pragma GCC unroll 10
+        for (size_t j = 0; j < 9; ++j) {
+            T[j] = T[j + 1];
+        }
+        T[0] = _mm256_add_epi64(T[0], carry);
+        T[9] = zero;
+    }
+
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 9; ++j) {
+        T[j + 1] = _mm256_add_epi64(T[j + 1], _mm256_srli_epi64(T[j], 28));
+        T[j] = _mm256_and_si256(T[j], mask);
+    }
+    __m256i D[10];
+    __m256i borrow = zero;
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 10; ++j) {
+        __m256i d = _mm256_sub_epi64(_mm256_sub_epi64(T[j], N[j]), borrow);
+        borrow = _mm256_srli_epi64(d, 63);
+        D[j] = _mm256_and_si256(d, mask);
+    }
+    __m256i keep = _mm256_cmpeq_epi64(borrow, _mm256_set1_epi64x(1));
+    #pragma GCC unroll 10
+    for (size_t j = 0; j < 10; ++j) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j * AVX2_LANES), _mm256_blendv_epi8(D[j], T[j], keep));
+    }
+}
+
+#endif // SIMD_X86
+
+typedef void (*MontKernel)(const SimdField::Montgomery&, uint64_t*, const uint64_t*, const uint64_t*);
+
+// Runs a lane kernel over blocks: transpose to limb-major radix form, multiply by b and then by R²,
+// and transpose back. The final block is padded with zeros.
+template <MontKernel Kernel, size_t Lanes, unsigned Radix, size_t Limbs>
+void mulLanes(const SimdField::Montgomery& m, uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) {
+    alignas(64) uint64_t A[Limbs * Lanes], B[Limbs * Lanes], T[Limbs * Lanes], R2[Limbs * Lanes];
+    for (size_t j = 0; j < Limbs; ++j) {
+        std::fill(R2 + j * Lanes, R2 + (j + 1) * Lanes, m.r2[j]);
+    }
+    for (size_t base = 0; base < count; base += Lanes) {
+        size_t n = std::min(Lanes, count - base);
+        if (n < Lanes) {
+            std::fill(A, A + Limbs * Lanes, 0);
+            std::fill(B, B + Limbs * Lanes, 0);
+        }
+        for (size_t lane = 0; lane < n; ++lane) {
+            const uint64_t* ea = a + (base + lane) * SimdField::LIMBS;
+            const uint64_t* eb = b + (base + lane) * SimdField::LIMBS;
+#pragma GCC unroll 10
+            for (size_t j = 0; j < Limbs; ++j) {
+                A[j * Lanes + lane] = extractBits(ea, j * Radix, Radix);
+                B[j * Lanes + lane] = extractBits(eb, j * Radix, Radix);
+            }
+        }
+        Kernel(m, T, A, B);
+        Kernel(m, A, T, R2);
+        for (size_t lane = 0; lane < n; ++lane) {
+            uint64_t* e = out + (base + lane) * SimdField::LIMBS;
+            std::fill(e, e + SimdField::LIMBS, 0);
+#pragma GCC unroll 10
+            for (size_t j = 0; j < Limbs; ++j) {
+                depositBits(e, j * Radix, Radix, A[j * Lanes + lane]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+SimdField::SimdField(const BigInt& modulus, SimdKernel kernel) : modulus(modulus) {
+    if (mpz_sgn(modulus.get_mpz_t()) <= 0 || mpz_even_p(modulus.get_mpz_t()) || modulus.bitSize() > 256) {
+        throw std::invalid_argument("SimdField requires an odd modulus of at most 256 bits.");
+    }
+    if (!kernelSupported(kernel)) {
+        throw std::runtime_error("Requested SIMD kernel is not supported on this CPU.");
+    }
+    if (kernel == SimdKernel::Auto) {
+        kernel = kernelSupported(SimdKernel::Avx512Ifma) ? SimdKernel::Avx512Ifma
+               : kernelSupported(SimdKernel::Avx2) ? SimdKernel::Avx2 : SimdKernel::Scalar;
+    }
+    active = kernel;
+    mont64 = montgomeryConstants(modulus, 64, 4);
+    mont52 = montgomeryConstants(modulus, 52, 5);
+    mont28 = montgomeryConstants(modulus, 28, 10);
+}
+
+bool SimdField::kernelSupported(SimdKernel kernel) {
+    switch (kernel) {
+        case SimdKernel::Auto:
+        case SimdKernel::Scalar:
+            return true;
+#ifdef SIMD_X86
+        case SimdKernel::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        case SimdKernel::Avx512Ifma:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* SimdField::kernelName() const {
+    switch (active) {
+        case SimdKernel::Avx512Ifma: return "avx512-ifma";
+        case SimdKernel::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+void SimdField::mulBlocks(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const {
+#ifdef SIMD_X86
+    if (active == SimdKernel::Avx512Ifma) {
+        mulLanes<montMulIfma, IFMA_LANES, 52, 5>(mont52, out, a, b, count);
+        return;
+    }
+    if (active == SimdKernel::Avx2) {
+        mulLanes<montMulAvx2, AVX2_LANES, 28, 10>(mont28, out, a, b, count);
+        return;
+    }
+#endif
+    uint64_t t[LIMBS];
+    for (size_t i = 0; i < count; ++i) {
+        montMulScalar(mont64, t, a + i * LIMBS, b + i * LIMBS);
+        montMulScalar(mont64, out + i * LIMBS, t, mont64.r2);
+    }
+}
+
+void SimdField::mulVec(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const {
+    mulBlocks(out, a, b, count);
+}
+
+void SimdField::sqrVec(uint64_t* out, const uint64_t* a, size_t count) const {
+    mulBlocks(out, a, a, count);
+}
+
+void SimdField::addVec(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t count) const {
+    // Addition is memory bound; a branch-free carry chain keeps up with the loads.
+    const uint64_t* p = mont64.p;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t* x = a + i * LIMBS;
+        const uint64_t* y = b + i * LIMBS;
+        uint64_t s[LIMBS], d[LIMBS];
+        uint128_t carry = 0;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            carry += static_cast<uint128_t>(x[j]) + y[j];
+            s[j] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        uint128_t borrow = 0;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            uint128_t diff = static_cast<uint128_t>(s[j]) - p[j] - borrow;
+            d[j] = static_cast<uint64_t>(diff);
+            borrow = (diff >> 64) & 1;
+        }
+        bool keep = carry == 0 && borrow != 0;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            out[i * LIMBS + j] = keep ? s[j] : d[j];
+        }
+    }
+}
+
+void SimdField::load(uint64_t* out, const std::vector<BigInt>& values) const {
+    BigInt reduced;
+    for (size_t i = 0; i < values.size(); ++i) {
+        mpz_srcptr v = values[i].get_mpz_t();
+        if (mpz_sgn(v) < 0 || mpz_cmp(v, modulus.get_mpz_t()) >= 0) {
+            mpz_mod(reduced.get_mpz_t(), v, modulus.get_mpz_t());
+            v = reduced.get_mpz_t();
+        }
+        for (size_t j = 0; j < LIMBS; ++j) {
+            out[i * LIMBS + j] = mpz_getlimbn(v, j);
+        }
+    }
+}
+
+void SimdField::store(std::vector<BigInt>& out, const uint64_t* in, size_t count) {
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        mp_limb_t* limbs = mpz_limbs_write(out[i].get_mpz_t(), LIMBS);
+        for (size_t j = 0; j < LIMBS; ++j) {
+            limbs[j] = in[i * LIMBS + j];
+        }
+        mpz_limbs_finish(out[i].get_mpz_t(), LIMBS);
+    }
+}
+
+void SimdField::mulVec(std::vector<BigInt>& out, const std::vector<BigInt>& a, const std::vector<BigInt>& b) const {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("Operand vectors must have the same length.");
+    }
+    std::vector<uint64_t> x(a.size() * LIMBS), y(b.size() * LIMBS);
+    load(x.data(), a);
+    load(y.data(), b);
+    mulBlocks(x.data(), x.data(), y.data(), a.size());
+    store(out, x.data(), a.size());
+}
+
+void SimdField::sqrVec(std::vector<BigInt>& out, const std::vector<BigInt>& a) const {
+    std::vector<uint64_t> x(a.size() * LIMBS);
+    load(x.data(), a);
+    mulBlocks(x.data(), x.data(), x.data(), a.size());
+    store(out, x.data(), a.size());
+}
+
+void SimdField::addVec(std::vector<BigInt>& out, const std::vector<BigInt>& a, const std::vector<BigInt>& b) const {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("Operand vectors must have the same length.");
+    }
+    std::vector<uint64_t> x(a.size() * LIMBS), y(b.size() * LIMBS);
+    load(x.data(), a);
+    load(y.data(), b);
+    addVec(x.data(), x.data(), y.data(), a.size());
+    store(out, x.data(), a.size());
+}
@@ -0,0 +1,221 @@
+#include "../include/bigint.hpp"
+#include "../include/io.hpp"
+#include "../include/srs.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char SRS_MAGIC[8] = { 'S', 'N', 'K', 'S', 'R', 'S', '0', '1' };
+const size_t SRS_HEADER_SIZE = 32;
+const char* const SRS_FILE = "powers-of-tau file";
+
+// Extracts bits [bit, bit + width) of a non-negative integer.
+unsigned windowDigit(const BigInt& k, size_t bit, unsigned width) {
+    unsigned digit = 0;
+    for (unsigned i = 0; i < width; ++i) {
+        digit |= static_cast<unsigned>(mpz_tstbit(k.get_mpz_t(), bit + i)) << i;
+    }
+    return digit;
+}
+
+// Fixed-width little-endian encoding of a coordinate in [0, p), matching the header integers.
+void storeCoordinate(unsigned char* out, const BigInt& v, size_t width) {
+    size_t count = 0;
+    std::memset(out, 0, width);
+    std::vector<unsigned char> raw(width + 1);
+    mpz_export(raw.data(), &count, -1, 1, -1, 0, v.get_mpz_t());
+    std::memcpy(out, raw.data(), count);
+}
+
+BigInt loadCoordinate(const unsigned char* in, size_t width) {
+    BigInt result;
+    mpz_import(result.get_mpz_t(), width, -1, 1, -1, 0, in);
+    return result;
+}
+
+size_t coordinateWidth(const CurveParameters& curve) {
+    return (curve.p.bitSize() + 7) / 8;
+}
+
+void writeHeader(int fd, size_t width, uint64_t completed) {
+    unsigned char header[SRS_HEADER_SIZE] = { 0 };
+    std::memcpy(header, SRS_MAGIC, sizeof(SRS_MAGIC));
+    storeLE(header + 8, width, 4);
+    storeLE(header + 16, completed, 8);
+    writeAt(fd, header, SRS_HEADER_SIZE, 0, SRS_FILE);
+}
+
+// Reads the header and returns the number of fully stored powers.
+uint64_t readHeader(int fd, size_t width, off_t fileSize) {
+    unsigned char header[SRS_HEADER_SIZE];
+    readAt(fd, header, SRS_HEADER_SIZE, 0, SRS_FILE);
+    if (std::memcmp(header, SRS_MAGIC, sizeof(SRS_MAGIC)) != 0 || loadLE(header + 8, 4) != width) {
+        throw std::runtime_error("File is not a powers-of-tau file for this curve.");
+    }
+    uint64_t stored = (static_cast<uint64_t>(fileSize) - SRS_HEADER_SIZE) / (2 * width);
+    return std::min<uint64_t>(loadLE(header + 16, 8), stored);
+}
+
+Ecc_Point readPoint(int fd, size_t index, size_t width, const CurveParameters& curve) {
+    std::vector<unsigned char> buffer(2 * width);
+    readAt(fd, buffer.data(), buffer.size(), SRS_HEADER_SIZE + index * buffer.size(), SRS_FILE);
+    return Ecc_Point(loadCoordinate(buffer.data(), width), loadCoordinate(buffer.data() + width, width), curve);
+}
+
+} // namespace
+
+FixedBaseTable::FixedBaseTable(const Ecc_Point& base, unsigned windowBits)
+    : arithmetic(base), order(base.getCurveParameters().n), windowBits(windowBits) {
+    if (windowBits == 0 || windowBits > 16) {
+        throw std::invalid_argument("Window width must be between 1 and 16 bits.");
+    }
+    windows = (order.bitSize() + windowBits - 1) / windowBits;
+    size_t rowSize = (static_cast<size_t>(1) << windowBits) - 1;
+
+    // Each row is built by repeated mixed addition of its window base; all rows share one inversion.
+    std::vector<JacobianPoint> rows;
+    rows.reserve(windows * rowSize);
+    Ecc_Point windowBase = base;
+    for (size_t j = 0; j < windows; ++j) {
+        JacobianPoint acc = arithmetic.fromAffine(windowBase);
+        rows.push_back(acc);
+        for (size_t d = 2; d <= rowSize; ++d) {
+            acc = arithmetic.addMixed(acc, windowBase);
+            rows.push_back(acc);
+        }
+        windowBase = arithmetic.toAffine(arithmetic.addMixed(acc, windowBase));
+    }
+    table = arithmetic.toAffineBatch(rows);
+}
+
+JacobianPoint FixedBaseTable::multiplyJacobian(const BigInt& k) const {
+    BigInt scalar = k % order;
+    size_t rowSize = (static_cast<size_t>(1) << windowBits) - 1;
+    JacobianPoint result;
+    for (size_t j = 0; j < windows; ++j) {
+        unsigned digit = windowDigit(scalar, j * windowBits, windowBits);
+        if (digit != 0) {
+            result = arithmetic.addMixed(result, table[j * rowSize + digit - 1]);
+        }
+    }
+    return result;
+}
+
+Ecc_Point FixedBaseTable::multiply(const BigInt& k) const {
+    return arithmetic.toAffine(multiplyJacobian(k));
+}
+
+std::vector<Ecc_Point> FixedBaseTable::multiplyBatch(const std::vector<BigInt>& scalars, unsigned threads) const {
+    if (threads == 0) {
+        threads = defaultThreadCount();
+    }
+    std::vector<Ecc_Point> result(scalars.size());
+    size_t chunk = std::max<size_t>(1, (scalars.size() + threads - 1) / threads);
+    size_t chunks = (scalars.size() + chunk - 1) / chunk;
+    parallelFor(chunks, [&](size_t c) {
+        size_t begin = c * chunk;
+        size_t end = std::min(begin + chunk, scalars.size());
+        std::vector<JacobianPoint> points;
+        points.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            points.push_back(multiplyJacobian(scalars[i]));
+        }
+        std::vector<Ecc_Point> affine = arithmetic.toAffineBatch(points);
+        std::copy(affine.begin(), affine.end(), result.begin() + begin);
+    }, threads);
+    return result;
+}
+
+size_t generatePowersOfTau(const std::string& path, const CurveParameters& curve, const BigInt& tau, size_t count,
+                           size_t chunkSize, unsigned threads) {
+    BigInt t = tau % curve.n;
+    if (t.isZero()) {
+        throw std::invalid_argument("Tau must be nonzero modulo the curve order.");
+    }
+    if (chunkSize == 0) {
+        throw std::invalid_argument("Chunk size must be positive.");
+    }
+    const size_t width = coordinateWidth(curve);
+    const size_t pointSize = 2 * width;
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+
+    FileHandle file(path, O_RDWR | O_CREAT, SRS_FILE);
+    struct stat info;
+    if (fstat(file.get(), &info) != 0) {
+        throw std::runtime_error("Cannot stat powers-of-tau file " + path + ".");
+    }
+
+    size_t completed = 0;
+    if (static_cast<size_t>(info.st_size) >= SRS_HEADER_SIZE) {
+        completed = readHeader(file.get(), width, info.st_size);
+        bool matches = completed < 1 || readPoint(file.get(), 0, width, curve) == g;
+        matches = matches && (completed < 2 || readPoint(file.get(), 1, width, curve) == g * t);
+        if (!matches) {
+            throw std::invalid_argument("Existing powers-of-tau file was generated for a different curve or tau.");
+        }
+    }
+    writeHeader(file.get(), width, completed);
+    if (ftruncate(file.get(), SRS_HEADER_SIZE + completed * pointSize) != 0) {
+        throw std::runtime_error("Cannot truncate powers-of-tau file " + path + ".");
+    }
+    size_t skipped = completed;
+    if (completed >= count) {
+        return skipped;
+    }
+
+    FixedBaseTable table(g);
+    BigInt power;
+    mpz_powm_ui(power.get_mpz_t(), t.get_mpz_t(), completed, curve.n.get_mpz_t());
+    std::vector<unsigned char> buffer;
+    while (completed < count) {
+        size_t batch = std::min(chunkSize, count - completed);
+        std::vector<BigInt> scalars(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            scalars[i] = power;
+            power = (power * t) % curve.n;
+        }
+        std::vector<Ecc_Point> points = table.multiplyBatch(scalars, threads);
+
+        buffer.assign(batch * pointSize, 0);
+        for (size_t i = 0; i < batch; ++i) {
+            storeCoordinate(&buffer[i * pointSize], points[i].getX(), width);
+            storeCoordinate(&buffer[i * pointSize + width], points[i].getY(), width);
+        }
+        writeAt(file.get(), buffer.data(), buffer.size(), SRS_HEADER_SIZE + completed * pointSize, SRS_FILE);
+        if (fdatasync(file.get()) != 0) {
+            throw std::runtime_error("Cannot flush powers-of-tau file " + path + ".");
+        }
+        completed += batch;
+        writeHeader(file.get(), width, completed);
+        if (fdatasync(file.get()) != 0) {
+            throw std::runtime_error("Cannot flush powers-of-tau file " + path + ".");
+        }
+    }
+    return skipped;
+}
+
+std::vector<Ecc_Point> readPowersOfTau(const std::string& path, const CurveParameters& curve) {
+    const size_t width = coordinateWidth(curve);
+    FileHandle file(path, O_RDONLY, SRS_FILE);
+    struct stat info;
+    if (fstat(file.get(), &info) != 0 || static_cast<size_t>(info.st_size) < SRS_HEADER_SIZE) {
+        throw std::runtime_error("File is not a powers-of-tau file for this curve.");
+    }
+    size_t completed = readHeader(file.get(), width, info.st_size);
+
+    std::vector<unsigned char> buffer(completed * 2 * width);
+    readAt(file.get(), buffer.data(), buffer.size(), SRS_HEADER_SIZE, SRS_FILE);
+    std::vector<Ecc_Point> points;
+    points.reserve(completed);
+    for (size_t i = 0; i < completed; ++i) {
+        const unsigned char* entry = &buffer[i * 2 * width];
+        points.push_back(Ecc_Point(loadCoordinate(entry, width), loadCoordinate(entry + width, width), curve));
+    }
+    return points;
+}
@@ -1,52 +1,1395 @@
 #include <gmp.h>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "../include/allocation.hpp"
+#include "../include/bigint.hpp"
+#include "../include/circuit.hpp"
+#include "../include/cluster.hpp"
+#include "../include/ecc.hpp"
+#include "../include/evaluations.hpp"
+#include "../include/exponentiation.hpp"
+#include "../include/field.hpp"
+#include "../include/glv.hpp"
+#include "../include/hashtocurve.hpp"
+#include "../include/interpolation.hpp"
+#include "../include/msm.hpp"
+#include "../include/ntt.hpp"
+#include "../include/parallel.hpp"
+#include "../include/points.hpp"
+#include "../include/poseidon.hpp"
+#include "../include/signature.hpp"
+#include "../include/simd.hpp"
+#include "../include/kzg.hpp"
+#include "../include/polynomial.hpp"
+#include "../include/prover.hpp"
+#include "../include/random.hpp"
+#include "../include/serialization.hpp"
+#include "../include/srs.hpp"
 
-void E(mpz_t rop, const mpz_t exp) {
-    mpz_set_ui(rop, 1);
-    for (mpz_t i; mpz_cmp(i, exp) < 0; mpz_add_ui(i, i, 1)) {
-        mpz_mul_ui(rop, rop, 2);
+// A unique empty file under $TMPDIR (or /tmp), created with mkstemp and removed on scope exit, so
+// concurrent runs do not collide and failed runs leave nothing behind.
+class ScratchFile {
+public:
+    explicit ScratchFile(const char* stem) {
+        const char* dir = std::getenv("TMPDIR");
+        path = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") + "/" + stem + "-XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot create scratch file " + path + ".");
+        }
+        close(fd);
     }
-}
 
-void test_homomorphic_holding() {
-    mpz_t x, y, one, E_x, E_y, E_x_minus_y, E_one;
-    mpz_init(x);
-    mpz_init(y);
-    mpz_init(E_x);
-    mpz_init(E_y);
-    mpz_init(E_x_minus_y);
-    mpz_init(E_one);
-    mpz_init_set_ui(one, 1);
+    ~ScratchFile() {
+        std::remove(path.c_str());
+    }
+
+    const char* c_str() const { return path.c_str(); }
 
-    mpz_set_str(x, "12345678901234567890", 10);
-    mpz_set_str(y, "12345678901234567889", 10);
+private:
+    ScratchFile(const ScratchFile&);
+    ScratchFile& operator=(const ScratchFile&);
+
+    std::string path;
+};
+
+// E(x) = g^x mod p hides x while keeping the group structure: E(x)·E(y)⁻¹ = E(x − y).
+BigInt E(const BigInt& x) {
+    static const FixedBaseExp g(BigInt(static_cast<unsigned long int>(3)), CurveParameters::p256().p, 256);
+    return g.pow(x);
+}
 
-    std::cout << "x: " << mpz_get_str(nullptr, 10, x) << std::endl;
-    std::cout << "y: " << mpz_get_str(nullptr, 10, y) << std::endl;
+void test_homomorphic_holding() {
+    const BigInt& p = CurveParameters::p256().p;
+    BigInt x("12345678901234567890");
+    BigInt y("12345678901234567889");
+    BigInt one(static_cast<unsigned long int>(1));
 
-    E(E_x, x);
-    E(E_y, y);
+    std::cout << "x: " << x.toString() << std::endl;
+    std::cout << "y: " << y.toString() << std::endl;
 
-    mpz_div(E_x_minus_y, E_x, E_y);
-    E(E_one, one);
+    BigInt E_x = E(x);
+    BigInt E_y = E(y);
+    BigInt E_x_minus_y = (E_x * E_y.modInverse(p)) % p;
 
-    if (mpz_cmp(E_x_minus_y, E_one) == 0) {
+    if (E_x_minus_y == E(one)) {
         std::cout << "Proof accepted: E(x-y) equals E(1)" << std::endl;
     } else {
         std::cout << "Proof rejected: E(x-y) does not equal E(1)" << std::endl;
     }
-    std::cout << "Homomorphic Holding is working!!!" << std::endl;
 
-    mpz_clear(x);
-    mpz_clear(y);
-    mpz_clear(E_x);
-    mpz_clear(E_y);
-    mpz_clear(E_x_minus_y);
-    mpz_clear(E_one);
-    mpz_clear(one);
+    // The fixed-base tables, multi-exponentiation and powm must agree, including negative exponents.
+    BigInt g(static_cast<unsigned long int>(3));
+    BigInt h("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296", 16);
+    BigInt a("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5", 16);
+    BigInt b = p - x;
+    bool consistent = E_x == g.powm(x, p) && E(a) == g.powm(a, p) && E(a.leftShift(300)) == g.powm(a.leftShift(300), p);
+    consistent = consistent && multiExp({ g, h }, { a, b }, p) == (g.powm(a, p) * h.powm(b, p)) % p;
+    consistent = consistent && multiExp({ g, h, E_x }, { x - a, BigInt(static_cast<signed long int>(-7)), y }, p) ==
+                                   (g.powm(x - a, p) * h.powm(BigInt(static_cast<signed long int>(-7)), p) % p * E_x.powm(y, p)) % p;
+    std::vector<BigInt> bases, exponents;
+    BigInt product = one;
+    for (unsigned long int i = 0; i < 6; ++i) {
+        bases.push_back((h * BigInt(i + 2)) % p);
+        exponents.push_back(i == 4 ? BigInt(static_cast<signed long int>(-3)) : a.leftShift(i) + BigInt(i));
+        product = (product * bases[i].powm(exponents[i], p)) % p;
+    }
+    consistent = consistent && multiExp(bases, exponents, p) == product;
+    consistent = consistent && (E(BigInt(static_cast<signed long int>(-5))) * E(BigInt(static_cast<unsigned long int>(5)))) % p == one;
+    if (consistent) {
+        std::cout << "Homomorphic Holding is working!!!" << std::endl;
+    } else {
+        std::cout << "Homomorphic Holding Test FAILED" << std::endl;
+    }
+}
+
+void test_fast_reduction() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 26);
+
+    const BigInt* primes[] = { &CurveParameters::p256().p, &CurveParameters::secp256k1().p };
+    bool passed = true;
+    for (const BigInt* prime : primes) {
+        std::shared_ptr<const FieldBackend> fast = FieldBackend::forModulus(*prime);
+        FieldBackend generic(*prime);
+        for (int i = 0; i < 2000 && passed; ++i) {
+            BigInt x;
+            mpz_urandomb(x.get_mpz_t(), state, 1 + i % 512);
+            if (i % 3 == 0) {
+                x.negate();
+            }
+            BigInt expected = x;
+            generic.reduce(expected);
+            fast->reduce(x);
+            passed = (x == expected);
+        }
+        std::cout << fast->name() << " reduction " << (passed ? "PASSED" : "FAILED") << std::endl;
+    }
+    gmp_randclear(state);
+
+    Ecc_Point G(CurveParameters::p256().Gx, CurveParameters::p256().Gy);
+    Ecc_Point threeG = G * BigInt(static_cast<unsigned long int>(3));
+    bool curveCorrect = threeG.getX().toString(16) == "5ecbe4d1a6330a44c8f7ef951d4bf165e6c6b721efada985fb41661bc6e7fd6c" &&
+                        threeG.getY().toString(16) == "8734640c4998ff7e374b06ce1a64a2ecd82ab036384fb83d9a79b127a27d5032";
+    std::cout << "P-256 Scalar Multiplication Test " << (curveCorrect ? "PASSED" : "FAILED") << std::endl;
+
+    const CurveParameters& k1 = CurveParameters::secp256k1();
+    Ecc_Point H(k1.Gx, k1.Gy, k1);
+    Ecc_Point twoH = H * BigInt(static_cast<unsigned long int>(2));
+    bool k1Correct = twoH.getX().toString(16) == "c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5";
+    std::cout << "secp256k1 Scalar Multiplication Test " << (k1Correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+// Left-to-right double-and-add with affine additions only, independent of the GLV and wNAF code.
+Ecc_Point doubleAndAdd(const Ecc_Point& point, const BigInt& k) {
+    Ecc_Point acc;
+    for (size_t bit = k.bitSize(); bit-- > 0;) {
+        acc = acc + acc;
+        if (mpz_tstbit(k.get_mpz_t(), bit)) {
+            acc = acc + point;
+        }
+    }
+    return acc;
+}
+
+void test_glv_multiplication() {
+    const CurveParameters& k1 = CurveParameters::secp256k1();
+    const GLVEndomorphism* glv = GLVEndomorphism::forCurve(k1);
+    Ecc_Point G(k1.Gx, k1.Gy, k1);
+
+    // λ and β are the published secp256k1 endomorphism constants; λ·G is checked against plain
+    // double-and-add and against (β·x, y) computed by hand.
+    BigInt lambda("5363ad4cc05c30e0a5261c028812645a122e22ea20816678df02967c1b23bd72", 16);
+    BigInt beta("7ae96a2b657c07106e64479eac3434e99cf0497512f58995c1396c28719501ee", 16);
+    bool endomorphismCorrect = glv != nullptr && glv->getLambda() == lambda && glv->getBeta() == beta;
+    Ecc_Point lambdaG = doubleAndAdd(G, lambda);
+    endomorphismCorrect = endomorphismCorrect && lambdaG.getX() == beta * k1.Gx % k1.p && lambdaG.getY() == k1.Gy &&
+                          glv->apply(G) == lambdaG;
+    bool negationCorrect = G * (k1.n - BigInt(static_cast<unsigned long int>(1))) == -G;
+
+    // The decomposition recombines to k modulo n with halves of about half the bit length, and the
+    // GLV multiplication agrees with double-and-add.
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 27);
+    bool splitCorrect = true;
+    for (int i = 0; i < 8 && glv != nullptr; ++i) {
+        BigInt k;
+        mpz_urandomm(k.get_mpz_t(), state, k1.n.get_mpz_t());
+        GLVDecomposition d = glv->split(k);
+        BigInt a = d.k1Negative ? k1.n - d.k1 : d.k1;
+        BigInt b = d.k2Negative ? k1.n - d.k2 : d.k2;
+        splitCorrect = splitCorrect && (a + b * lambda) % k1.n == k && d.k1.bitSize() <= 129 && d.k2.bitSize() <= 129;
+        splitCorrect = splitCorrect && G * k == doubleAndAdd(G, k);
+    }
+    gmp_randclear(state);
+    std::cout << "GLV Endomorphism Test " << (endomorphismCorrect && negationCorrect && splitCorrect ? "PASSED" : "FAILED") << std::endl;
+
+    std::vector<Ecc_Point> points;
+    std::vector<BigInt> scalars;
+    Ecc_Point expected;
+    for (unsigned long int i = 1; i <= 8; ++i) {
+        points.push_back(doubleAndAdd(G, BigInt(i * 7919)));
+        scalars.push_back(BigInt("123456789abcdef0123456789abcdef", 16) * BigInt(i));
+        expected = expected + doubleAndAdd(points.back(), scalars.back());
+    }
+    std::cout << "GLV MSM Test " << (multiScalarMul(points, scalars) == expected ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_signatures() {
+    // RFC 6979, appendix A.2.5: P-256 with SHA-256, message "sample".
+    const CurveParameters& p256 = CurveParameters::p256();
+    BigInt d("c9afa9d845ba75166b5c215767b1d6934e50c3db36e89b127b8a622b120f6721", 16);
+    EcdsaSignature sig = ecdsaSign(p256, d, "sample");
+    bool vectorCorrect = sig.r.toString(16) == "efd48b2aacb6a8fd1140dd9cd45e81d69d2c877b56aaf991c34d0ea84eaf3716" &&
+                         sig.s.toString(16) == "f7cb1c942d657c41d436c7a1b6e29f65f3e900dbb9aff4064dc4ab2f843acda8";
+    std::cout << "ECDSA RFC 6979 Test " << (vectorCorrect && ecdsaVerify(derivePublicKey(p256, d), "sample", sig) ? "PASSED" : "FAILED") << std::endl;
+
+    const CurveParameters& k1 = CurveParameters::secp256k1();
+    std::vector<Ecc_Point> keys;
+    std::vector<std::string> messages;
+    std::vector<EcdsaSignature> ecdsa;
+    std::vector<SchnorrSignature> schnorr;
+    for (unsigned long int i = 1; i <= 16; ++i) {
+        BigInt key = BigInt(i) * BigInt("9b05688c2b3e6c1f", 16);
+        keys.push_back(derivePublicKey(k1, key));
+        messages.push_back("message " + std::to_string(i));
+        ecdsa.push_back(ecdsaSign(k1, key, messages.back()));
+        schnorr.push_back(schnorrSign(k1, key, messages.back()));
+    }
+    bool batchCorrect = ecdsaBatchVerify(keys, messages, ecdsa) && schnorrBatchVerify(keys, messages, schnorr);
+    messages[11] = "tampered";
+    std::vector<bool> ecdsaValid = ecdsaBatchVerifyEach(keys, messages, ecdsa);
+    std::vector<bool> schnorrValid = schnorrBatchVerifyEach(keys, messages, schnorr);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        batchCorrect = batchCorrect && ecdsaValid[i] == (i != 11) && schnorrValid[i] == (i != 11);
+    }
+    messages[11] = "message 12";
+    // Points off the curve, or on another curve, must not be folded into the batch.
+    std::vector<Ecc_Point> offCurve = keys;
+    offCurve[3] = Ecc_Point(keys[3].getX(), keys[3].getY() + BigInt(static_cast<unsigned long int>(1)), k1);
+    std::vector<Ecc_Point> mixed = keys;
+    mixed[5] = derivePublicKey(p256, d);
+    std::vector<SchnorrSignature> forged = schnorr;
+    forged[7].R = Ecc_Point(schnorr[7].R.getX(), schnorr[7].R.getY() + BigInt(static_cast<unsigned long int>(1)), k1);
+    batchCorrect = batchCorrect && !ecdsaBatchVerify(offCurve, messages, ecdsa) && !schnorrBatchVerify(offCurve, messages, schnorr);
+    batchCorrect = batchCorrect && !ecdsaBatchVerify(mixed, messages, ecdsa) && !schnorrBatchVerify(mixed, messages, schnorr);
+    batchCorrect = batchCorrect && !schnorrBatchVerify(keys, messages, forged) && !schnorrVerify(keys[7], messages[7], forged[7]);
+    std::vector<bool> offCurveValid = ecdsaBatchVerifyEach(offCurve, messages, ecdsa);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        batchCorrect = batchCorrect && offCurveValid[i] == (i != 3);
+    }
+    std::cout << "Batch Signature Verification Test " << (batchCorrect ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_kzg_commitments() {
+    const CurveParameters& curve = CurveParameters::secp256k1();
+    BigInt tau("5eed5eed5eed5eed5eed5eed5eed5eed", 16);
+    KZGSetup setup = kzgSetup(curve, tau, 8);
+    KZGVerifierKey vk = { Ecc_Point(curve.Gx, curve.Gy, curve), tau };
+
+    std::vector<Polynomial> polys;
+    std::vector<Ecc_Point> commitments;
+    for (unsigned long int p = 0; p < 3; ++p) {
+        std::vector<BigInt> coeffs;
+        for (unsigned long int i = 0; i <= 6 + p; ++i) {
+            coeffs.push_back(BigInt(i * i + 31 * p + 1));
+        }
+        polys.push_back(Polynomial(coeffs, curve.n));
+        commitments.push_back(kzgCommit(setup, polys.back()));
+    }
+
+    KZGOpening single = kzgOpen(setup, polys[0], BigInt(static_cast<unsigned long int>(12345)));
+    bool singleCorrect = kzgVerify(vk, commitments[0], single);
+    single.value += BigInt(static_cast<unsigned long int>(1));
+    singleCorrect = singleCorrect && !kzgVerify(vk, commitments[0], single);
+    std::cout << "KZG Opening Test " << (singleCorrect ? "PASSED" : "FAILED") << std::endl;
+
+    std::vector<BigInt> points = { BigInt(static_cast<unsigned long int>(7)), BigInt(static_cast<unsigned long int>(99)) };
+    std::vector<std::vector<size_t>> openSets = { {0, 1, 2}, {0, 2} };
+    KZGBatchOpening batch = kzgBatchOpen(setup, polys, commitments, points, openSets);
+    bool batchCorrect = kzgBatchVerify(vk, commitments, batch);
+    KZGBatchOpening swapped = batch;
+    std::swap(swapped.quotient, swapped.witness);
+    batchCorrect = batchCorrect && !kzgBatchVerify(vk, commitments, swapped);
+    batch.values[1][1] += BigInt(static_cast<unsigned long int>(1));
+    batchCorrect = batchCorrect && !kzgBatchVerify(vk, commitments, batch);
+
+    // Three points, one of them opening a single polynomial, still take two group elements.
+    points.push_back(BigInt(static_cast<unsigned long int>(4242)));
+    openSets.push_back({1});
+    KZGBatchOpening wide = kzgBatchOpen(setup, polys, commitments, points, openSets);
+    batchCorrect = batchCorrect && kzgBatchVerify(vk, commitments, wide);
+    wide.points[2] += BigInt(static_cast<unsigned long int>(1));
+    batchCorrect = batchCorrect && !kzgBatchVerify(vk, commitments, wide);
+    std::cout << "KZG Batch Opening Test " << (batchCorrect ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_witness_generation() {
+    const BigInt& p = CurveParameters::secp256k1().p;
+    CircuitBuilder builder(p);
+
+    // y = x^3 + x + 5 together with the advice wire 1/y.
+    Wire x = builder.input();
+    Wire x3 = builder.mul(builder.mul(x, x), x);
+    Wire y = builder.add(builder.add(x3, x), builder.constant(BigInt(static_cast<unsigned long int>(5))));
+    builder.exportWire(y);
+    Wire yInv = builder.hint({ y }, [](const std::vector<BigInt>& args, const BigInt& modulus) {
+        return args[0].modInverse(modulus);
+    });
+    Wire one = builder.mul(y, yInv);
+
+    // Many independent sub-circuits a_i * b_i + i, which compile into separate segments.
+    std::vector<Wire> outputs;
+    for (unsigned long int i = 0; i < 600; ++i) {
+        Wire a = builder.input();
+        Wire b = builder.input();
+        Wire t = builder.add(builder.mul(a, b), builder.constant(BigInt(i)));
+        outputs.push_back(builder.mul(t, t));
+    }
+    CompiledCircuit circuit = builder.compile();
+
+    std::vector<BigInt> inputs = { BigInt(static_cast<unsigned long int>(3)) };
+    for (unsigned long int i = 0; i < 600; ++i) {
+        inputs.push_back(BigInt(i + 11));
+        inputs.push_back(BigInt(p - BigInt(i + 1)));
+    }
+    std::vector<BigInt> witness = circuit.evaluate(inputs, 4);
+
+    bool correct = witness.size() == circuit.witnessSize() && circuit.segmentCount() > 1;
+    correct = correct && witness[builder.witnessIndex(y)] == BigInt(static_cast<unsigned long int>(35));
+    correct = correct && witness[builder.witnessIndex(one)] == BigInt(static_cast<unsigned long int>(1));
+    for (unsigned long int i = 0; i < 600 && correct; ++i) {
+        BigInt t = (BigInt(i + 11) * (p - BigInt(i + 1)) + BigInt(i)) % p;
+        correct = witness[builder.witnessIndex(outputs[i])] == (t * t) % p;
+    }
+    correct = correct && circuit.evaluate(inputs, 1) == witness;
+
+    // An exported constant feeding two long chains, which land in different segments. Each segment
+    // must load the constant itself rather than read its witness slot while another segment writes it.
+    CircuitBuilder shared(p);
+    Wire seven = shared.constant(BigInt(static_cast<unsigned long int>(7)));
+    shared.exportWire(seven);
+    std::vector<Wire> ends;
+    for (int chain = 0; chain < 2; ++chain) {
+        Wire w = shared.input();
+        for (int step = 0; step < 1100; ++step) {
+            w = shared.mul(w, seven);
+        }
+        shared.exportWire(w);
+        ends.push_back(w);
+    }
+    CompiledCircuit chains = shared.compile();
+    std::vector<BigInt> starts = { BigInt(static_cast<unsigned long int>(2)), BigInt(static_cast<unsigned long int>(3)) };
+    BigInt power = BigInt(static_cast<unsigned long int>(7)).powm(BigInt(static_cast<unsigned long int>(1100)), p);
+    correct = correct && chains.segmentCount() > 1;
+    for (int run = 0; run < 50 && correct; ++run) {
+        std::vector<BigInt> values = chains.evaluate(starts, 4);
+        correct = values[shared.witnessIndex(seven)] == BigInt(static_cast<unsigned long int>(7)) &&
+                  values[shared.witnessIndex(ends[0])] == (starts[0] * power) % p &&
+                  values[shared.witnessIndex(ends[1])] == (starts[1] * power) % p;
+    }
+    std::cout << "Witness Generation Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_sparse_polynomials() {
+    const BigInt& n = CurveParameters::secp256k1().n;
+    const size_t domain = 64;
+    Polynomial z = Polynomial::vanishing(domain, n);
+
+    std::vector<BigInt> coeffs;
+    for (unsigned long int i = 0; i < 100; ++i) {
+        coeffs.push_back(BigInt(i * i * i + 7));
+    }
+    Polynomial f(coeffs, n);
+    Polynomial product({}, n);
+    multiplyPolynomials(product, z, f);
+
+    // f * (x^64 - 1) has coefficient f[k - 64] - f[k] at x^k.
+    const std::vector<BigInt>& pc = product.getCoefficients();
+    bool correct = z.isSparse() && z.termCount() == 2 && !f.isSparse() && pc.size() == coeffs.size() + domain;
+    for (size_t k = 0; k < pc.size() && correct; ++k) {
+        BigInt expected = ((k >= domain && k - domain < coeffs.size() ? coeffs[k - domain] : BigInt(static_cast<unsigned long int>(0))) -
+                           (k < coeffs.size() ? coeffs[k] : BigInt(static_cast<unsigned long int>(0)))) % n;
+        correct = pc[k] == expected;
+    }
+
+    Polynomial quotient({}, n), remainder({}, n);
+    divideBySparse(quotient, remainder, product, z);
+    correct = correct && quotient.getCoefficients() == coeffs && remainder.termCount() == 0;
+
+    BigInt x(static_cast<unsigned long int>(987654321));
+    BigInt zx;
+    mpz_powm_ui(zx.get_mpz_t(), x.get_mpz_t(), domain, n.get_mpz_t());
+    zx = (zx - BigInt(static_cast<unsigned long int>(1))) % n;
+    correct = correct && z.evaluate(x) == zx && product.evaluate(x) == (f.evaluate(x) * zx) % n;
+
+    Polynomial selector = Polynomial::fromTerms({ SparseTerm{ 3, BigInt(static_cast<unsigned long int>(5)) }, SparseTerm{ 200, BigInt(static_cast<unsigned long int>(2)) } }, n);
+    Polynomial sum({}, n);
+    addPolynomials(sum, selector, z);
+    correct = correct && sum.isSparse() && sum.termCount() == 4 && sum.deg() == 200;
+    std::cout << "Sparse Polynomial Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_polynomial_evaluation() {
+    const BigInt& p = CurveParameters::p256().p;
+    std::vector<BigInt> coeffs;
+    BigInt c("123456789abcdef0fedcba9876543210", 16);
+    for (size_t i = 0; i < 5000; ++i) {
+        c = (c * c + BigInt(static_cast<unsigned long int>(i))) % p;
+        coeffs.push_back(c);
+    }
+    Polynomial big(coeffs, p);
+    BigInt x("deadbeefcafebabe", 16);
+
+    BigInt expected(static_cast<unsigned long int>(0));
+    BigInt power(static_cast<unsigned long int>(1));
+    for (const BigInt& coeff : coeffs) {
+        expected = (expected + coeff * power) % p;
+        power = (power * x) % p;
+    }
+    bool correct = big.evaluate(x, 1) == expected && big.evaluate(x, 4) == expected;
+
+    std::vector<BigInt> points;
+    for (unsigned long int i = 0; i < 16; ++i) {
+        points.push_back(x + BigInt(i));
+    }
+    std::vector<BigInt> many = big.evaluateMany(points, 4);
+    for (size_t i = 0; i < points.size() && correct; ++i) {
+        correct = many[i] == big.evaluate(points[i], 1);
+    }
+
+    std::vector<Polynomial> polys;
+    for (size_t k = 0; k < 50; ++k) {
+        polys.push_back(Polynomial(std::vector<BigInt>(coeffs.begin() + k, coeffs.begin() + k + 100 + k), p));
+    }
+    polys.push_back(Polynomial::vanishing(1024, p));
+    std::vector<BigInt> values = evaluatePolynomials(polys, x, 4);
+    for (size_t k = 0; k < polys.size() && correct; ++k) {
+        correct = values[k] == polys[k].evaluate(x, 1);
+    }
+    std::cout << "Polynomial Evaluation Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_powers_of_tau() {
+    const CurveParameters& curve = CurveParameters::p256();
+    BigInt tau("7a0b1c2d3e4f5a6b7c8d9e0f", 16);
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+    ScratchFile scratch("powers_of_tau_test");
+    const char* path = scratch.c_str();
+
+    // An interrupted run: 40 powers, then a torn write of a partial point.
+    bool correct = generatePowersOfTau(path, curve, tau, 40, 16, 2) == 0;
+    FILE* file = std::fopen(path, "ab");
+    std::fputs("partial point", file);
+    std::fclose(file);
+    correct = correct && generatePowersOfTau(path, curve, tau, 100, 16, 2) == 40;
+
+    std::vector<Ecc_Point> powers = readPowersOfTau(path, curve);
+    correct = correct && powers.size() == 100;
+    // Coordinates are little-endian like the header: τ⁰·G starts with the low byte of Gx.
+    unsigned char firstX[32];
+    file = std::fopen(path, "rb");
+    correct = correct && std::fseek(file, 32, SEEK_SET) == 0 && std::fread(firstX, 1, sizeof(firstX), file) == sizeof(firstX);
+    std::fclose(file);
+    BigInt storedX;
+    mpz_import(storedX.get_mpz_t(), sizeof(firstX), -1, 1, -1, 0, firstX);
+    correct = correct && storedX == curve.Gx;
+    BigInt power(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < powers.size() && correct; i += 11) {
+        mpz_powm_ui(power.get_mpz_t(), tau.get_mpz_t(), i, curve.n.get_mpz_t());
+        correct = powers[i] == g * power;
+    }
+
+    bool rejected = false;
+    try {
+        generatePowersOfTau(path, curve, tau + BigInt(static_cast<unsigned long int>(1)), 120);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    KZGSetup setup = kzgLoadSetup(path, curve);
+    correct = correct && rejected && setup.powersOfTau.size() == 100 && setup.powersOfTau[99] == kzgSetup(curve, tau, 99).powersOfTau[99];
+    std::cout << "Powers of Tau Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_simd_field() {
+    std::vector<BigInt> moduli = { CurveParameters::p256().p, CurveParameters::secp256k1().n, BigInt(static_cast<unsigned long int>(1000003)) };
+    std::vector<SimdKernel> kernels = { SimdKernel::Scalar, SimdKernel::Avx2, SimdKernel::Avx512Ifma };
+    bool correct = true;
+    for (const BigInt& p : moduli) {
+        std::vector<BigInt> a, b;
+        BigInt x("243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c89", 16);
+        for (unsigned long int i = 0; i < 37; ++i) {
+            x = (x * x + BigInt(i)) % p;
+            a.push_back(x);
+            b.push_back((x * BigInt(i + 3)) % p);
+        }
+        a[0] = p - BigInt(static_cast<unsigned long int>(1));
+        b[0] = p - BigInt(static_cast<unsigned long int>(1));
+        b[1] = BigInt(static_cast<unsigned long int>(0));
+
+        for (SimdKernel kernel : kernels) {
+            if (!SimdField::kernelSupported(kernel)) {
+                continue;
+            }
+            SimdField field(p, kernel);
+            std::vector<BigInt> product, square, sum;
+            field.mulVec(product, a, b);
+            field.sqrVec(square, a);
+            field.addVec(sum, a, b);
+            for (size_t i = 0; i < a.size() && correct; ++i) {
+                correct = product[i] == (a[i] * b[i]) % p && square[i] == (a[i] * a[i]) % p && sum[i] == (a[i] + b[i]) % p;
+            }
+        }
+    }
+    std::cout << "SIMD Field Multiplication Test (" << SimdField(moduli[0]).kernelName() << ") " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_out_of_core_ntt() {
+    const BigInt& r = nttFriendlyModulus();
+    EvaluationDomain domain(2048, r);
+    std::vector<BigInt> coefficients;
+    BigInt x("1f2e3d4c5b6a79881726354453627180", 16);
+    for (unsigned long int i = 0; i < domain.size(); ++i) {
+        x = (x * x + BigInt(i)) % r;
+        coefficients.push_back(x);
+    }
+    Polynomial poly(coefficients, r);
+    std::vector<BigInt> evaluations = coefficients;
+    domain.fft(evaluations);
+    bool correct = true;
+    for (size_t i = 0; i < domain.size() && correct; i += 97) {
+        correct = evaluations[i] == poly.evaluate(domain.element(i));
+    }
+    std::vector<BigInt> roundTrip = evaluations;
+    domain.ifft(roundTrip);
+    correct = correct && roundTrip == coefficients;
+
+    ScratchFile scratch("ntt_test");
+    const char* path = scratch.c_str();
+    SimdField field(r);
+    std::vector<uint64_t> raw(domain.size() * SimdField::LIMBS);
+    field.load(raw.data(), coefficients);
+    FILE* file = std::fopen(path, "wb");
+    std::fwrite(raw.data(), sizeof(uint64_t), raw.size(), file);
+    std::fclose(file);
+
+    std::vector<BigInt> stored;
+    outOfCoreNtt(path, domain, false, 2);
+    file = std::fopen(path, "rb");
+    correct = correct && std::fread(raw.data(), sizeof(uint64_t), raw.size(), file) == raw.size();
+    std::fclose(file);
+    SimdField::store(stored, raw.data(), domain.size());
+    correct = correct && stored == evaluations;
+
+    outOfCoreNtt(path, domain, true, 2);
+    file = std::fopen(path, "rb");
+    correct = correct && std::fread(raw.data(), sizeof(uint64_t), raw.size(), file) == raw.size();
+    std::fclose(file);
+    SimdField::store(stored, raw.data(), domain.size());
+    correct = correct && stored == coefficients;
+    std::cout << "Out-of-Core NTT Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_sharded_msm() {
+    const CurveParameters& curve = CurveParameters::p256();
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+    std::vector<Ecc_Point> points;
+    std::vector<BigInt> scalars;
+    BigInt k("3c6ef372fe94f82ba54ff53a5f1d36f1510e527fade682d19b05688c2b3e6c1f", 16);
+    Ecc_Point p = g;
+    for (unsigned long int i = 0; i < 45; ++i) {
+        k = (k * k + BigInt(i)) % curve.n;
+        points.push_back(p);
+        scalars.push_back(k);
+        p = p + g * BigInt(i + 7);
+    }
+    points[3] = Ecc_Point();
+    scalars[5] = BigInt(static_cast<unsigned long int>(0));
+    ScratchFile scratch("sharded_msm_test");
+    const char* path = scratch.c_str();
+    Ecc_Point expected = multiScalarMul(points, scalars);
+    // Unreduced coordinates, one wider than p and one negative, are stored reduced.
+    points[7] = Ecc_Point(points[7].getX() + curve.p, points[7].getY() - curve.p, curve);
+    writeMsmInput(path, points, scalars);
+
+    std::vector<pid_t> pids(3);
+    std::vector<int> fds(3);
+    MsmCoordinator coordinator(path);
+    for (size_t i = 0; i < pids.size(); ++i) {
+        pids[i] = spawnLocalMsmWorker(fds[i]);
+        coordinator.addWorker(fds[i]);
+    }
+    bool correct = coordinator.termCount() == 45 && coordinator.run(ShardStrategy::PointRange) == expected;
+    correct = correct && coordinator.run(ShardStrategy::WindowRange) == expected;
+    for (size_t i = 0; i < pids.size(); ++i) {
+        stopLocalMsmWorker(pids[i], fds[i]);
+    }
+    std::cout << "Sharded MSM Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_bigint_inline_storage() {
+    BigInt p = CurveParameters::p256().p;
+    BigInt big = p.leftShift(1000);
+    BigInt product = p * p;
+    bool correct = p.isInline() && product.isInline() && !big.isInline();
+
+    // Grows past the inline buffer, then shrinks back into it.
+    BigInt x = p;
+    x *= big;
+    correct = correct && !x.isInline() && x == big * p;
+    x %= p + BigInt(static_cast<unsigned long int>(1));
+    correct = correct && x.isInline() && x == (big * p) % (p + BigInt(static_cast<unsigned long int>(1)));
+
+    BigInt a = big;
+    BigInt b = p;
+    a.swap(b);
+    correct = correct && a == p && b == big && a.isInline() && !b.isInline();
+    a.swap(product);
+    correct = correct && a == p * p && product == p && a.isInline() && product.isInline();
+
+    std::vector<BigInt> values(100, p);
+    values.push_back(big);
+    values.resize(300, product);
+    correct = correct && values[99] == p && values[100] == big && values[299] == product;
+    correct = correct && BigInt(big.toString(16), 16) == big;
+
+    // A value whose limbs came from GMP's default allocator, as before the library's functions were
+    // installed, is grown and freed through that allocator.
+    mpz_t foreign;
+    foreign->_mp_alloc = 1;
+    foreign->_mp_size = 0;
+    foreign->_mp_d = static_cast<mp_limb_t*>(std::malloc(sizeof(mp_limb_t)));
+    mpz_set(foreign, big.get_mpz_t());
+    correct = correct && BigInt(foreign) == big;
+    mpz_clear(foreign);
+    std::cout << "BigInt Inline Storage Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_batch_scalar_multiplication() {
+    bool correct = true;
+    const CurveParameters* curves[2] = { &CurveParameters::p256(), &CurveParameters::secp256k1() };
+    for (const CurveParameters* curve : curves) {
+        Ecc_Point g(curve->Gx, curve->Gy, *curve);
+        std::vector<Ecc_Point> points;
+        std::vector<BigInt> scalars;
+        BigInt k("6a09e667f3bcc908b2fb1366ea957d3e3adec17512775099da2f590b0667322a", 16);
+        for (unsigned long int i = 0; i < 23; ++i) {
+            k = (k * k + BigInt(i)) % curve->n;
+            points.push_back(g * (k + BigInt(i)));
+            scalars.push_back(k);
+        }
+        points[4] = Ecc_Point();
+        scalars[7] = BigInt(static_cast<unsigned long int>(0));
+        scalars[9] = BigInt(static_cast<signed long int>(-12345));
+        scalars[11] = curve->n + BigInt(static_cast<unsigned long int>(3));
+
+        std::vector<Ecc_Point> products = batchScalarMul(points, scalars, 3);
+        correct = correct && products.size() == points.size();
+        for (size_t i = 0; i < points.size() && correct; ++i) {
+            BigInt reduced = scalars[i] % curve->n;
+            if (reduced.isNegative()) {
+                reduced += curve->n;
+            }
+            correct = products[i] == points[i] * reduced;
+        }
+    }
+    std::cout << "Batch Scalar Multiplication Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_evaluations() {
+    const BigInt& r = nttFriendlyModulus();
+    std::shared_ptr<const EvaluationDomain> domain = std::make_shared<EvaluationDomain>(64, r);
+    std::vector<BigInt> fc, gc, hc;
+    BigInt x("9e3779b97f4a7c15f39cc0605cedc834", 16);
+    for (unsigned long int i = 0; i < 32; ++i) {
+        x = (x * x + BigInt(i)) % r;
+        fc.push_back(x);
+        gc.push_back((x * BigInt(i + 5)) % r);
+        hc.push_back((x + BigInt(i * i)) % r);
+    }
+    Polynomial f(fc, r), g(gc, r), h(hc, r);
+    Evaluations ef = Evaluations::fromPolynomial(domain, f);
+    Evaluations eg = Evaluations::fromPolynomial(domain, g);
+    Evaluations eh = Evaluations::fromPolynomial(domain, h);
+    BigInt three(static_cast<unsigned long int>(3)), seven(static_cast<unsigned long int>(7));
+
+    // (f·g + 3h − 7) − 2f, fused into one pass.
+    Evaluations chain = (ef * eg + eh.scale(three) - Evaluations::constant(domain, seven)) - Evaluations::linearCombination({ ef }, { BigInt(static_cast<unsigned long int>(2)) });
+    bool correct = !chain.isMaterialized();
+    Polynomial fg(fc, r), h3(fc, r), expected(fc, r), twoF(fc, r);
+    multiplyPolynomials(fg, f, g);
+    multiplyPolynomialByScalar(h3, h, three);
+    multiplyPolynomialByScalar(twoF, f, BigInt(static_cast<unsigned long int>(2)));
+    addPolynomials(expected, fg, h3);
+    subtractPolynomials(expected, expected, Polynomial({ seven }, r));
+    subtractPolynomials(expected, expected, twoF);
+    for (size_t i = 0; i < domain->size() && correct; i += 7) {
+        correct = chain[i] == expected.evaluate(domain->element(i));
+    }
+    BigInt z("123456789abcdef", 16);
+    correct = correct && chain.isMaterialized() && chain.toPolynomial().evaluate(z) == expected.evaluate(z);
+    correct = correct && &chain.toPolynomial() == &chain.toPolynomial() && &ef.toPolynomial() == &ef.toPolynomial();
+
+    // Long chains are cut into fused segments.
+    Evaluations acc = ef;
+    for (int i = 0; i < 200; ++i) {
+        acc = acc + eg;
+    }
+    correct = correct && acc[5] == (ef[5] + BigInt(static_cast<unsigned long int>(200)) * eg[5]) % r;
+    std::cout << "Evaluation Form Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_kronecker_multiplication() {
+    std::vector<BigInt> moduli = { CurveParameters::p256().p, BigInt(static_cast<unsigned long int>(7)) };
+    bool correct = true;
+    for (const BigInt& mod : moduli) {
+        std::vector<BigInt> a, b;
+        BigInt x("b7e151628aed2a6abf7158809cf4f3c762e7160f38b4da56a784d9045190cfef", 16);
+        for (unsigned long int i = 0; i < 150; ++i) {
+            x = (x * x + BigInt(i)) % mod;
+            a.push_back(i == 3 ? BigInt(static_cast<signed long int>(-5)) : x);
+            if (i < 70) {
+                b.push_back(mod - x);
+            }
+        }
+        b[69] = mod - BigInt(static_cast<unsigned long int>(1));
+        Polynomial pa(a, mod), pb(b, mod), product(a, mod), square(a, mod);
+        multiplyPolynomials(product, pa, pb);
+        multiplyPolynomials(square, pa, pa);
+        BigInt z("2b7e151628aed2a6abf7158809cf4f3c", 16);
+        BigInt az = pa.evaluate(z);
+        correct = correct && product.deg() == 218 && product.evaluate(z) == (az * pb.evaluate(z)) % mod;
+        correct = correct && square.evaluate(z) == (az * az) % mod;
+    }
+    std::cout << "Kronecker Polynomial Multiplication Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_prover_service() {
+    const CurveParameters& curve = CurveParameters::secp256k1();
+    BigInt tau("3c0ffee5eed", 16);
+    ScratchFile srsScratch("prover_service_srs");
+    ScratchFile socketScratch("prover_service_sock");
+    const char* srsPath = srsScratch.c_str();
+    const char* socketPath = socketScratch.c_str();
+    generatePowersOfTau(srsPath, curve, tau, 16);
+    KZGVerifierKey vk = { Ecc_Point(curve.Gx, curve.Gy, curve), tau };
+
+    CircuitBuilder cubic(curve.n);
+    Wire x = cubic.input();
+    cubic.exportWire(cubic.add(cubic.mul(cubic.mul(x, x), x), cubic.constant(BigInt(static_cast<unsigned long int>(5)))));
+    CircuitBuilder product(curve.n);
+    Wire a = product.input();
+    product.exportWire(product.mul(product.mul(a, product.input()), product.input()));
+
+    ProverService service(curve, srsPath, 4, 16, 2);
+    service.registerCircuit("cubic", cubic.compile());
+    service.registerCircuit("product", product.compile());
+    auto valid = [&](const std::string& name, const ProofResponse& response) {
+        return response.status == ProofStatus::Ok && response.opening.point == proofChallenge(name, response.commitment, curve.n) &&
+               kzgVerify(vk, response.commitment, response.opening);
+    };
+
+    // Until the workers start, jobs wait in the queue: the fifth is turned away and the one with a
+    // 1 ms deadline expires.
+    ProofRequest first;
+    first.circuit = "cubic";
+    first.inputs = { BigInt(static_cast<unsigned long int>(3)) };
+    ProofRequest hurried = first;
+    hurried.deadlineMs = 1;
+    ProofRequest other;
+    other.circuit = "product";
+    other.inputs = { BigInt(static_cast<unsigned long int>(2)), BigInt(static_cast<unsigned long int>(3)), BigInt(static_cast<signed long int>(-4)) };
+    ProofRequest second = first;
+    second.inputs[0] = BigInt(static_cast<unsigned long int>(4));
+    std::future<ProofResponse> results[5] = { service.submit(first), service.submit(hurried), service.submit(other),
+                                              service.submit(second), service.submit(second) };
+    ProofRequest unknown;
+    unknown.circuit = "missing";
+    bool correct = service.prove(unknown).status == ProofStatus::UnknownCircuit;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    service.start();
+
+    ProofResponse cubicProof = results[0].get();
+    correct = correct && valid("cubic", cubicProof) && results[1].get().status == ProofStatus::DeadlineExceeded;
+    correct = correct && valid("product", results[2].get()) && valid("cubic", results[3].get());
+    correct = correct && results[4].get().status == ProofStatus::Busy;
+    ProverStats stats = service.stats();
+    correct = correct && stats.accepted == 4 && stats.rejected == 1 && stats.expired == 1 && stats.proved == 3 && stats.batches == 2;
+
+    std::thread server([&] { service.serve(socketPath, 1); });
+    int fd = -1;
+    for (int attempt = 0; attempt < 200 && fd < 0; ++attempt) {
+        try {
+            fd = connectProver(socketPath);
+        } catch (const std::runtime_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    if (fd >= 0) {
+        ProofResponse remote = requestProof(fd, first, curve);
+        correct = correct && valid("cubic", remote) && remote.commitment == cubicProof.commitment;
+        correct = correct && valid("product", requestProof(fd, other, curve));
+        correct = correct && requestProof(fd, unknown, curve).status == ProofStatus::UnknownCircuit;
+        close(fd);
+    } else {
+        correct = false;
+        service.stop();
+    }
+    server.join();
+    std::cout << "Prover Service Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_allocation_accounting() {
+    auto scopeStats = [](const std::string& name) {
+        AllocationStats found = AllocationStats();
+        for (const AllocationStats& stats : allocationStatsByScope()) {
+            if (stats.scope == name) {
+                found = stats;
+            }
+        }
+        return found;
+    };
+    setAllocationAccounting(true);
+
+    // 2048-bit values spill to the heap; small ones stay inline and never reach the allocator.
+    BigInt big = BigInt(static_cast<unsigned long int>(1)).leftShift(2047);
+    {
+        AllocationScope scope("test-big");
+        std::vector<BigInt> values(10, big);
+        AllocationScope inner("test-small");
+        std::vector<BigInt> small(100, BigInt(static_cast<unsigned long int>(12345)));
+    }
+    AllocationStats bigStats = scopeStats("test-big");
+    bool correct = bigStats.allocations == 10 && bigStats.frees == 10 && bigStats.liveBytes == 0;
+    correct = correct && bigStats.peakBytes >= 10 * 256 && bigStats.sizeClasses[3] == 10;
+    correct = correct && scopeStats("test-small").allocations == 0;
+
+    // Workers of parallelFor inherit the scope, and library code charges its own scopes.
+    {
+        AllocationScope scope("test-parallel");
+        parallelFor(8, [&](size_t i) {
+            BigInt product = big * BigInt(static_cast<unsigned long int>(i + 2));
+        }, 4);
+    }
+    correct = correct && scopeStats("test-parallel").allocations >= 8;
+    const BigInt& mod = CurveParameters::p256().p;
+    std::vector<BigInt> coeffs;
+    for (unsigned long int i = 0; i < 40; ++i) {
+        coeffs.push_back(BigInt(i * 7919 + 1));
+    }
+    Polynomial poly(coeffs, mod), product({}, mod);
+    multiplyPolynomials(product, poly, poly);
+    correct = correct && scopeStats("polynomial").allocations > 0;
+
+    AllocationStats totals = allocationTotals();
+    correct = correct && totals.peakBytes >= totals.liveBytes && totals.allocations >= bigStats.allocations;
+    resetAllocationPeaks();
+    correct = correct && scopeStats("test-big").peakBytes == 0;
+    correct = correct && allocationSummary().find("test-parallel") != std::string::npos;
+    setAllocationAccounting(false);
+    std::cout << "Allocation Accounting Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_binary_io() {
+    const BigInt& p = CurveParameters::p256().p;
+    ScratchFile scratch("binary_io_test");
+    const char* path = scratch.c_str();
+    std::vector<BigInt> values;
+    for (unsigned long int i = 0; i < 5000; ++i) {
+        values.push_back(p.rightShift(i % 250) * BigInt(i + 1) + BigInt(i));
+    }
+    values.push_back(BigInt(static_cast<signed long int>(-7)));
+    values.push_back(p);
+
+    writeFieldElements(path, values, p, 3);
+    BigInt storedModulus;
+    std::vector<BigInt> loaded = readFieldElements(path, storedModulus, 3);
+    bool correct = storedModulus == p && loaded.size() == values.size();
+    for (size_t i = 0; i < loaded.size() && correct; ++i) {
+        correct = loaded[i] == values[i] % p;
+    }
+
+    std::vector<BigInt> coeffs(values.begin(), values.begin() + 300);
+    Polynomial dense(coeffs, p);
+    writePolynomial(path, dense);
+    Polynomial denseLoaded = readPolynomial(path);
+    BigInt z(static_cast<unsigned long int>(987654321));
+    correct = correct && !denseLoaded.isSparse() && denseLoaded.deg() == dense.deg() && denseLoaded.evaluate(z) == dense.evaluate(z);
+    Polynomial sparse = Polynomial::vanishing(1 << 20, p);
+    writePolynomial(path, sparse);
+    Polynomial sparseLoaded = readPolynomial(path);
+    correct = correct && sparseLoaded.isSparse() && sparseLoaded.deg() == (1 << 20) && sparseLoaded.evaluate(z) == sparse.evaluate(z);
+
+    std::vector<Data> points = { Data("1", "1", "101"), Data("2", "4", "101"), Data("3", "9", "101") };
+    BigInt small(static_cast<unsigned long int>(101));
+    writePoints(path, points, small);
+    std::vector<Data> pointsLoaded = readPoints(path, storedModulus);
+    correct = correct && storedModulus == small && pointsLoaded.size() == 3 &&
+              interpolate(pointsLoaded, BigInt(static_cast<unsigned long int>(6)), "101") == BigInt(static_cast<unsigned long int>(36));
+
+    // Reading a file as the wrong kind, or a truncated one, is rejected.
+    bool rejected = false;
+    try {
+        readFieldElements(path, storedModulus);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    writeFieldElements(path, values, p);
+    if (truncate(path, 24 + 32 + 100 * 32 + 5) == 0) {
+        try {
+            readFieldElements(path, storedModulus);
+            rejected = false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::cout << "Binary Field Element I/O Test " << (correct && rejected ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_polynomial_division() {
+    const BigInt& mod = CurveParameters::secp256k1().n;
+    auto make = [&](size_t length, unsigned long int seed) {
+        std::vector<BigInt> coeffs;
+        BigInt c(seed);
+        for (size_t i = 0; i < length; ++i) {
+            c = (c * c + BigInt(static_cast<unsigned long int>(i + 7))) % mod;
+            coeffs.push_back(i % 5 == 3 ? mod - c : c);
+        }
+        return Polynomial(coeffs, mod);
+    };
+    BigInt z("123456789abcdef0fedcba987654321", 16);
+    auto divides = [&](const Polynomial& a, const Polynomial& b, const Polynomial& q, const Polynomial& r, int remainderDegree) {
+        return r.deg() == remainderDegree && (q.evaluate(z) * b.evaluate(z) + r.evaluate(z)) % mod == a.evaluate(z);
+    };
+
+    // Newton inversion, long division, linear and sparse divisors all satisfy a = q·b + r.
+    bool correct = true;
+    size_t shapes[4][2] = { { 700, 300 }, { 700, 650 }, { 21, 6 }, { 1200, 90 } };
+    for (auto& shape : shapes) {
+        Polynomial a = make(shape[0], shape[0]), b = make(shape[1], shape[1] + 1);
+        Polynomial q({}, mod), r({}, mod), qLong({}, mod), rLong({}, mod);
+        dividePolynomials(q, r, a, b);
+        divideBySparse(qLong, rLong, a, b);
+        correct = correct && divides(a, b, q, r, static_cast<int>(shape[1]) - 2) && q.deg() == static_cast<int>(shape[0] - shape[1]);
+        correct = correct && q.getCoefficients() == qLong.getCoefficients() && r.getCoefficients() == rLong.getCoefficients();
+    }
+    Polynomial a = make(200, 3);
+    Polynomial linear({ BigInt(static_cast<unsigned long int>(5)), BigInt(static_cast<unsigned long int>(3)) }, mod);
+    Polynomial vanishing = Polynomial::vanishing(64, mod);
+    Polynomial q({}, mod), r({}, mod);
+    dividePolynomials(q, r, a, linear);
+    correct = correct && divides(a, linear, q, r, 0);
+    dividePolynomials(q, r, a, vanishing);
+    correct = correct && divides(a, vanishing, q, r, 63);
+
+    // An exact multiple leaves no remainder, and divideByLinear returns f(root).
+    Polynomial product({}, mod);
+    Polynomial b = make(100, 11);
+    multiplyPolynomials(product, a, b);
+    dividePolynomials(q, r, product, b);
+    bool exact = true;
+    for (const BigInt& coeff : r.getCoefficients()) {
+        exact = exact && coeff.isZero();
+    }
+    correct = correct && exact && q.evaluate(z) == a.evaluate(z);
+    BigInt value;
+    divideByLinear(q, value, a, z);
+    correct = correct && value == a.evaluate(z) && q.deg() == 198;
+
+    Polynomial halved({}, mod);
+    dividePolynomialByScalar(halved, a, BigInt(static_cast<unsigned long int>(2)));
+    correct = correct && (halved.evaluate(z) * BigInt(static_cast<unsigned long int>(2))) % mod == a.evaluate(z);
+    bool rejected = false;
+    try {
+        dividePolynomials(q, r, a, Polynomial({ mod, BigInt() }, mod));
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    std::cout << "Polynomial Division Test " << (correct && rejected ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_random_sampling() {
+    auto hex = [](const uint8_t* bytes, size_t length) {
+        static const char* DIGITS = "0123456789abcdef";
+        std::string out;
+        for (size_t i = 0; i < length; ++i) {
+            out.push_back(DIGITS[bytes[i] >> 4]);
+            out.push_back(DIGITS[bytes[i] & 15]);
+        }
+        return out;
+    };
+
+    // All-zero key and nonce, block 0.
+    uint8_t block[ChaCha20Rng::BLOCK_SIZE];
+    ChaCha20Rng zero(std::string(ChaCha20Rng::KEY_SIZE, '\0'));
+    zero.fill(block, sizeof(block));
+    bool correct = hex(block, 32) == "76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7";
+
+    // RFC 7539, section 2.3.2: key 00..1f, IETF nonce 000000090000004a00000000, counter 1.
+    std::string key;
+    for (int i = 0; i < 32; ++i) {
+        key.push_back(static_cast<char>(i));
+    }
+    ChaCha20Rng rfc(key, 0x4a000000);
+    rfc.seek(1 | static_cast<uint64_t>(0x09000000) << 32);
+    rfc.fill(block, sizeof(block));
+    correct = correct && hex(block, 32) == "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e";
+
+    CurveParameters curve = CurveParameters::p256();
+    ChaCha20Rng a(2024), b(2024), c(2024, 1);
+    BigInt x, y, z;
+    bool inRange = true;
+    for (int i = 0; i < 1000; ++i) {
+        a.uniform(x, curve.n);
+        b.uniform(y, curve.n);
+        c.uniform(z, curve.n);
+        correct = correct && x == y && x != z;
+        inRange = inRange && !x.isNegative() && x < curve.n;
+    }
+    ChaCha20Rng forked = a.fork(1);
+    correct = correct && forked.uniform(curve.n) == ChaCha20Rng(2024, 1).uniform(curve.n);
+
+    // Small bound: every value appears, none above it.
+    BigInt seven(static_cast<unsigned long int>(7));
+    size_t counts[7] = { 0 };
+    for (int i = 0; i < 7000; ++i) {
+        a.uniformNonZero(x, seven);
+        inRange = inRange && !x.isZero() && x < seven;
+        ++counts[mpz_get_ui(x.get_mpz_t())];
+    }
+    for (int v = 1; v < 7; ++v) {
+        inRange = inRange && counts[v] > 800 && counts[v] < 1200;
+    }
+
+    // Bulk sampling does not depend on the thread count.
+    ChaCha20Rng s1(7), s4(7);
+    std::vector<BigInt> serial, parallel;
+    sampleUniform(serial, 5000, curve.n, s1, 1);
+    sampleUniform(parallel, 5000, curve.n, s4, 4);
+    correct = correct && serial == parallel && s1.nextU64() == s4.nextU64();
+
+    // Sampling into existing values stays in their inline limbs.
+    bool wasEnabled = allocationAccountingEnabled();
+    setAllocationAccounting(true);
+    uint64_t before = allocationTotals().allocations;
+    for (int i = 0; i < 1000; ++i) {
+        a.uniform(x, curve.n);
+    }
+    bool noAllocations = allocationTotals().allocations == before;
+    setAllocationAccounting(wasEnabled);
+
+    std::cout << "Random Sampling Test " << (correct && inRange && noAllocations ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_incremental_proving() {
+    const CurveParameters& curve = CurveParameters::secp256k1();
+    BigInt tau("1dea5eed", 16);
+    ScratchFile scratch("incremental_proving_srs");
+    const char* srsPath = scratch.c_str();
+    generatePowersOfTau(srsPath, curve, tau, 64);
+    KZGVerifierKey vk = { Ecc_Point(curve.Gx, curve.Gy, curve), tau };
+
+    // Lagrange-basis commitments and openings agree with the coefficient form, on and off the domain.
+    KZGSetup setup = kzgLoadSetup(srsPath, curve);
+    EvaluationDomain domain(16, curve.n);
+    std::vector<Ecc_Point> basis = kzgLagrangeBasis(setup, domain, 2);
+    std::vector<BigInt> evaluations;
+    for (unsigned long int i = 0; i < 16; ++i) {
+        evaluations.push_back(BigInt(i * i + 7));
+    }
+    std::vector<BigInt> coefficients = evaluations;
+    domain.ifft(coefficients);
+    Polynomial f(coefficients, curve.n);
+    bool correct = multiScalarMul(basis, evaluations) == kzgCommit(setup, f);
+    BigInt points[2] = { BigInt(static_cast<unsigned long int>(123456789)), domain.element(5) };
+    for (const BigInt& z : points) {
+        KZGOpening direct = kzgOpenEvaluations(basis, domain, evaluations, z);
+        KZGOpening reference = kzgOpen(setup, f, z);
+        correct = correct && direct.value == reference.value && direct.witness == reference.witness;
+    }
+
+    CircuitBuilder builder(curve.n);
+    Wire sum = builder.constant(BigInt());
+    for (int i = 0; i < 12; ++i) {
+        Wire x = builder.input();
+        sum = builder.add(sum, builder.mul(x, x));
+    }
+    builder.exportWire(sum);
+    ProverService service(curve, srsPath, 16, 4, 2, 2);
+    service.registerCircuit("squares", builder.compile());
+    correct = correct && service.maxWitnessSize() == 64;
+    CircuitBuilder wide(curve.n);
+    Wire total = wide.input();
+    for (int i = 0; i < 64; ++i) {
+        total = wide.add(total, wide.input());
+    }
+    wide.exportWire(total);
+    try {
+        service.registerCircuit("wide", wide.compile());
+        correct = false;
+    } catch (const std::invalid_argument&) {
+    }
+    service.start();
+
+    ProofRequest request;
+    request.circuit = "squares";
+    for (unsigned long int i = 0; i < 12; ++i) {
+        request.inputs.push_back(BigInt(i + 1));
+    }
+    request.session = "client-1";
+    ProofRequest standalone = request;
+    standalone.session.clear();
+    for (int round = 0; round < 4; ++round) {
+        ProofResponse incremental = service.prove(request);
+        ProofResponse full = service.prove(standalone);
+        correct = correct && incremental.status == ProofStatus::Ok && kzgVerify(vk, incremental.commitment, incremental.opening);
+        correct = correct && incremental.commitment == full.commitment && incremental.opening.witness == full.opening.witness;
+        request.inputs[round * 3] = request.inputs[round * 3] + BigInt(static_cast<unsigned long int>(round + 5));
+        standalone.inputs = request.inputs;
+    }
+    correct = correct && service.stats().incremental == 3;
+    service.endSession("client-1");
+    correct = correct && service.prove(request).status == ProofStatus::Ok && service.stats().incremental == 3;
+
+    // With room for two sessions, opening a third drops the least recently used one.
+    for (const char* name : { "client-2", "client-3", "client-1" }) {
+        request.session = name;
+        correct = correct && service.prove(request).status == ProofStatus::Ok;
+    }
+    correct = correct && service.stats().incremental == 3;
+
+    // Over the socket, an end-session frame drops the session before the next request is read.
+    ScratchFile socketScratch("incremental_proving_socket");
+    const char* socketPath = socketScratch.c_str();
+    std::thread server([&] { service.serve(socketPath, 1); });
+    int fd = -1;
+    for (int attempt = 0; attempt < 200 && fd < 0; ++attempt) {
+        try {
+            fd = connectProver(socketPath);
+        } catch (const std::runtime_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    if (fd >= 0) {
+        request.session = "client-3";
+        correct = correct && requestProof(fd, request, curve).status == ProofStatus::Ok && service.stats().incremental == 4;
+        endProverSession(fd, "client-3");
+        correct = correct && requestProof(fd, request, curve).status == ProofStatus::Ok && service.stats().incremental == 4;
+        close(fd);
+    } else {
+        correct = false;
+    }
+    service.stop();
+    server.join();
+    std::cout << "Incremental Proving Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_point_vector() {
+    const CurveParameters& curve = CurveParameters::p256();
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+    ChaCha20Rng rng(48);
+    std::vector<BigInt> scalars;
+    sampleUniform(scalars, 300, curve.n, rng, 2);
+    std::vector<Ecc_Point> points = FixedBaseTable(g).multiplyBatch(scalars);
+    points[7] = Ecc_Point();
+    points[130] = Ecc_Point();
+    sampleUniform(scalars, 300, curve.n, rng, 2);
+
+    PointVector vector(curve, points);
+    bool correct = vector.size() == points.size() && vector.isInfinity(7) && vector.isInfinity(130) && !vector.isInfinity(8);
+    size_t index = 0;
+    for (const Ecc_Point& point : vector) {
+        correct = correct && point == points[index++];
+    }
+    correct = correct && index == points.size();
+    bool compact = vector.memoryBytes() * 8 < points.size() * sizeof(Ecc_Point);
+
+    // MSM over the whole vector and over a view agrees with the Ecc_Point form.
+    correct = correct && multiScalarMul(vector, scalars) == multiScalarMul(points, scalars);
+    PointView middle = vector.view(100, 50).subview(10, 30);
+    std::vector<Ecc_Point> slice(points.begin() + 110, points.begin() + 140);
+    std::vector<BigInt> sliceScalars(scalars.begin() + 110, scalars.begin() + 140);
+    correct = correct && multiScalarMul(middle, sliceScalars) == multiScalarMul(slice, sliceScalars);
+    PointVector secp(CurveParameters::secp256k1());
+    Ecc_Point h(CurveParameters::secp256k1().Gx, CurveParameters::secp256k1().Gy, CurveParameters::secp256k1());
+    for (int i = 1; i <= 40; ++i) {
+        secp.push_back(h * BigInt(static_cast<unsigned long int>(i)));
+    }
+    std::vector<BigInt> secpScalars(scalars.begin(), scalars.begin() + 40);
+    correct = correct && multiScalarMul(secp, secpScalars) == multiScalarMul(secp.toPoints(), secpScalars);
+
+    // Batch normalization straight into a vector.
+    JacobianArithmetic arithmetic(g);
+    std::vector<JacobianPoint> jacobian;
+    for (int i = 0; i < 20; ++i) {
+        jacobian.push_back(arithmetic.dbl(arithmetic.fromAffine(points[i])));
+    }
+    PointVector normalized(curve);
+    arithmetic.toAffineBatch(jacobian, normalized);
+    for (int i = 0; i < 20; ++i) {
+        correct = correct && normalized[i] == points[i] + points[i];
+    }
+
+    // Files: the infinity bitmap round-trips, and files without infinity stay readable as point sets.
+    ScratchFile scratch("point_vector_test");
+    const char* path = scratch.c_str();
+    writePointVector(path, vector, 3);
+    PointVector loaded = readPointVector(path, curve, 3);
+    correct = correct && loaded.size() == vector.size();
+    for (size_t i = 0; i < loaded.size() && correct; ++i) {
+        correct = loaded[i] == vector[i];
+    }
+    BigInt modulus;
+    bool rejected = false;
+    try {
+        readPoints(path, modulus);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    writePointVector(path, vector.view(10, 100));
+    std::vector<Data> plain = readPoints(path, modulus);
+    correct = correct && modulus == curve.p && plain.size() == 100 && plain[5].x == points[15].getX() && plain[5].y == points[15].getY();
+    std::cout << "Point Vector Test " << (correct && compact && rejected ? "PASSED" : "FAILED") << std::endl;
+}
+
+// The permutation exactly as specified, without the partial-round optimizations.
+void referencePoseidon(const PoseidonParameters& params, const FieldBackend& field, std::vector<BigInt>& state) {
+    size_t half = params.fullRounds / 2;
+    BigInt alpha(params.alpha);
+    for (size_t r = 0; r < params.fullRounds + params.partialRounds; ++r) {
+        bool full = r < half || r >= half + params.partialRounds;
+        for (size_t i = 0; i < params.width; ++i) {
+            state[i] = field.add(state[i], params.roundConstants[r][i]);
+            if (full || i == 0) {
+                state[i] = state[i].powm(alpha, params.modulus);
+            }
+        }
+        std::vector<BigInt> mixed(params.width, BigInt(static_cast<unsigned long int>(0)));
+        for (size_t i = 0; i < params.width; ++i) {
+            for (size_t j = 0; j < params.width; ++j) {
+                mixed[i] = field.add(mixed[i], field.mul(params.mds[i][j], state[j]));
+            }
+        }
+        state = mixed;
+    }
+}
+
+void test_poseidon() {
+    const CurveParameters& curve = CurveParameters::p256();
+    std::shared_ptr<const Poseidon> poseidon = Poseidon::forModulus(curve.n);
+    const PoseidonParameters& params = poseidon->parameters();
+    BigInt order = curve.n - BigInt(static_cast<unsigned long int>(1));
+    bool correct = Poseidon::forModulus(curve.n) == poseidon && params.width == 3 && params.fullRounds == 8 &&
+                   params.partialRounds == 56 && mpz_gcd_ui(NULL, order.get_mpz_t(), params.alpha) == 1;
+
+    // The optimized permutation matches the textbook one, for widths 3 and 5 and two fields.
+    ChaCha20Rng rng(49);
+    std::shared_ptr<const Poseidon> wide = Poseidon::forModulus(CurveParameters::secp256k1().n, 5);
+    for (const Poseidon* instance : { poseidon.get(), wide.get() }) {
+        for (int trial = 0; trial < 3; ++trial) {
+            std::vector<BigInt> state(instance->parameters().width);
+            for (BigInt& v : state) {
+                rng.uniform(v, instance->parameters().modulus);
+            }
+            std::vector<BigInt> expected = state;
+            referencePoseidon(instance->parameters(), instance->getField(), expected);
+            instance->permute(state);
+            correct = correct && state == expected;
+        }
+    }
+    correct = correct && Poseidon(PoseidonParameters::generate(curve.n)).hash({ curve.Gx, curve.Gy }) == poseidon->hash({ curve.Gx, curve.Gy });
+
+    // Batched hashing and Merkle trees agree with one-at-a-time hashing.
+    std::vector<std::vector<BigInt>> inputs(37);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        sampleUniform(inputs[i], i % 5, curve.n, rng);
+    }
+    std::vector<BigInt> digests = poseidon->hashBatch(inputs, 3);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        correct = correct && digests[i] == poseidon->hash(inputs[i]);
+    }
+    correct = correct && poseidon->hash({}) != poseidon->hash({ BigInt(static_cast<unsigned long int>(0)) });
+    std::vector<BigInt> leaves;
+    sampleUniform(leaves, 5, curve.n, rng);
+    BigInt zero(static_cast<unsigned long int>(0));
+    BigInt left = poseidon->hash({ poseidon->hash({ leaves[0], leaves[1] }), poseidon->hash({ leaves[2], leaves[3] }) });
+    BigInt right = poseidon->hash({ poseidon->hash({ leaves[4], zero }), zero });
+    correct = correct && poseidon->merkleRoot(leaves, 2) == poseidon->hash({ left, right });
+
+    // Transcripts: same messages give the same challenges; order, trailing zeros and labels matter.
+    Ecc_Point g(curve.Gx, curve.Gy, curve);
+    PoseidonTranscript a(curve.n, "test"), b(curve.n, "test"), c(curve.n, "test"), d(curve.n, "other");
+    a.absorb(g);
+    a.absorb(leaves[0]);
+    b.absorb(g);
+    b.absorb(leaves[0]);
+    c.absorb(leaves[0]);
+    c.absorb(g);
+    d.absorb(g);
+    d.absorb(leaves[0]);
+    BigInt challenge = a.challenge();
+    correct = correct && challenge == b.challenge() && challenge != c.challenge() && challenge != d.challenge() && challenge < curve.n;
+    std::vector<BigInt> more = a.challenges(2);
+    b.absorb(zero);
+    correct = correct && more[0] != more[1] && more[0] != challenge && b.challenges(2) != more;
+    PoseidonTranscript e(curve.n, "test"), f(curve.n, "test");
+    e.absorb(Ecc_Point());
+    f.absorb(g + g);
+    correct = correct && e.challenge() != f.challenge();
+    std::cout << "Poseidon Test " << (correct ? "PASSED" : "FAILED") << std::endl;
+}
+
+bool onCurve(const Ecc_Point& point) {
+    const CurveParameters& curve = point.getCurveParameters();
+    const FieldBackend& field = *point.getField();
+    const BigInt& x = point.getX();
+    BigInt rhs = field.add(field.mul(field.add(field.sqr(x), curve.a), x), curve.b);
+    return field.sqr(point.getY()) == rhs;
+}
+
+void test_hash_to_curve() {
+    // Test vectors of RFC 9380 appendices K.1, J.1.1 and J.8.1.
+    std::string expanded = expandMessageXmd("", "QUUX-V01-CS02-with-expander-SHA256-128", 32);
+    BigInt expandedValue;
+    mpz_import(expandedValue.get_mpz_t(), expanded.size(), 1, 1, 1, 0, expanded.data());
+    bool correct = expandedValue == BigInt("68a985b87eb6b46952128911f2a4412bbc302a9d759667f87f7a21d803f07235", 16);
+
+    const CurveParameters& p256 = CurveParameters::p256();
+    const CurveParameters& secp = CurveParameters::secp256k1();
+    HashToCurve p256Hash(p256, "QUUX-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_");
+    HashToCurve secpHash(secp, "QUUX-V01-CS02-with-secp256k1_XMD:SHA-256_SSWU_RO_");
+    Ecc_Point p = p256Hash.hash("");
+    correct = correct && p.getX() == BigInt("2c15230b26dbc6fc9a37051158c95b79656e17a1a920b11394ca91c44247d3e4", 16) &&
+              p.getY() == BigInt("8a7a74985cc5c776cdfe4b1f19884970453912e9d31528c060be9ab5c43e8415", 16);
+    p = p256Hash.hash("abc");
+    correct = correct && p.getX() == BigInt("0bb8b87485551aa43ed54f009230450b492fead5f1cc91658775dac4a3388a0f", 16) &&
+              p.getY() == BigInt("5c41b3d0731a27a7b14bc0bf0ccded2d8751f83493404c84a88e71ffd424212e", 16);
+    p = secpHash.hash("");
+    correct = correct && p.getX() == BigInt("c1cae290e291aee617ebaef1be6d73861479c48b841eaba9b7b5852ddfeb1346", 16) &&
+              p.getY() == BigInt("64fa678e07ae116126f08b022a94af6de15985c996c3a91b64c406a960e51067", 16);
+
+    // Encodings, exceptional inputs and oversized tags still land on the curve.
+    BigInt zero(static_cast<unsigned long int>(0));
+    for (const HashToCurve* h : { &p256Hash, &secpHash }) {
+        correct = correct && onCurve(h->encode("abc")) && onCurve(h->mapToCurve(zero)) && onCurve(h->mapToCurve(h->getCurve().p - BigInt(static_cast<unsigned long int>(1))));
+    }
+    correct = correct && onCurve(HashToCurve(secp, std::string(300, 'd')).hash("abc"));
+
+    // The batch spans several inversion blocks and agrees with one-at-a-time hashing.
+    std::vector<std::string> messages;
+    for (int i = 0; i < 300; ++i) {
+        messages.push_back("identifier-" + std::to_string(i));
+    }
+    for (const HashToCurve* h : { &p256Hash, &secpHash }) {
+        PointVector batch(h->getCurve());
+        h->hashBatch(messages, batch, 3);
+        for (size_t i = 0; i < messages.size(); i += 37) {
+            correct = correct && batch[i] == h->hash(messages[i]);
+        }
+        correct = correct && batch.size() == messages.size() && onCurve(batch[299]);
+    }
+    std::vector<Ecc_Point> small = secpHash.hashBatch({ "a", "b" });
+    correct = correct && small.size() == 2 && small[1] == secpHash.hash("b");
+
+    bool rejected = false;
+    try {
+        HashToCurve(CurveParameters::p521(), "tag");
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    std::cout << "Hash To Curve Test " << (correct && rejected ? "PASSED" : "FAILED") << std::endl;
 }
 
 int main(){
     test_homomorphic_holding();
+    test_fast_reduction();
+    test_glv_multiplication();
+    test_signatures();
+    test_kzg_commitments();
+    test_witness_generation();
+    test_sparse_polynomials();
+    test_polynomial_evaluation();
+    test_powers_of_tau();
+    test_simd_field();
+    test_out_of_core_ntt();
+    test_sharded_msm();
+    test_bigint_inline_storage();
+    test_batch_scalar_multiplication();
+    test_evaluations();
+    test_kronecker_multiplication();
+    test_prover_service();
+    test_allocation_accounting();
+    test_binary_io();
+    test_polynomial_division();
+    test_random_sampling();
+    test_incremental_proving();
+    test_point_vector();
+    test_poseidon();
+    test_hash_to_curve();
     return 0;
 }
\ No newline at end of file